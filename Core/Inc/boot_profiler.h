@@ -0,0 +1,61 @@
+/*******************************************************************************
+ * Filename:			boot_profiler.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Boot phase profiler function
+*******************************************************************************/
+
+#ifndef _BOOT_PROFILER_H_
+#define _BOOT_PROFILER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Boot phase, stamped when the phase ends
+typedef enum
+{
+	mainBootPhase = 0,			// main() entered
+	halInitBootPhase,			// HAL_Init
+	pllStartBootPhase,			// PLL configured and started, not locked
+	gpioBootPhase,				// MX_GPIO_Init while PLL locks
+	clockSwitchBootPhase,		// Wait PLL lock, switch SYSCLK to 80 MHz
+	timerBootPhase,				// MX_TIM6_Init
+	applicationBootPhase,		// MainLoop initialization, ready for events
+	deferredBootPhase,			// Lazy peripherals in idle slots after ready
+	firstEventBootPhase,		// First event handled
+	maximumBootPhase,
+}
+eBOOT_PHASE;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define boot profiler function structure
+typedef struct _sBOOT_PROFILER
+{
+	void (*Start)(void);
+	void (*Stamp)(eBOOT_PHASE eBootPhase);
+	void (*Print)(void);
+}
+sBOOT_PROFILER;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sBOOT_PROFILER sBootProfiler;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BOOT_PROFILER_H_ */
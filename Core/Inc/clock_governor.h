@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * Filename:			clock_governor.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Dynamic core clock scaling function
+*******************************************************************************/
+
+#ifndef _CLOCK_GOVERNOR_H_
+#define _CLOCK_GOVERNOR_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Run at MSI 4 MHz range 2 while idle, 0 keeps PLL 80 MHz all the time
+#define CLOCK_GOVERNOR_ENABLE		1
+// Time without event before the clock is dropped in ms
+#define CLOCK_GOVERNOR_IDLE_PERIOD	500
+// TIM6 counter clock in Hz, TIMER_PRESCALER 7999 at 80 MHz
+#define CLOCK_GOVERNOR_TIMER_CLOCK	10000
+// MSI range 6 core clock of low level in Hz
+#define CLOCK_GOVERNOR_LOW_CLOCK	4000000
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Core clock level
+typedef enum
+{
+	lowClockLevel = 0,		// MSI 4 MHz, range 2, 0 wait state
+	highClockLevel,			// PLL 80 MHz, range 1, 4 wait states
+	maximumClockLevel,
+}
+eCLOCK_LEVEL;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Clock governor statistic
+typedef struct
+{
+	uint32_t residency[maximumClockLevel];			// Time spent at level in ms
+	uint32_t switchCount[maximumClockLevel];		// Switches into level
+	uint32_t lastSwitchCycle[maximumClockLevel];	// Core cycles of last switch into level
+	uint32_t maximumSwitchCycle[maximumClockLevel];
+}
+sCLOCK_GOVERNOR_STATISTIC;
+
+// Define clock governor function structure
+typedef struct _sCLOCK_GOVERNOR
+{
+	void (*Initialize)(void);
+	void (*Busy)(void);
+	void (*Idle)(void);
+	eCLOCK_LEVEL (*GetLevel)(void);
+	void (*GetStatistic)(sCLOCK_GOVERNOR_STATISTIC *psStatistic);
+	void (*Print)(void);
+}
+sCLOCK_GOVERNOR;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sCLOCK_GOVERNOR sClockGovernor;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOCK_GOVERNOR_H_ */
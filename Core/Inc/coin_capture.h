@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * Filename:			coin_capture.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Input capture pulse width coin denomination function
+*******************************************************************************/
+
+#ifndef _COIN_CAPTURE_H_
+#define _COIN_CAPTURE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// 1: Classify validator pulse width with TIM2 CH1 input capture
+#define COIN_CAPTURE_ENABLE			0
+
+// Validator pulse input, TIM2_CH1
+#define COIN_CAPTURE_Pin			GPIO_PIN_15
+#define COIN_CAPTURE_GPIO_Port		GPIOA
+
+// TIM2 counts 1 us at 80 MHz
+#define COIN_CAPTURE_PRESCALER		79
+// Edge timestamps kept by circular DMA, power of 2
+#define COIN_CAPTURE_BUFFER			64
+// Classifier batch period in ms
+#define COIN_CAPTURE_PERIOD			20
+// Low pulse longer than this in us is a lost edge, resynchronize
+#define COIN_CAPTURE_MAXIMUM_WIDTH	200000
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Denomination event
+typedef struct
+{
+	uint8_t value;			// Coin units
+	uint32_t width;			// Pulse width in us
+}
+sCOIN_CAPTURE_EVENT;
+
+// Classifier statistic
+typedef struct
+{
+	uint32_t edgeCount;
+	uint32_t coinCount;
+	uint32_t rejectCount;	// Width outside every denomination
+	uint32_t resyncCount;	// Edge pairing lost
+	uint32_t cycleCount;	// Cycles spent in classifier
+}
+sCOIN_CAPTURE_STATISTIC;
+
+// Define coin capture function structure
+typedef struct _sCOIN_CAPTURE
+{
+	void (*Initialize)(void);
+	uint8_t (*Classify)(sCOIN_CAPTURE_EVENT *psEvent, uint8_t maximum);
+	void (*GetStatistic)(sCOIN_CAPTURE_STATISTIC *psStatistic);
+}
+sCOIN_CAPTURE;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sCOIN_CAPTURE sCoinCapture;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COIN_CAPTURE_H_ */
@@ -19,6 +19,7 @@ extern "C"
 // Standard C Lbrary Header
 #include "stdarg.h"
 #include "stdbool.h"
+#include "stddef.h"
 #include "stdint.h"
 #include "stdio.h"
 #include "stdlib.h"
@@ -31,6 +32,8 @@ extern "C"
 /*******************************************************************************
  * CONSTANTS
  ******************************************************************************/
+// Variable kept over reset, content must be validated before use
+#define NOINIT		__attribute__((section(".noinit")))
 
 /*******************************************************************************
  * ENUMERATED
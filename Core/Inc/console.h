@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * Filename:			console.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    USART2 DMA console function
+*******************************************************************************/
+
+#ifndef _CONSOLE_H_
+#define _CONSOLE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// USART2 on ST-Link virtual COM port, PA2 TX and PA3 RX
+#define CONSOLE_ENABLE			1
+#define CONSOLE_BAUDRATE		115200
+// Kernel clock HSI16 keeps baud rate across core clock changes
+#define CONSOLE_CLOCK			16000000
+// Ring sizes, power of 2. A command line must be shorter than half RX ring
+#define CONSOLE_RX_SIZE			128
+#define CONSOLE_TX_SIZE			1024
+
+#define CONSOLE_GPIO_Port		GPIOA
+#define CONSOLE_TX_Pin			GPIO_PIN_2
+#define CONSOLE_RX_Pin			GPIO_PIN_3
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Console statistic
+typedef struct
+{
+	uint32_t command;			// Commands executed
+	uint32_t unknownCommand;	// Lines not matching a command
+	uint32_t lineOverflow;		// Lines dropped, longer than RX ring
+	uint32_t txDrop;			// Bytes dropped, TX ring full
+}
+sCONSOLE_STATISTIC;
+
+// Define console function structure
+typedef struct _sCONSOLE
+{
+	void (*Initialize)(void);
+	void (*Write)(const char *data, uint32_t length);
+	void (*Process)(void);
+	void (*GetStatistic)(sCONSOLE_STATISTIC *psStatistic);
+}
+sCONSOLE;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sCONSOLE sConsole;
+
+/*******************************************************************************
+ * INTERRUPT CALLBACK
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      ConsoleInterruptCallback
+ * @brief   USART2 interrupt, RX line idle
+ * @param	None
+ * @return	None
+ ******************************************************************************/
+void ConsoleInterruptCallback(void);
+
+/*******************************************************************************
+ * @fn      ConsoleDmaInterruptCallback
+ * @brief   DMA1 channel 7 interrupt, TX block sent
+ * @param	None
+ * @return	None
+ ******************************************************************************/
+void ConsoleDmaInterruptCallback(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CONSOLE_H_ */
@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * Filename:			coroutine.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Stackless coroutine with static frame arena
+*******************************************************************************/
+
+#ifndef _COROUTINE_H_
+#define _COROUTINE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define NUM_OF_COROUTINE			2
+// Frames and their locals, never freed
+#define COROUTINE_ARENA_SIZE		128
+// Signal raised by the delay timer of a coroutine, other bits are free
+#define COROUTINE_TIMEOUT_SIGNAL	0x80000000
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+typedef struct _sCOROUTINE sCOROUTINE;
+
+// Coroutine body, called from the top on every resume
+typedef void (*COROUTINE_BODY)(sCOROUTINE *psCoroutine);
+
+// Coroutine frame. Locals of the body do not survive a suspension, keep them
+// in local which is allocated behind the frame
+struct _sCOROUTINE
+{
+	COROUTINE_BODY Body;
+	void *local;
+	uint32_t waitMask;				// Signals that end current wait
+	volatile uint32_t signal;		// Pending signals
+	uint32_t received;				// Signals that ended last wait
+	uint16_t resume;				// Line to resume at, 0 at start
+	uint8_t timerId;
+	bool finished;
+};
+
+// Define coroutine function structure
+typedef struct _sCOROUTINE_RUNTIME
+{
+	sCOROUTINE *(*Create)(COROUTINE_BODY Body, uint16_t localSize);
+	void (*Signal)(sCOROUTINE *psCoroutine, uint32_t signal);
+	void (*Run)(void);
+	void (*Delay)(sCOROUTINE *psCoroutine, uint32_t period);
+	bool (*Take)(sCOROUTINE *psCoroutine);
+	void (*Print)(void);
+}
+sCOROUTINE_RUNTIME;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+// Body must start with COROUTINE_BEGIN and end with COROUTINE_END, switch
+// statements can not enclose a wait
+#define COROUTINE_BEGIN(psCoroutine)		switch((psCoroutine)->resume) { case 0:
+
+// Suspend until one of the signals in mask, received holds them afterwards
+#define COROUTINE_WAIT(psCoroutine, mask)									\
+	do																		\
+	{																		\
+		(psCoroutine)->waitMask = (mask);									\
+		(psCoroutine)->resume = __LINE__;									\
+		case __LINE__:														\
+		if(!sCoroutine.Take(psCoroutine))									\
+		{																	\
+			return;															\
+		}																	\
+	}																		\
+	while(0)
+
+// Suspend for period ms, a signal in mask ends the delay early
+#define COROUTINE_DELAY(psCoroutine, period, mask)							\
+	do																		\
+	{																		\
+		sCoroutine.Delay(psCoroutine, period);								\
+		COROUTINE_WAIT(psCoroutine, COROUTINE_TIMEOUT_SIGNAL | (mask));		\
+	}																		\
+	while(0)
+
+#define COROUTINE_END(psCoroutine)											\
+	}																		\
+	(psCoroutine)->finished = true;											\
+	(psCoroutine)->resume = 0
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sCOROUTINE_RUNTIME sCoroutine;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COROUTINE_H_ */
@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * Filename:			crc.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Hardware CRC-32 function
+*******************************************************************************/
+
+#ifndef _CRC_H_
+#define _CRC_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define CRC function structure
+typedef struct _sCRC
+{
+	uint32_t (*Calculate)(const void *data, uint32_t numOfWord);
+}
+sCRC;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sCRC sCrc;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CRC_H_ */
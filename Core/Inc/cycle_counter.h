@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * Filename:			cycle_counter.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    DWT cycle counter function
+*******************************************************************************/
+
+#ifndef _CYCLE_COUNTER_H_
+#define _CYCLE_COUNTER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Read free running core cycle counter, wrap around every 2^32 cycles.
+// Host build defines its own
+#ifndef CYCLE_COUNTER_READ
+#define CYCLE_COUNTER_READ()	(DWT->CYCCNT)
+#endif
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define cycle counter function structure
+typedef struct _sCYCLE_COUNTER
+{
+	void (*Enable)(void);
+}
+sCYCLE_COUNTER;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sCYCLE_COUNTER sCycleCounter;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CYCLE_COUNTER_H_ */
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * Filename:			event_flag.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Lock free event flags shared by interrupts and main loop
+*******************************************************************************/
+
+#ifndef _EVENT_FLAG_H_
+#define _EVENT_FLAG_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// 1: LDREX/STREX, exception entry and return clear the exclusive monitor so an
+// interrupted update retries. 0: compiler atomics, e.g. host build
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define EVENT_FLAG_EXCLUSIVE	1
+#else
+#define EVENT_FLAG_EXCLUSIVE	0
+#endif
+// Flag group of two words, flag is bit position 0 to 63
+#define EVENT_FLAG_NUM_OF_WORD	2
+#define EVENT_FLAG_MAXIMUM		(EVENT_FLAG_NUM_OF_WORD * 32)
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define event flag function structure, flag is bit position
+typedef struct _sEVENT_FLAG
+{
+	void (*Set)(uint8_t flag);
+	void (*Clear)(uint8_t flag);
+	uint64_t (*FetchAndClearAll)(void);
+	uint64_t (*WaitAny)(uint64_t mask);
+}
+sEVENT_FLAG;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+// Read only outside this module
+extern volatile uint32_t eventFlags[EVENT_FLAG_NUM_OF_WORD];
+extern const sEVENT_FLAG sEventFlag;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EVENT_FLAG_H_ */
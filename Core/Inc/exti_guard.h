@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * Filename:			exti_guard.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    EXTI interrupt storm protection function
+*******************************************************************************/
+
+#ifndef _EXTI_GUARD_H_
+#define _EXTI_GUARD_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+#include "main_loop.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Guard tick, edge rate window and polling sample period in ms
+#define EXTI_GUARD_PERIOD			5
+// Edges per tick that mask the line, 40 edges per 5 ms = 8 kHz
+#define EXTI_GUARD_THRESHOLD		40
+// Samples of stable low level that make a polled event (50 ms)
+#define EXTI_GUARD_DEBOUNCE_TICK	10
+// Samples of stable high level before interrupt is enabled again (200 ms)
+#define EXTI_GUARD_QUIET_TICK		40
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Storm counters of one line
+typedef struct
+{
+	uint32_t stormCount;		// Times the line was masked
+	uint32_t recoverCount;		// Times interrupt was enabled again
+	uint32_t polledEventCount;	// Events detected while masked
+	uint32_t maximumEdgeRate;	// Highest edges per tick seen
+	bool polling;
+}
+sEXTI_GUARD_COUNTER;
+
+// Define EXTI guard function structure
+typedef struct _sEXTI_GUARD
+{
+	void (*Initialize)(void);
+	bool (*Edge)(eDEBOUNCE_INPUT eInput);
+	void (*GetCounter)(eDEBOUNCE_INPUT eInput, sEXTI_GUARD_COUNTER *psCounter);
+	void (*Print)(void);
+}
+sEXTI_GUARD;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sEXTI_GUARD sExtiGuard;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EXTI_GUARD_H_ */
@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * Filename:			fast_interrupt.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Direct register interrupt dispatch for TIM6 and EXTI
+*******************************************************************************/
+
+#ifndef _FAST_INTERRUPT_H_
+#define _FAST_INTERRUPT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+#include "cycle_counter.h"
+#include "software_timer.h"
+#include "main_loop.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// 1: TIM6 and EXTI interrupts clear their flags and call the handler directly
+// 0: Interrupts go through HAL_TIM_IRQHandler and HAL_GPIO_EXTI_IRQHandler
+#define FAST_INTERRUPT_ENABLE		1
+// 1: Record entry-to-callback latency in cycles for the selected path
+#define FAST_INTERRUPT_LATENCY		1
+
+// Handlers bound at compile time to the fast path
+#define FAST_INTERRUPT_TIMER_HANDLER	SoftwareTimerInterruptCallback
+#define FAST_INTERRUPT_EXTI_HANDLER		HAL_GPIO_EXTI_Callback
+
+// EXTI lines served by EXTI15_10_IRQHandler
+#define FAST_INTERRUPT_EXTI_15_10_MASK	(EXTI_PR1_PIF10 | EXTI_PR1_PIF11 | EXTI_PR1_PIF12 | \
+										 EXTI_PR1_PIF13 | EXTI_PR1_PIF14 | EXTI_PR1_PIF15)
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Interrupt source
+typedef enum
+{
+	timerFastInterrupt = 0,
+	extiFastInterrupt,
+	maximumFastInterrupt,
+}
+eFAST_INTERRUPT;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Entry-to-callback latency in cycles
+typedef struct
+{
+	uint32_t count;
+	uint32_t last;
+	uint32_t minimum;
+	uint32_t maximum;
+}
+sFAST_INTERRUPT_LATENCY;
+
+// Define fast interrupt function structure
+typedef struct _sFAST_INTERRUPT
+{
+	void (*ResetLatency)(void);
+	void (*PrintLatency)(void);
+}
+sFAST_INTERRUPT;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sFAST_INTERRUPT sFastInterrupt;
+extern volatile uint32_t fastInterruptEntryCycle;
+extern sFAST_INTERRUPT_LATENCY sFastInterruptLatency[maximumFastInterrupt];
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      FastInterruptMark
+ * @brief   Record cycles elapsed since interrupt entry
+ * @param   eFastInterrupt
+ * @return  None
+ ******************************************************************************/
+static inline void FastInterruptMark(eFAST_INTERRUPT eFastInterrupt)
+{
+#if FAST_INTERRUPT_LATENCY
+	uint32_t latency = CYCLE_COUNTER_READ() - fastInterruptEntryCycle;
+	sFAST_INTERRUPT_LATENCY *psLatency = &sFastInterruptLatency[eFastInterrupt];
+
+	psLatency->last = latency;
+	if(psLatency->count == 0 || latency < psLatency->minimum)
+	{
+		psLatency->minimum = latency;
+	}
+	if(latency > psLatency->maximum)
+	{
+		psLatency->maximum = latency;
+	}
+	psLatency->count++;
+#else
+	(void)eFastInterrupt;
+#endif
+}
+
+/*******************************************************************************
+ * INTERRUPT CALLBACK
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      FastInterruptEntry
+ * @brief   Stamp interrupt entry, first statement of the IRQ handler
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static inline void FastInterruptEntry(void)
+{
+#if FAST_INTERRUPT_LATENCY
+	fastInterruptEntryCycle = CYCLE_COUNTER_READ();
+#endif
+}
+
+/*******************************************************************************
+ * @fn      FastInterruptTimer
+ * @brief   TIM6 update interrupt without HAL_TIM_IRQHandler
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static inline void FastInterruptTimer(void)
+{
+	if((TIM6->SR & TIM_SR_UIF) != 0)
+	{
+		// rc_w0 register, writing 1 to other flags leaves them untouched
+		TIM6->SR = ~TIM_SR_UIF;
+		FastInterruptMark(timerFastInterrupt);
+		FAST_INTERRUPT_TIMER_HANDLER();
+	}
+}
+
+/*******************************************************************************
+ * @fn      FastInterruptExti
+ * @brief   EXTI interrupt without HAL_GPIO_EXTI_IRQHandler
+ * @param   lineMask	EXTI lines served by the calling IRQ handler
+ * @return  None
+ ******************************************************************************/
+static inline void FastInterruptExti(uint32_t lineMask)
+{
+	uint32_t pending = EXTI->PR1 & lineMask;
+	uint32_t line = 0;
+
+	// rc_w1 register, clear all served lines with one write
+	EXTI->PR1 = pending;
+	while(pending != 0)
+	{
+		line = 31 - __CLZ(pending);
+		pending &= ~(0x01UL << line);
+		FastInterruptMark(extiFastInterrupt);
+		FAST_INTERRUPT_EXTI_HANDLER((uint16_t)(0x01UL << line));
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FAST_INTERRUPT_H_ */
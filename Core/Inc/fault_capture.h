@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * Filename:			fault_capture.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Fault record kept in RAM over reset
+*******************************************************************************/
+
+#ifndef _FAULT_CAPTURE_H_
+#define _FAULT_CAPTURE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+#include "log.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Log output copied into record
+#define FAULT_LOG_SIZE			LOG_TAIL_SIZE
+// Words above pre-fault stack pointer copied into record, return addresses
+// for host symbolizer
+#define FAULT_STACK_WORD		32
+// Fault resets in a row after which the device halts instead of resetting
+#define FAULT_RESET_LIMIT		3
+// Run time in ms that ends a series of fault resets
+#define FAULT_STABLE_PERIOD		60000
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// What reset the device
+typedef enum
+{
+	exceptionFaultSource = 0,		// HardFault, MemManage, BusFault, UsageFault
+	errorHandlerFaultSource,		// Error_Handler
+}
+eFAULT_SOURCE;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Fault record, exception frame order r0 r1 r2 r3 r12 lr pc xpsr
+typedef struct
+{
+	uint32_t magic;
+	uint32_t eFaultSource;
+	uint32_t ipsr;					// Exception number, 0 thread mode
+	uint32_t excReturn;
+	uint32_t frame[8];
+	uint32_t stackPointer;			// Before exception entry
+	uint32_t cfsr;
+	uint32_t hfsr;
+	uint32_t mmfar;
+	uint32_t bfar;
+	uint32_t stackLength;			// Words in stack
+	uint32_t stack[FAULT_STACK_WORD];
+	uint32_t logLength;
+	char log[FAULT_LOG_SIZE];
+	uint32_t crc;
+	uint32_t reported;				// Not in CRC, set after boot dump
+	uint32_t resetCount;			// Not in CRC, fault resets in a row
+}
+sFAULT_RECORD;
+
+// Define fault capture function structure
+typedef struct _sFAULT_CAPTURE
+{
+	void (*Initialize)(void);
+	void (*Error)(uint32_t caller) __attribute__((noreturn));
+	void (*Print)(void);
+	void (*Clear)(void);
+	void (*Test)(void);
+	bool (*ResetByException)(void);
+}
+sFAULT_CAPTURE;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sFAULT_CAPTURE sFaultCapture;
+
+/*******************************************************************************
+ * INTERRUPT CALLBACK
+ ******************************************************************************/
+// Fault exception handlers, generation is off in CubeMX NVIC settings
+void HardFault_Handler(void);
+void MemManage_Handler(void);
+void BusFault_Handler(void);
+void UsageFault_Handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FAULT_CAPTURE_H_ */
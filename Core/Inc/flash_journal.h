@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Filename:			flash_journal.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Wear leveled flash journal for credit and audit counters
+*******************************************************************************/
+
+#ifndef _FLASH_JOURNAL_H_
+#define _FLASH_JOURNAL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Page header magic "JRNL", followed by 32 bit page sequence
+#define FLASH_JOURNAL_MAGIC		0x4C4E524A
+// Record is programmed as one double word
+#define FLASH_JOURNAL_RECORD_SIZE	sizeof(uint64_t)
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Journal record, latest record is current value. lifetimeVend above 16 bits
+// is kept once per page as its epoch, so a record stays one double word
+typedef struct
+{
+	uint32_t lifetimeCoin;		// Coins inserted since first boot
+	uint32_t lifetimeVend;		// Completed dispenses since first boot
+	uint8_t totalCoin;			// Customer credit
+}
+sFLASH_JOURNAL_RECORD;
+
+// Journal statistic
+typedef struct
+{
+	uint32_t recordWrite;		// Records programmed
+	uint32_t headerWrite;		// Page header and epoch double words programmed
+	uint32_t pageErase;			// Pages erased
+	uint32_t errorCount;		// Failed flash operations
+	uint32_t mountCycle;		// Cycles spent in Mount
+}
+sFLASH_JOURNAL_STATISTIC;
+
+// Define flash journal function structure
+typedef struct _sFLASH_JOURNAL
+{
+	bool (*Mount)(sFLASH_JOURNAL_RECORD *psRecord);
+	void (*Write)(const sFLASH_JOURNAL_RECORD *psRecord);
+	void (*Process)(void);
+	void (*GetStatistic)(sFLASH_JOURNAL_STATISTIC *psStatistic);
+}
+sFLASH_JOURNAL;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sFLASH_JOURNAL sFlashJournal;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FLASH_JOURNAL_H_ */
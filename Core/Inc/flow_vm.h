@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Filename:			flow_vm.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Vending flow bytecode interpreter
+*******************************************************************************/
+
+#ifndef _FLOW_VM_H_
+#define _FLOW_VM_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+#include "state_machine.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// 1: Flow program runs the machine instead of the native regions
+#define FLOW_VM_ENABLE			0
+// Program magic "FLOW"
+#define FLOW_VM_MAGIC			0x574F4C46
+#define FLOW_VM_VERSION			1
+// Handler table entry of an ignored event
+#define FLOW_VM_NO_HANDLER		0xFFFF
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Instruction set, operands follow the opcode, 16-bit operands little endian.
+// Jump offsets are forward only and relative to the next instruction, so
+// every handler ends after at most codeLength instructions
+typedef enum
+{
+	endFlowOp = 0,				// End of handler
+	loadCreditFlowOp,			// acc = credit
+	loadParameterFlowOp,		// acc = event parameter, e.g. number of coins
+	loadImmediateFlowOp,		// imm16		acc = imm16
+	addCreditFlowOp,			// credit += acc, saturated at 255
+	useCreditFlowOp,			// credit -= 1 if not 0, count vend at 0
+	saveFlowOp,					// Journal credit and counters
+	jumpFlowOp,					// off8
+	jumpLessFlowOp,				// imm16 off8	jump if acc < imm16
+	jumpEqualFlowOp,			// imm16 off8	jump if acc == imm16
+	timerStartFlowOp,			// imm16		start dispensing timer in ms
+	timerStopFlowOp,			// Stop dispensing timer
+	gotoFlowOp,					// status8		next machine status
+	printFlowOp,				// message8		print built-in message
+	printCreditFlowOp,			// Print "Total coin = "
+	printRemainFlowOp,			// Print "Still remain ... second"
+	maximumFlowOp,
+}
+eFLOW_OP;
+
+// Built-in messages of printFlowOp
+typedef enum
+{
+	buttonRefusedFlowMessage = 0,	// Cannot press button at this status
+	buttonEnoughFlowMessage,		// Press button at enough coin machine status
+	buttonDispensingFlowMessage,	// Press button at dispensing machine status
+	buttonPauseFlowMessage,			// Press button at pause dispense machine status
+	coinRefusedFlowMessage,			// Cannot insert coin at this status
+	maximumFlowMessage,
+}
+eFLOW_MESSAGE;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Program header, code follows. host/tool/flow_compile builds it from flow
+// source as binary or Intel HEX at _sflow. crc is CRC-32 (0x04C11DB7, initial
+// 0xFFFFFFFF, no reflection) of the words from version to the end of code
+// padded to a word
+typedef struct
+{
+	uint32_t magic;
+	uint32_t crc;
+	uint16_t version;
+	uint16_t codeLength;
+	uint16_t handler[totalMachineStatus][totalMachineEvent];	// Code offset
+}
+sFLOW_VM_HEADER;
+
+// Machine data the program works on
+typedef struct
+{
+	uint8_t *status;			// eMACHINE_STATUS
+	uint8_t *totalCoin;
+	uint32_t *lifetimeCoin;
+	uint32_t *lifetimeVend;
+	uint32_t *heldCoin;			// Taken beyond uint8_t credit
+	uint8_t timerId;
+	void (*Save)(void);
+}
+sFLOW_VM_CONTEXT;
+
+// Define flow VM function structure
+typedef struct _sFLOW_VM
+{
+	void (*Initialize)(const sFLOW_VM_CONTEXT *psContext);
+	void (*Run)(eMACHINE_EVENT eMachineEvent, uint32_t parameter);
+	void (*Benchmark)(void);
+	void (*Print)(void);
+}
+sFLOW_VM;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sFLOW_VM sFlowVm;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FLOW_VM_H_ */
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * Filename:			itm_trace.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    ITM trace channels, one stimulus port per subsystem
+*******************************************************************************/
+
+#ifndef _ITM_TRACE_H_
+#define _ITM_TRACE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// 0: no trace writes, text log still goes to console
+#define ITM_TRACE_ENABLE		1
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Channel is stimulus port number, enable ports 0-3 in SWV settings.
+// host/tool/itm_demux splits and decodes a raw SWO capture
+typedef enum
+{
+	logItmChannel = 0,				// Text
+	transitionItmChannel,			// ITM_TRACE_TRANSITION words
+	timerItmChannel,				// ITM_TRACE_TIMER words
+	profileItmChannel,				// ITM_TRACE_PROFILE words
+	maximumItmChannel,
+}
+eITM_CHANNEL;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define ITM trace function structure
+typedef struct _sITM_TRACE
+{
+	void (*Initialize)(void);
+	void (*Word)(eITM_CHANNEL eItmChannel, uint32_t value);
+	void (*Text)(eITM_CHANNEL eItmChannel, const char *data, uint32_t length);
+	void (*Benchmark)(void);
+	void (*Print)(void);
+}
+sITM_TRACE;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sITM_TRACE sItmTrace;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+// Machine status change: event 31-16, from 15-8, to 7-0
+#define ITM_TRACE_TRANSITION(from, to, event)								\
+	(((uint32_t)(event) << 16) | ((uint32_t)(from) << 8) | (uint32_t)(to))
+// Software timer timeout: timer ID 31-24, HAL tick 23-0
+#define ITM_TRACE_TIMER(id, tick)											\
+	(((uint32_t)(id) << 24) | ((uint32_t)(tick) & 0x00FFFFFF))
+// Scheduler task: 1 at end 31, task ID 30-24, cycle counter 23-0
+#define ITM_TRACE_PROFILE(id, end, cycle)									\
+	(((uint32_t)(end) << 31) | (((uint32_t)(id) & 0x7F) << 24) | ((uint32_t)(cycle) & 0x00FFFFFF))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ITM_TRACE_H_ */
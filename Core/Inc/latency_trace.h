@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Filename:			latency_trace.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Edge-to-state-change latency trace function
+*******************************************************************************/
+
+#ifndef _LATENCY_TRACE_H_
+#define _LATENCY_TRACE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+#include "main_loop.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// 1: Stamp every stage of the input event path
+#define LATENCY_TRACE_ENABLE		1
+// Latest samples kept per stage for percentile calculation
+#define LATENCY_TRACE_SAMPLES		32
+// Stamps in us from a free running 32-bit timer. It keeps counting in sleep
+// and at every core clock, Retune keeps its rate after a clock switch
+#define LATENCY_TRACE_TIMER			TIM5
+#define LATENCY_TRACE_CLOCK			1000000
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Stages of an input event, in path order
+typedef enum
+{
+	edgeLatencyStage = 0,		// First EXTI edge of the input
+	debounceLatencyStage,		// Debounce timer expired, event flag set
+	dispatchLatencyStage,		// MainLoop picked up event flag
+	stateLatencyStage,			// State machine handler returned
+	maximumLatencyStage,
+}
+eLATENCY_STAGE;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define latency trace function structure
+typedef struct _sLATENCY_TRACE
+{
+	void (*Initialize)(void);
+	void (*Retune)(void);
+	void (*Stamp)(eDEBOUNCE_INPUT eInput, eLATENCY_STAGE eStage);
+	void (*Abort)(eDEBOUNCE_INPUT eInput);
+	void (*Reset)(void);
+	void (*Print)(void);
+}
+sLATENCY_TRACE;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sLATENCY_TRACE sLatencyTrace;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LATENCY_TRACE_H_ */
@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * Filename:			lazy_init.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Peripheral initialization on first use or in the
+ *						first idle slots after boot, whichever comes first
+*******************************************************************************/
+
+#ifndef _LAZY_INIT_H_
+#define _LAZY_INIT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Peripherals not needed before the first event, idle slots initialize them
+// in this order
+typedef enum
+{
+	crcLazyPeripheral = 0,
+	flashLazyPeripheral,
+	consoleLazyPeripheral,		// HSI start, USART2 and its DMA
+	itmLazyPeripheral,			// ITM stimulus ports
+	pulseCounterLazyPeripheral,	// LPTIM1/LPTIM2
+	coinCaptureLazyPeripheral,	// TIM2 input capture and its DMA
+	telemetryLazyPeripheral,	// Snapshot timer
+	maximumLazyPeripheral,
+}
+eLAZY_PERIPHERAL;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define lazy initialization function structure
+typedef struct _sLAZY_INIT
+{
+	void (*Use)(eLAZY_PERIPHERAL eLazyPeripheral);
+	bool (*Idle)(void);
+}
+sLAZY_INIT;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sLAZY_INIT sLazyInit;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LAZY_INIT_H_ */
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * Filename:			log.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Integer only formatter writing to log sink
+*******************************************************************************/
+
+#ifndef _LOG_H_
+#define _LOG_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Longest message on stack, longer messages are cut
+#define LOG_LINE_SIZE			128
+// Last output kept in RAM for fault record, power of two
+#define LOG_TAIL_SIZE			256
+
+// Severity, a message is kept when its level is at or below threshold
+#define LOG_LEVEL_NONE			0
+#define LOG_LEVEL_ERROR			1
+#define LOG_LEVEL_WARNING		2
+#define LOG_LEVEL_INFO			3
+#define LOG_LEVEL_DEBUG			4
+
+// Module of a log site, each source defines LOG_MODULE before log macros
+#define LOG_MODULE_STATE_MACHINE	0x01
+#define LOG_MODULE_FLOW_VM		0x02
+#define LOG_MODULE_MAIN_LOOP	0x04
+
+// Compile time filter, calls filtered here are removed with their arguments
+// and strings. Production images e.g. LOG_LEVEL_WARNING, host/test/
+// log_level_size.sh reports .text per level
+#ifndef LOG_LEVEL
+#define LOG_LEVEL				LOG_LEVEL_DEBUG
+#endif
+#ifndef LOG_MODULE_MASK
+#define LOG_MODULE_MASK			(LOG_MODULE_STATE_MACHINE | LOG_MODULE_FLOW_VM | LOG_MODULE_MAIN_LOOP)
+#endif
+
+// 1: log bench also times newlib snprintf, which links newlib vfprintf back
+// in. Keep 0 in images whose .text is measured. On the host, test_log_format
+// and test/log_format_size.sh compare time and .text with snprintf
+#ifndef LOG_BENCHMARK_NEWLIB
+#define LOG_BENCHMARK_NEWLIB	0
+#endif
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define log function structure. Printf takes flags '-' '0', width, length
+// 'l' 'h' and conversions d i u x X c s p %, no float
+typedef struct _sLOG
+{
+	void (*Printf)(const char *format, ...) __attribute__((format(printf, 1, 2)));
+	uint32_t (*Format)(char *buffer, uint32_t size, const char *format, va_list args);
+	void (*Write)(const char *data, uint32_t length);
+	void (*SetLevel)(uint8_t level);
+	uint32_t (*Tail)(char *buffer, uint32_t size);
+	void (*Benchmark)(void);
+}
+sLOG;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+// Run time threshold for levels compiled in, set by console
+extern uint8_t logLevel;
+extern const sLOG sLog;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+// Constant false for filtered level or module, compiler drops the call
+#define LOG_COMPILED(level, module)	((level) <= LOG_LEVEL && ((module) & LOG_MODULE_MASK) != 0)
+
+#define LOG(level, module, ...)												\
+	do																		\
+	{																		\
+		if(LOG_COMPILED(level, module) && (level) <= logLevel)				\
+		{																	\
+			sLog.Printf(__VA_ARGS__);										\
+		}																	\
+	}																		\
+	while(0)
+
+#define LOG_ERROR(...)			LOG(LOG_LEVEL_ERROR, LOG_MODULE, __VA_ARGS__)
+#define LOG_WARNING(...)		LOG(LOG_LEVEL_WARNING, LOG_MODULE, __VA_ARGS__)
+#define LOG_INFO(...)			LOG(LOG_LEVEL_INFO, LOG_MODULE, __VA_ARGS__)
+#define LOG_DEBUG(...)			LOG(LOG_LEVEL_DEBUG, LOG_MODULE, __VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LOG_H_ */
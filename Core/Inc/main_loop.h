@@ -17,6 +17,7 @@ extern "C"
  * INCLUDES
  ******************************************************************************/
 #include "common.h"
+#include "event_flag.h"
 
 /*******************************************************************************
  * ENUMERATED
@@ -26,14 +27,44 @@ typedef enum
 {
 	coinInsertEventFlag	= 0,
 	buttonPressedEventFlag,
+	coinPulseEventFlag,
+	coinCaptureEventFlag,
+	flashJournalEventFlag,
+	clockGovernorEventFlag,
+	consoleEventFlag,
+	telemetryEventFlag,
+	dispensingTimerEventFlag,
+	coroutineEventFlag,
 	maximumEventFlag,
 }
 eEVENT_FLAGS;
 
+// Inputs served by EXTI and debounce timer, index of sDebounceInput
+typedef enum
+{
+	coinDebounceInput = 0,
+	buttonDebounceInput,
+	maximumDebounceInput,
+}
+eDEBOUNCE_INPUT;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Debounced input, latency trace and EXTI guard take pin and name from here
+typedef struct
+{
+	const char *name;
+	GPIO_TypeDef *port;
+	uint16_t gpioPin;
+	eEVENT_FLAGS eEventFlag;
+}
+sDEBOUNCE_INPUT;
+
 /*******************************************************************************
  * PUBLIC VARIABLES
  ******************************************************************************/
-extern volatile uint32_t eventFlags;
+extern const sDEBOUNCE_INPUT sDebounceInput[maximumDebounceInput];
 
 /*******************************************************************************
  * PUBLIC FUNCTIONS
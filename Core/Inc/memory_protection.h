@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * Filename:			memory_protection.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    MPU stack guard, read only flash and execute never RAM
+*******************************************************************************/
+
+#ifndef _MEMORY_PROTECTION_H_
+#define _MEMORY_PROTECTION_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// 0: MPU off, default memory map
+#define MEMORY_PROTECTION_ENABLE	1
+
+// No access region just above heap end, MPU minimum size. Stack owns all
+// RAM above it
+#define STACK_GUARD_SIZE			32
+// Fills free stack at start, high water is the lowest word overwritten
+#define STACK_PAINT_PATTERN			0xA5A5A5A5
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// MPU region number, higher number wins where regions overlap
+typedef enum
+{
+	flashMpuRegion = 0,
+	journalMpuRegion,
+	sram1MpuRegion,
+	sram2MpuRegion,
+	stackGuardMpuRegion,
+	maximumMpuRegion,
+}
+eMPU_REGION;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define memory protection function structure
+typedef struct _sMEMORY_PROTECTION
+{
+	void (*Initialize)(void);
+	bool (*HeapGrow)(uint32_t heapEnd);
+	void (*Benchmark)(void);
+	void (*Print)(void);
+}
+sMEMORY_PROTECTION;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sMEMORY_PROTECTION sMemoryProtection;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MEMORY_PROTECTION_H_ */
@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * Filename:			pulse_counter.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    LPTIM hardware coin pulse counter function
+*******************************************************************************/
+
+#ifndef _PULSE_COUNTER_H_
+#define _PULSE_COUNTER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// 1: Count multi-pulse coin validators with LPTIM1/LPTIM2 Input1
+#define PULSE_COUNTER_ENABLE		0
+
+// Validator pulse inputs, LPTIM Input1 cannot be routed from PC13
+#define COIN_PULSE1_Pin				GPIO_PIN_5
+#define COIN_PULSE1_GPIO_Port		GPIOB
+#define COIN_PULSE1_AF				GPIO_AF1_LPTIM1
+#define COIN_PULSE2_Pin				GPIO_PIN_1
+#define COIN_PULSE2_GPIO_Port		GPIOB
+#define COIN_PULSE2_AF				GPIO_AF14_LPTIM2
+
+// Counter read period in ms
+#define PULSE_COUNTER_PERIOD		50
+// Periods without new pulse that end a pulse train (100 ms)
+#define PULSE_COUNTER_TIMEOUT		2
+// Pulses that end a train at once through compare match interrupt
+#define PULSE_COUNTER_COMPARE		10
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define pulse counter function structure
+typedef struct _sPULSE_COUNTER
+{
+	void (*Initialize)(void);
+	uint32_t (*Take)(void);
+}
+sPULSE_COUNTER;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sPULSE_COUNTER sPulseCounter;
+
+/*******************************************************************************
+ * INTERRUPT CALLBACK
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      PulseCounterInterruptCallback
+ * @brief   LPTIM compare match interrupt callback
+ * @param   lptim
+ * @return  None
+ ******************************************************************************/
+void PulseCounterInterruptCallback(LPTIM_TypeDef *lptim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PULSE_COUNTER_H_ */
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * Filename:			region.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Orthogonal region state machine engine
+*******************************************************************************/
+
+#ifndef _REGION_H_
+#define _REGION_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Benchmark dispatches through 1..n dummy regions, events per region count
+#define REGION_BENCHMARK_REGION		8
+#define REGION_BENCHMARK_EVENT		1000
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Region event handler, returns next state of the region
+typedef uint8_t (*REGION_HANDLER)(uint8_t state, uint32_t parameter);
+
+// Region description, handler table is [numOfState][numOfEvent], NULL
+// entries ignore the event
+typedef struct
+{
+	const char *name;
+	uint8_t numOfState;
+	const REGION_HANDLER *handler;
+}
+sREGION;
+
+// Dispatch cost in cycles, engine cost excludes cycles spent in handlers
+typedef struct
+{
+	uint32_t dispatchCount;
+	uint32_t handlerCount;		// Handlers run, regions that took the event
+	uint64_t totalCycle;
+	uint64_t engineCycle;
+	uint32_t maximumEngineCycle;
+}
+sREGION_STATISTIC;
+
+// Regions sharing one event stream, dispatched in table order
+typedef struct
+{
+	const sREGION *psRegion;
+	uint8_t *state;				// Current state of every region
+	uint8_t numOfRegion;
+	uint8_t numOfEvent;
+	sREGION_STATISTIC sStatistic;
+}
+sREGION_SET;
+
+// Define region engine function structure
+typedef struct _sREGION_ENGINE
+{
+	void (*Dispatch)(sREGION_SET *psRegionSet, uint8_t event, uint32_t parameter);
+	bool (*Valid)(const sREGION_SET *psRegionSet);
+	void (*Print)(const sREGION_SET *psRegionSet);
+	void (*Benchmark)(void);
+}
+sREGION_ENGINE;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sREGION_ENGINE sRegionEngine;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _REGION_H_ */
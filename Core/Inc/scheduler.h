@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * Filename:			scheduler.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Cooperative earliest deadline first scheduler
+*******************************************************************************/
+
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Two words of ready bits, task ID is bit position
+#define SCHEDULER_MAXIMUM_TASK	64
+#define SCHEDULER_NUM_OF_WORD	(SCHEDULER_MAXIMUM_TASK / 32)
+#define SCHEDULER_NO_TASK		0xFF
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Task runs to completion, deadline is relative to release. A lower task ID
+// wins a tie of deadlines
+typedef struct
+{
+	const char *name;
+	void (*Run)(void);
+	uint16_t deadline;				// ms after release
+	uint16_t budget;				// us of execution time
+}
+sSCHEDULER_TASK;
+
+typedef struct
+{
+	uint32_t runCount;
+	uint32_t missCount;				// Completed after deadline
+	uint32_t overrunCount;			// Ran longer than budget
+	uint32_t maximumTime;			// us
+}
+sSCHEDULER_STATISTIC;
+
+// Define scheduler function structure
+typedef struct _sSCHEDULER
+{
+	void (*Initialize)(void);
+	void (*Register)(uint8_t taskId, const sSCHEDULER_TASK *psTask);
+	void (*Release)(uint8_t word, uint32_t taskMask);
+	uint8_t (*Next)(void);
+	void (*Run)(uint8_t taskId);
+	uint64_t (*GetOverrun)(void);
+	bool (*GetStatistic)(uint8_t taskId, sSCHEDULER_STATISTIC *psStatistic);
+	void (*Benchmark)(void);
+	void (*Print)(void);
+}
+sSCHEDULER;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sSCHEDULER sScheduler;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SCHEDULER_H_ */
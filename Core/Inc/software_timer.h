@@ -27,7 +27,7 @@ extern TIM_HandleTypeDef htim6;
  * CONSTANTS
  ******************************************************************************/
 #define SOFTWARE_TIMER_HANDLE	htim6
-#define NUM_OF_SOFTWARE_TIMER	8
+#define NUM_OF_SOFTWARE_TIMER	12
 
 /*******************************************************************************
  * ENUMERATE
@@ -43,24 +43,26 @@ eTIMER_TYPE;
 /*******************************************************************************
  * STRUCTURE
  ******************************************************************************/
-// Software timer callback function.
-typedef void (*SOFTWARE_TIMER_CALLBACK)(uint8_t softwareTimerId);
+// Software timer callback function, arg is user context given at initialize
+typedef void (*SOFTWARE_TIMER_CALLBACK)(uint8_t softwareTimerId, void *arg);
 
 // Define software timer function structure
 typedef struct _sSOFTWARE_TIMER
 {
 	bool (*Enable)(void);
 	bool (*Disable)(void);
-	uint8_t (*Initialize)(SOFTWARE_TIMER_CALLBACK softwareTimerStartCallback, SOFTWARE_TIMER_CALLBACK softwareTimerCallback, SOFTWARE_TIMER_CALLBACK softwareTimerStopCallback, eTIMER_TYPE eTimerType);
+	uint8_t (*Initialize)(SOFTWARE_TIMER_CALLBACK softwareTimerStartCallback, SOFTWARE_TIMER_CALLBACK softwareTimerCallback, SOFTWARE_TIMER_CALLBACK softwareTimerStopCallback, eTIMER_TYPE eTimerType, void *arg);
 	void (*Start)(uint8_t softwareTimerId, uint32_t period);
 	void (*Stop)(uint8_t softwareTimerId);
+	uint32_t (*GetCountdown)(uint8_t softwareTimerId);
+	void (*Print)(void);
 }
 sSOFTWARE_TIMER;
 
 /*******************************************************************************
  * PUBLIC VARIABLES
  ******************************************************************************/
-extern sSOFTWARE_TIMER sSoftwareTimer;
+extern const sSOFTWARE_TIMER sSoftwareTimer;
 
 /*******************************************************************************
  * PUBLIC FUNCTIONS
@@ -21,7 +21,7 @@ extern "C"
 /*******************************************************************************
  * ENUMERATE
  ******************************************************************************/
-// Machine status enumerate
+// Machine status enumerate, derived from coin and dispense regions
 typedef enum
 {
 	acceptCoinMachineStatus = 0,
@@ -32,22 +32,75 @@ typedef enum
 }
 eMACHINE_STATUS;
 
+// Machine event enumerate, shared by all regions
+typedef enum
+{
+	startMachineEvent = 0,
+	insertCoinMachineEvent,
+	dispenseButtonMachineEvent,
+	dispensingTimerMachineEvent,
+	maintenanceStartMachineEvent,
+	maintenanceEndMachineEvent,
+	totalMachineEvent,
+}
+eMACHINE_EVENT;
+
+// Orthogonal regions, dispatched in this order
+typedef enum
+{
+	maintenanceRegion = 0,
+	dispenseRegion,
+	coinRegion,
+	maximumRegion,
+}
+eMACHINE_REGION;
+
 /*******************************************************************************
  * STRUCTURE
  ******************************************************************************/
+// Credit and audit counters
+typedef struct
+{
+	uint8_t totalCoin;
+	uint32_t lifetimeCoin;
+	uint32_t lifetimeVend;
+	uint32_t heldCoin;		// Taken beyond uint8_t credit, not credited yet
+}
+sSTATE_MACHINE_COUNTER;
+
+// Transition coverage and residency, eventCount is bumped once per event
+typedef struct
+{
+	uint32_t eventCount[totalMachineStatus][totalMachineEvent];
+	uint32_t entryCount[totalMachineStatus];
+	uint32_t residency[totalMachineStatus];		// Time in status in ms
+}
+sSTATE_MACHINE_COVERAGE;
+
 // Define state machine structure
 typedef struct _sSTATE_MACHINE
 {
 	void (*Initialize)(void);
 	void (*InsertCoin)(void);
+	void (*InsertCoins)(uint32_t numOfCoin);
 	void (*DispenseButtonPressed)(void);
+	void (*DispensingTimeout)(void);
+	void (*Maintenance)(bool start);
+	eMACHINE_STATUS (*GetStatus)(void);
+	uint8_t (*GetTotalCoin)(void);
+	void (*GetCounter)(sSTATE_MACHINE_COUNTER *psCounter);
+	void (*Print)(void);
+	void (*GetCoverage)(sSTATE_MACHINE_COVERAGE *psCoverage);
+	void (*ResetCoverage)(void);
+	void (*PrintCoverage)(void);
+	void (*BenchmarkCoverage)(void);
 }
 sSTATE_MACHINE;
 
 /*******************************************************************************
  * PUBLIC VARIABLES
  ******************************************************************************/
-extern sSTATE_MACHINE sStateMachine;
+extern const sSTATE_MACHINE sStateMachine;
 
 /*******************************************************************************
  * PUBLIC FUNCTIONS
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Filename:			telemetry.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    COBS framed binary telemetry function
+*******************************************************************************/
+
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+#include "state_machine.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Frames go out on the console TX DMA ring once "telemetry on" is entered
+#define TELEMETRY_ENABLE		1
+// Counter and timer snapshot period in ms
+#define TELEMETRY_PERIOD		1000
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Record type, first byte of every record
+typedef enum
+{
+	transitionTelemetryRecord = 1,
+	counterTelemetryRecord,
+	timerTelemetryRecord,
+	coverageTelemetryRecord,
+}
+eTELEMETRY_RECORD;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Records are little endian with natural alignment. A frame is the COBS
+// encoded record followed by an inverted byte sum, ended by 0x00
+
+// State transition
+typedef struct
+{
+	uint8_t type;
+	uint8_t from;				// eMACHINE_STATUS
+	uint8_t to;					// eMACHINE_STATUS
+	uint8_t event;				// eMACHINE_EVENT
+	uint32_t timestamp;			// HAL tick in ms
+}
+sTELEMETRY_TRANSITION;
+
+// Machine counters
+typedef struct
+{
+	uint8_t type;
+	uint8_t status;				// eMACHINE_STATUS
+	uint8_t totalCoin;
+	uint8_t clockLevel;			// eCLOCK_LEVEL
+	uint32_t timestamp;
+	uint32_t lifetimeCoin;
+	uint32_t lifetimeVend;
+	uint32_t txDrop;			// Console bytes dropped
+}
+sTELEMETRY_COUNTER;
+
+// Software timer tick interrupt latency in cycles
+typedef struct
+{
+	uint8_t type;
+	uint8_t reserved[3];
+	uint32_t timestamp;
+	uint32_t count;
+	uint32_t last;
+	uint32_t minimum;
+	uint32_t maximum;
+}
+sTELEMETRY_TIMER;
+
+// Transition coverage and residency of every machine status
+typedef struct
+{
+	uint8_t type;
+	uint8_t reserved[3];
+	uint32_t timestamp;
+	uint32_t residency[totalMachineStatus];
+	uint32_t eventCount[totalMachineStatus][totalMachineEvent];
+}
+sTELEMETRY_COVERAGE;
+
+// Define telemetry function structure
+typedef struct _sTELEMETRY
+{
+	void (*Initialize)(void);
+	void (*Stream)(bool enable);
+	void (*Transition)(eMACHINE_STATUS eFrom, eMACHINE_STATUS eTo, eMACHINE_EVENT eEvent);
+	void (*Snapshot)(void);
+}
+sTELEMETRY;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sTELEMETRY sTelemetry;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TELEMETRY_H_ */
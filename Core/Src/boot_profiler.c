@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * Filename:			boot_profiler.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Boot phase profiler function
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "boot_profiler.h"
+#include "cycle_counter.h"
+#include "latency_trace.h"
+#include "log.h"
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define boot profiler property structure
+typedef struct
+{
+	uint32_t stampedPhase;
+	uint32_t cycle[maximumBootPhase];
+	// Core clock when the phase ended, the next phase runs at this clock
+	uint32_t coreClock[maximumBootPhase];
+	// Latency trace timer in us once it runs. Phases after ready may sleep
+	// and change clock, only this time is valid for them
+	uint32_t timedPhase;
+	uint32_t microsecond[maximumBootPhase];
+}
+sBOOT_PROFILER_PRO;
+static sBOOT_PROFILER_PRO sBootProfilerPro;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void BootProfilerStart(void);
+static void BootProfilerStamp(eBOOT_PHASE eBootPhase);
+static void BootProfilerPrint(void);
+
+/*******************************************************************************
+ * @fn      BootProfilerStart
+ * @brief   Restart cycle counter from 0, first statement of main().
+ *          DWT is not reset by system reset so the counter is cleared here
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void BootProfilerStart(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	BootProfilerStamp(mainBootPhase);
+}
+
+/*******************************************************************************
+ * @fn      BootProfilerStamp
+ * @brief   Stamp end of a phase, only the first stamp of a phase counts
+ * @param   eBootPhase
+ * @return  None
+ ******************************************************************************/
+static void BootProfilerStamp(eBOOT_PHASE eBootPhase)
+{
+	if((sBootProfilerPro.stampedPhase & (0x01 << eBootPhase)) != 0)
+	{
+		return;
+	}
+	sBootProfilerPro.cycle[eBootPhase] = CYCLE_COUNTER_READ();
+	sBootProfilerPro.coreClock[eBootPhase] = SystemCoreClock;
+	if((LATENCY_TRACE_TIMER->CR1 & TIM_CR1_CEN) != 0)
+	{
+		sBootProfilerPro.microsecond[eBootPhase] = LATENCY_TRACE_TIMER->CNT;
+		sBootProfilerPro.timedPhase |= (0x01 << eBootPhase);
+	}
+	sBootProfilerPro.stampedPhase |= (0x01 << eBootPhase);
+}
+
+/*******************************************************************************
+ * @fn      BootProfilerPrint
+ * @brief   Print boot latency of every phase in cycles and us, phases
+ *          timed by the latency trace timer in us only. Ready is the
+ *          reset to ready time
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void BootProfilerPrint(void)
+{
+	static const char *name[maximumBootPhase] =
+	{
+		"main", "HAL_Init", "PLL start", "GPIO init", "Clock switch", "TIM6 init", "Application", "Deferred", "First event",
+	};
+	uint32_t bothStamped = 0;
+	uint32_t totalMicrosecond = 0;
+	uint32_t microsecond = 0;
+	uint32_t cycle = 0;
+	uint8_t i = 0;
+
+	sLog.Printf("Boot phase        cycles         us\n");
+	for(i = 1; i < maximumBootPhase; i++)
+	{
+		bothStamped = (0x01 << i) | (0x01 << (i - 1));
+		if((sBootProfilerPro.stampedPhase & bothStamped) != bothStamped)
+		{
+			continue;
+		}
+		if((sBootProfilerPro.timedPhase & bothStamped) == bothStamped)
+		{
+			microsecond = sBootProfilerPro.microsecond[i] - sBootProfilerPro.microsecond[i - 1];
+			sLog.Printf("%-12s %11s %10lu\n", name[i], "-", (unsigned long)microsecond);
+		}
+		else
+		{
+			cycle = sBootProfilerPro.cycle[i] - sBootProfilerPro.cycle[i - 1];
+			microsecond = (uint64_t)cycle * 1000000 / sBootProfilerPro.coreClock[i - 1];
+			sLog.Printf("%-12s %11lu %10lu\n", name[i], (unsigned long)cycle, (unsigned long)microsecond);
+		}
+		totalMicrosecond += microsecond;
+		if(i == applicationBootPhase)
+		{
+			sLog.Printf("Ready                    %10lu\n", (unsigned long)totalMicrosecond);
+		}
+	}
+	sLog.Printf("Total                    %10lu\n", (unsigned long)totalMicrosecond);
+}
+
+// Boot profiler function structure
+const sBOOT_PROFILER sBootProfiler =
+{
+	BootProfilerStart,
+	BootProfilerStamp,
+	BootProfilerPrint,
+};
@@ -0,0 +1,309 @@
+/*******************************************************************************
+ * Filename:			clock_governor.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Dynamic core clock scaling function
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "clock_governor.h"
+#include "software_timer.h"
+#include "cycle_counter.h"
+#include "coin_capture.h"
+#include "latency_trace.h"
+#include "main_loop.h"
+#include "gpio.h"
+#include "log.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// PLL lock and regulator settle poll limit
+#define CLOCK_GOVERNOR_TIMEOUT	100000
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define clock governor property structure
+typedef struct
+{
+	uint8_t idleTimerId;
+	bool running;
+	uint32_t swoBaud;				// SWO baud debugger set, 0 without trace
+	eCLOCK_LEVEL eLevel;
+	uint32_t levelTick;
+	sCLOCK_GOVERNOR_STATISTIC sStatistic;
+}
+sCLOCK_GOVERNOR_PRO;
+static sCLOCK_GOVERNOR_PRO sClockGovernorPro =
+{
+	.eLevel = highClockLevel,
+};
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void ClockGovernorInitialize(void);
+static void ClockGovernorBusy(void);
+static void ClockGovernorIdle(void);
+static eCLOCK_LEVEL ClockGovernorGetLevel(void);
+static void ClockGovernorGetStatistic(sCLOCK_GOVERNOR_STATISTIC *psStatistic);
+static void ClockGovernorPrint(void);
+
+/*******************************************************************************
+ * @fn      ClockGovernorIdleTimerCallback
+ * @brief   No event for idle period, let main loop decide to drop the clock
+ * @param   softwareTimerId
+ *          arg
+ * @return  None
+ ******************************************************************************/
+static void ClockGovernorIdleTimerCallback(uint8_t softwareTimerId, void *arg)
+{
+	sEventFlag.Set(clockGovernorEventFlag);
+}
+
+/*******************************************************************************
+ * @fn      ClockGovernorSwoOn
+ * @brief   Debugger is attached and traces through SWO
+ * @param   None
+ * @return  true
+ *          false
+ ******************************************************************************/
+static bool ClockGovernorSwoOn(void)
+{
+	return (CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) != 0 &&
+		   (CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk) != 0 && (ITM->TCR & ITM_TCR_ITMENA_Msk) != 0;
+}
+
+/*******************************************************************************
+ * @fn      ClockGovernorSwoReachable
+ * @brief   SWO baud is HCLK / (ACPR + 1), baud debugger set at current
+ *          clock can be kept at clock
+ * @param   clock
+ * @return  true
+ *          false
+ ******************************************************************************/
+static bool ClockGovernorSwoReachable(uint32_t clock)
+{
+	uint32_t baud = SystemCoreClock / (TPI->ACPR + 1);
+
+	return baud > 0 && baud <= clock && clock % baud == 0;
+}
+
+/*******************************************************************************
+ * @fn      ClockGovernorRetune
+ * @brief   Keep 1 ms software timer tick and SysTick exact at new core clock.
+ *          TIM6 prescaler is reloaded at once with its counter kept, so a
+ *          switch costs less than one 0.1 ms prescaler step. SysTick restarts
+ *          its current 1 ms period. SWO prescaler follows so the viewer
+ *          keeps decoding, latency stamps keep counting us
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ClockGovernorRetune(void)
+{
+	TIM_TypeDef *timer = SOFTWARE_TIMER_HANDLE.Instance;
+	uint32_t primask = __get_PRIMASK();
+	uint32_t counter = 0;
+
+	__disable_irq();
+	SystemCoreClockUpdate();
+	if(sClockGovernorPro.swoBaud > 0)
+	{
+		TPI->ACPR = SystemCoreClock / sClockGovernorPro.swoBaud - 1;
+	}
+	SOFTWARE_TIMER_HANDLE.Init.Prescaler = SystemCoreClock / CLOCK_GOVERNOR_TIMER_CLOCK - 1;
+	counter = timer->CNT;
+	timer->PSC = SOFTWARE_TIMER_HANDLE.Init.Prescaler;
+	// Update generation only reloads prescaler, no interrupt
+	timer->CR1 |= TIM_CR1_URS;
+	timer->EGR = TIM_EGR_UG;
+	timer->CNT = counter;
+	timer->CR1 &= ~TIM_CR1_URS;
+	sLatencyTrace.Retune();
+	if(HAL_InitTick(uwTickPrio) != HAL_OK)
+	{
+		Error_Handler();
+	}
+	__set_PRIMASK(primask);
+}
+
+/*******************************************************************************
+ * @fn      ClockGovernorSwitch
+ * @brief   Switch core clock, PLL keeps configuration of SystemClock_Config
+ *          while it is off. Raise voltage before frequency and lower it after
+ * @param   eLevel
+ * @return  None
+ ******************************************************************************/
+static void ClockGovernorSwitch(eCLOCK_LEVEL eLevel)
+{
+	uint32_t startCycle = CYCLE_COUNTER_READ();
+	uint32_t now = HAL_GetTick();
+	uint32_t timeout = 0;
+	uint32_t cycle = 0;
+
+	// Baud taken at old clock, Idle keeps high clock when low one can not
+	// reach it
+	sClockGovernorPro.swoBaud = ClockGovernorSwoOn() ? SystemCoreClock / (TPI->ACPR + 1) : 0;
+	if(eLevel == highClockLevel)
+	{
+		if(HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE1) != HAL_OK)
+		{
+			Error_Handler();
+		}
+		__HAL_RCC_PLL_ENABLE();
+		for(timeout = 0; __HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) == 0; timeout++)
+		{
+			if(timeout >= CLOCK_GOVERNOR_TIMEOUT)
+			{
+				Error_Handler();
+			}
+		}
+		__HAL_FLASH_SET_LATENCY(FLASH_LATENCY_4);
+		__HAL_RCC_SYSCLK_CONFIG(RCC_SYSCLKSOURCE_PLLCLK);
+		while(__HAL_RCC_GET_SYSCLK_SOURCE() != RCC_SYSCLKSOURCE_STATUS_PLLCLK)
+		{
+		}
+		ClockGovernorRetune();
+	}
+	else
+	{
+		__HAL_RCC_SYSCLK_CONFIG(RCC_SYSCLKSOURCE_MSI);
+		while(__HAL_RCC_GET_SYSCLK_SOURCE() != RCC_SYSCLKSOURCE_STATUS_MSI)
+		{
+		}
+		ClockGovernorRetune();
+		__HAL_FLASH_SET_LATENCY(FLASH_LATENCY_0);
+		__HAL_RCC_PLL_DISABLE();
+		if(HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE2) != HAL_OK)
+		{
+			Error_Handler();
+		}
+	}
+
+	cycle = CYCLE_COUNTER_READ() - startCycle;
+	sClockGovernorPro.sStatistic.residency[sClockGovernorPro.eLevel] += now - sClockGovernorPro.levelTick;
+	sClockGovernorPro.levelTick = now;
+	sClockGovernorPro.eLevel = eLevel;
+	sClockGovernorPro.sStatistic.switchCount[eLevel]++;
+	sClockGovernorPro.sStatistic.lastSwitchCycle[eLevel] = cycle;
+	if(cycle > sClockGovernorPro.sStatistic.maximumSwitchCycle[eLevel])
+	{
+		sClockGovernorPro.sStatistic.maximumSwitchCycle[eLevel] = cycle;
+	}
+}
+
+/*******************************************************************************
+ * @fn      ClockGovernorInitialize
+ * @brief   Start idle detection. Input capture counts 1 us at 80 MHz only, so
+ *          the clock stays high when coin capture is enabled
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ClockGovernorInitialize(void)
+{
+	sClockGovernorPro.levelTick = HAL_GetTick();
+	if(!CLOCK_GOVERNOR_ENABLE || COIN_CAPTURE_ENABLE)
+	{
+		return;
+	}
+	sClockGovernorPro.idleTimerId = sSoftwareTimer.Initialize(NULL, ClockGovernorIdleTimerCallback, NULL, TIMER_ONCE_TYPE, NULL);
+	sClockGovernorPro.running = true;
+	sSoftwareTimer.Start(sClockGovernorPro.idleTimerId, CLOCK_GOVERNOR_IDLE_PERIOD);
+}
+
+/*******************************************************************************
+ * @fn      ClockGovernorBusy
+ * @brief   Event to handle, raise clock before handling and restart idle time
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ClockGovernorBusy(void)
+{
+	if(!sClockGovernorPro.running)
+	{
+		return;
+	}
+	if(sClockGovernorPro.eLevel != highClockLevel)
+	{
+		ClockGovernorSwitch(highClockLevel);
+	}
+	sSoftwareTimer.Start(sClockGovernorPro.idleTimerId, CLOCK_GOVERNOR_IDLE_PERIOD);
+}
+
+/*******************************************************************************
+ * @fn      ClockGovernorIdle
+ * @brief   Nothing to do, drop clock until next event unless SWO trace
+ *          would lose its baud
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ClockGovernorIdle(void)
+{
+	// SWO baud 4 MHz can not make exactly, debug session stays at 80 MHz
+	if(ClockGovernorSwoOn() && !ClockGovernorSwoReachable(CLOCK_GOVERNOR_LOW_CLOCK))
+	{
+		return;
+	}
+	if(sClockGovernorPro.running && sClockGovernorPro.eLevel != lowClockLevel)
+	{
+		ClockGovernorSwitch(lowClockLevel);
+	}
+}
+
+/*******************************************************************************
+ * @fn      ClockGovernorGetLevel
+ * @brief   Get current clock level
+ * @param   None
+ * @return  Clock level
+ ******************************************************************************/
+static eCLOCK_LEVEL ClockGovernorGetLevel(void)
+{
+	return sClockGovernorPro.eLevel;
+}
+
+/*******************************************************************************
+ * @fn      ClockGovernorGetStatistic
+ * @brief   Get statistic, residency includes time at current level
+ * @param   psStatistic
+ * @return  None
+ ******************************************************************************/
+static void ClockGovernorGetStatistic(sCLOCK_GOVERNOR_STATISTIC *psStatistic)
+{
+	*psStatistic = sClockGovernorPro.sStatistic;
+	psStatistic->residency[sClockGovernorPro.eLevel] += HAL_GetTick() - sClockGovernorPro.levelTick;
+}
+
+/*******************************************************************************
+ * @fn      ClockGovernorPrint
+ * @brief   Print residency and switch latency of every level
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ClockGovernorPrint(void)
+{
+	static const char *name[maximumClockLevel] = {"4 MHz", "80 MHz"};
+	sCLOCK_GOVERNOR_STATISTIC sStatistic;
+	uint8_t i = 0;
+
+	ClockGovernorGetStatistic(&sStatistic);
+	for(i = 0; i < maximumClockLevel; i++)
+	{
+		sLog.Printf("%-6s: %lu ms, %lu switches, last %lu max %lu cycles\n", name[i],
+				(unsigned long)sStatistic.residency[i], (unsigned long)sStatistic.switchCount[i],
+				(unsigned long)sStatistic.lastSwitchCycle[i], (unsigned long)sStatistic.maximumSwitchCycle[i]);
+	}
+}
+
+// Clock governor function structure
+const sCLOCK_GOVERNOR sClockGovernor =
+{
+	ClockGovernorInitialize,
+	ClockGovernorBusy,
+	ClockGovernorIdle,
+	ClockGovernorGetLevel,
+	ClockGovernorGetStatistic,
+	ClockGovernorPrint,
+};
@@ -0,0 +1,242 @@
+/*******************************************************************************
+ * Filename:			coin_capture.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Input capture pulse width coin denomination function
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "coin_capture.h"
+#include "software_timer.h"
+#include "cycle_counter.h"
+#include "main_loop.h"
+#include "gpio.h"
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Denomination by pulse width
+typedef struct
+{
+	uint32_t minimumWidth;
+	uint32_t maximumWidth;
+	uint8_t value;
+}
+sCOIN_DENOMINATION;
+
+// Define coin capture property structure
+typedef struct
+{
+	uint8_t timerId;
+	uint16_t readIndex;
+	bool waitRisingEdge;
+	uint32_t fallingStamp;
+	sCOIN_CAPTURE_STATISTIC sStatistic;
+}
+sCOIN_CAPTURE_PRO;
+static sCOIN_CAPTURE_PRO sCoinCapturePro;
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static TIM_HandleTypeDef htim2;
+static DMA_HandleTypeDef hdma_tim2_ch1;
+// Written by DMA only, one timestamp per edge
+static uint32_t edgeStamp[COIN_CAPTURE_BUFFER];
+
+// Pulse width windows in us
+static const sCOIN_DENOMINATION sCoinDenomination[] =
+{
+	{20000, 40000, 1},
+	{50000, 70000, 2},
+	{80000, 120000, 5},
+};
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void CoinCaptureInitialize(void);
+static uint8_t CoinCaptureClassify(sCOIN_CAPTURE_EVENT *psEvent, uint8_t maximum);
+static void CoinCaptureGetStatistic(sCOIN_CAPTURE_STATISTIC *psStatistic);
+
+/*******************************************************************************
+ * @fn      CoinCaptureWriteIndex
+ * @brief   Next buffer slot DMA will write
+ * @param   None
+ * @return  Index
+ ******************************************************************************/
+static uint16_t CoinCaptureWriteIndex(void)
+{
+	return (COIN_CAPTURE_BUFFER - __HAL_DMA_GET_COUNTER(&hdma_tim2_ch1)) & (COIN_CAPTURE_BUFFER - 1);
+}
+
+/*******************************************************************************
+ * @fn      CoinCaptureTimerCallback
+ * @brief   Wake main loop when DMA stored new edges
+ * @param   softwareTimerId
+ *          arg
+ * @return  None
+ ******************************************************************************/
+static void CoinCaptureTimerCallback(uint8_t softwareTimerId, void *arg)
+{
+	if(CoinCaptureWriteIndex() != sCoinCapturePro.readIndex)
+	{
+		sEventFlag.Set(coinCaptureEventFlag);
+	}
+}
+
+/*******************************************************************************
+ * @fn      CoinCaptureInitialize
+ * @brief   TIM2 CH1 captures both edges, DMA1 channel 5 stores timestamps
+ *          in circular buffer, no interrupt per edge
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void CoinCaptureInitialize(void)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	TIM_IC_InitTypeDef sConfigIC = {0};
+
+	if(!COIN_CAPTURE_ENABLE)
+	{
+		return;
+	}
+
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_TIM2_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	GPIO_InitStruct.Pin = COIN_CAPTURE_Pin;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	GPIO_InitStruct.Alternate = GPIO_AF1_TIM2;
+	HAL_GPIO_Init(COIN_CAPTURE_GPIO_Port, &GPIO_InitStruct);
+
+	htim2.Instance = TIM2;
+	htim2.Init.Prescaler = COIN_CAPTURE_PRESCALER;
+	htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim2.Init.Period = 0xFFFFFFFF;
+	htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if(HAL_TIM_IC_Init(&htim2) != HAL_OK)
+	{
+		Error_Handler();
+	}
+	sConfigIC.ICPolarity = TIM_INPUTCHANNELPOLARITY_BOTHEDGE;
+	sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+	sConfigIC.ICPrescaler = TIM_ICPSC_DIV1;
+	sConfigIC.ICFilter = 0x0F;
+	if(HAL_TIM_IC_ConfigChannel(&htim2, &sConfigIC, TIM_CHANNEL_1) != HAL_OK)
+	{
+		Error_Handler();
+	}
+
+	hdma_tim2_ch1.Instance = DMA1_Channel5;
+	hdma_tim2_ch1.Init.Request = DMA_REQUEST_4;
+	hdma_tim2_ch1.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	hdma_tim2_ch1.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_tim2_ch1.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_tim2_ch1.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+	hdma_tim2_ch1.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+	hdma_tim2_ch1.Init.Mode = DMA_CIRCULAR;
+	hdma_tim2_ch1.Init.Priority = DMA_PRIORITY_LOW;
+	if(HAL_DMA_Init(&hdma_tim2_ch1) != HAL_OK)
+	{
+		Error_Handler();
+	}
+	__HAL_LINKDMA(&htim2, hdma[TIM_DMA_ID_CC1], hdma_tim2_ch1);
+
+	// DMA1_Channel5_IRQn stays disabled, classifier polls CNDTR
+	if(HAL_TIM_IC_Start_DMA(&htim2, TIM_CHANNEL_1, edgeStamp, COIN_CAPTURE_BUFFER) != HAL_OK)
+	{
+		Error_Handler();
+	}
+
+	sCoinCapturePro.timerId = sSoftwareTimer.Initialize(NULL, CoinCaptureTimerCallback, NULL, TIMER_PERIODIC_TYPE, NULL);
+	sSoftwareTimer.Start(sCoinCapturePro.timerId, COIN_CAPTURE_PERIOD);
+}
+
+/*******************************************************************************
+ * @fn      CoinCaptureClassify
+ * @brief   Pair edges stored since last call and map pulse widths to
+ *          denomination events
+ * @param   psEvent		Event array
+ *          maximum		Size of event array
+ * @return  Number of events
+ ******************************************************************************/
+static uint8_t CoinCaptureClassify(sCOIN_CAPTURE_EVENT *psEvent, uint8_t maximum)
+{
+	uint32_t startCycle = CYCLE_COUNTER_READ();
+	uint16_t writeIndex = CoinCaptureWriteIndex();
+	uint16_t readIndex = sCoinCapturePro.readIndex;
+	uint32_t stamp = 0;
+	uint32_t width = 0;
+	uint8_t numOfEvent = 0;
+	uint8_t i = 0;
+
+	// Leave remaining edges for next call when event array is full
+	while(readIndex != writeIndex && numOfEvent < maximum)
+	{
+		stamp = edgeStamp[readIndex];
+		readIndex = (readIndex + 1) & (COIN_CAPTURE_BUFFER - 1);
+		sCoinCapturePro.sStatistic.edgeCount++;
+
+		// Pin idles high, a pulse is falling edge followed by rising edge
+		if(!sCoinCapturePro.waitRisingEdge)
+		{
+			sCoinCapturePro.fallingStamp = stamp;
+			sCoinCapturePro.waitRisingEdge = true;
+			continue;
+		}
+		width = stamp - sCoinCapturePro.fallingStamp;
+		if(width > COIN_CAPTURE_MAXIMUM_WIDTH)
+		{
+			// Lost an edge, take this one as falling edge
+			sCoinCapturePro.sStatistic.resyncCount++;
+			sCoinCapturePro.fallingStamp = stamp;
+			continue;
+		}
+		sCoinCapturePro.waitRisingEdge = false;
+
+		for(i = 0; i < sizeof(sCoinDenomination) / sizeof(sCoinDenomination[0]); i++)
+		{
+			if(width >= sCoinDenomination[i].minimumWidth && width <= sCoinDenomination[i].maximumWidth)
+			{
+				psEvent[numOfEvent].value = sCoinDenomination[i].value;
+				psEvent[numOfEvent].width = width;
+				numOfEvent++;
+				break;
+			}
+		}
+		if(i == sizeof(sCoinDenomination) / sizeof(sCoinDenomination[0]))
+		{
+			sCoinCapturePro.sStatistic.rejectCount++;
+		}
+	}
+	sCoinCapturePro.readIndex = readIndex;
+	sCoinCapturePro.sStatistic.coinCount += numOfEvent;
+	sCoinCapturePro.sStatistic.cycleCount += CYCLE_COUNTER_READ() - startCycle;
+	return numOfEvent;
+}
+
+/*******************************************************************************
+ * @fn      CoinCaptureGetStatistic
+ * @brief   Copy classifier statistic
+ * @param   psStatistic
+ * @return  None
+ ******************************************************************************/
+static void CoinCaptureGetStatistic(sCOIN_CAPTURE_STATISTIC *psStatistic)
+{
+	*psStatistic = sCoinCapturePro.sStatistic;
+}
+
+// Coin capture function structure
+const sCOIN_CAPTURE sCoinCapture =
+{
+	CoinCaptureInitialize,
+	CoinCaptureClassify,
+	CoinCaptureGetStatistic,
+};
@@ -0,0 +1,847 @@
+/*******************************************************************************
+ * Filename:			console.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    USART2 DMA console function
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "console.h"
+#include "main_loop.h"
+#include "state_machine.h"
+#include "region.h"
+#include "software_timer.h"
+#include "latency_trace.h"
+#include "exti_guard.h"
+#include "boot_profiler.h"
+#include "clock_governor.h"
+#include "flash_journal.h"
+#include "telemetry.h"
+#include "flow_vm.h"
+#include "coroutine.h"
+#include "scheduler.h"
+#include "log.h"
+#include "fault_capture.h"
+#include "itm_trace.h"
+#include "memory_protection.h"
+#include "gpio.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define CONSOLE_RX_MASK			(CONSOLE_RX_SIZE - 1)
+#define CONSOLE_TX_MASK			(CONSOLE_TX_SIZE - 1)
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Word of a command line, kept in place in RX ring
+typedef struct
+{
+	uint16_t start;
+	uint16_t length;
+}
+sCONSOLE_TOKEN;
+
+// Console command
+typedef struct
+{
+	const char *name;
+	void (*Command)(const sCONSOLE_TOKEN *psArgument);
+}
+sCONSOLE_COMMAND;
+
+// Define console property structure
+typedef struct
+{
+	bool initialized;
+	uint16_t rxRead;			// Next byte to scan
+	uint16_t lineStart;
+	uint16_t lineLength;
+	bool lineDrop;				// Rest of overlong line is skipped to its end
+	volatile uint16_t txHead;	// Written by Write
+	volatile uint16_t txTail;	// Advanced when DMA block completes
+	volatile uint16_t txLength;	// Bytes of DMA block in flight, 0 when idle
+	sCONSOLE_STATISTIC sStatistic;
+}
+sCONSOLE_PRO;
+static sCONSOLE_PRO sConsolePro;
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static DMA_HandleTypeDef hdma_usart2_rx;
+static DMA_HandleTypeDef hdma_usart2_tx;
+static uint8_t rxBuffer[CONSOLE_RX_SIZE];
+static uint8_t txBuffer[CONSOLE_TX_SIZE];
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void ConsoleInitialize(void);
+static void ConsoleWrite(const char *data, uint32_t length);
+static void ConsoleProcess(void);
+static void ConsoleGetStatistic(sCONSOLE_STATISTIC *psStatistic);
+
+/*******************************************************************************
+ * COMMAND FUNCTIONS
+ ******************************************************************************/
+static void HelpCommand(const sCONSOLE_TOKEN *psArgument);
+static void StatusCommand(const sCONSOLE_TOKEN *psArgument);
+static void CoinCommand(const sCONSOLE_TOKEN *psArgument);
+static void ButtonCommand(const sCONSOLE_TOKEN *psArgument);
+static void TimersCommand(const sCONSOLE_TOKEN *psArgument);
+static void LatencyCommand(const sCONSOLE_TOKEN *psArgument);
+static void GuardCommand(const sCONSOLE_TOKEN *psArgument);
+static void BootCommand(const sCONSOLE_TOKEN *psArgument);
+static void ClockCommand(const sCONSOLE_TOKEN *psArgument);
+static void JournalCommand(const sCONSOLE_TOKEN *psArgument);
+static void TelemetryCommand(const sCONSOLE_TOKEN *psArgument);
+static void ServiceCommand(const sCONSOLE_TOKEN *psArgument);
+static void RegionsCommand(const sCONSOLE_TOKEN *psArgument);
+static void CoverageCommand(const sCONSOLE_TOKEN *psArgument);
+static void FlowCommand(const sCONSOLE_TOKEN *psArgument);
+static void CoroutinesCommand(const sCONSOLE_TOKEN *psArgument);
+static void TasksCommand(const sCONSOLE_TOKEN *psArgument);
+static void LogCommand(const sCONSOLE_TOKEN *psArgument);
+static void FaultCommand(const sCONSOLE_TOKEN *psArgument);
+static void ItmCommand(const sCONSOLE_TOKEN *psArgument);
+static void MpuCommand(const sCONSOLE_TOKEN *psArgument);
+
+// Command jump table
+static const sCONSOLE_COMMAND sConsoleCommand[] =
+{
+	{"help",	HelpCommand},
+	{"status",	StatusCommand},
+	{"coin",	CoinCommand},
+	{"button",	ButtonCommand},
+	{"timers",	TimersCommand},
+	{"latency",	LatencyCommand},
+	{"guard",	GuardCommand},
+	{"boot",	BootCommand},
+	{"clock",	ClockCommand},
+	{"journal",	JournalCommand},
+	{"telemetry", TelemetryCommand},
+	{"service",	ServiceCommand},
+	{"regions",	RegionsCommand},
+	{"coverage", CoverageCommand},
+	{"flow",	FlowCommand},
+	{"coroutines", CoroutinesCommand},
+	{"tasks",	TasksCommand},
+	{"log",		LogCommand},
+	{"fault",	FaultCommand},
+	{"itm",		ItmCommand},
+	{"mpu",		MpuCommand},
+};
+
+/*******************************************************************************
+ * @fn      ConsoleTokenIs
+ * @brief   Compare token in RX ring with a string
+ * @param   psToken
+ *          name
+ * @return  true	Same
+ *          false	Different
+ ******************************************************************************/
+static bool ConsoleTokenIs(const sCONSOLE_TOKEN *psToken, const char *name)
+{
+	uint16_t i = 0;
+
+	for(i = 0; i < psToken->length; i++)
+	{
+		if(name[i] != rxBuffer[(psToken->start + i) & CONSOLE_RX_MASK])
+		{
+			return false;
+		}
+	}
+	return name[i] == '\0';
+}
+
+/*******************************************************************************
+ * @fn      ConsoleTokenNumber
+ * @brief   Decimal value of token in RX ring
+ * @param   psToken
+ *          defaultValue	Value of an empty token
+ * @return  Value, defaultValue when token is empty or not a number
+ ******************************************************************************/
+static uint32_t ConsoleTokenNumber(const sCONSOLE_TOKEN *psToken, uint32_t defaultValue)
+{
+	uint32_t value = 0;
+	uint16_t i = 0;
+	uint8_t digit = 0;
+
+	if(psToken->length == 0)
+	{
+		return defaultValue;
+	}
+	for(i = 0; i < psToken->length; i++)
+	{
+		digit = rxBuffer[(psToken->start + i) & CONSOLE_RX_MASK] - '0';
+		if(digit > 9)
+		{
+			return defaultValue;
+		}
+		value = value * 10 + digit;
+	}
+	return value;
+}
+
+/*******************************************************************************
+ * @fn      ConsoleNextToken
+ * @brief   Find next space separated word of a line
+ * @param   psToken		Token found, length 0 at end of line
+ *          psLine		Rest of the line, advanced past the token
+ * @return  None
+ ******************************************************************************/
+static void ConsoleNextToken(sCONSOLE_TOKEN *psToken, sCONSOLE_TOKEN *psLine)
+{
+	while(psLine->length > 0 && rxBuffer[psLine->start & CONSOLE_RX_MASK] == ' ')
+	{
+		psLine->start++;
+		psLine->length--;
+	}
+	psToken->start = psLine->start;
+	psToken->length = 0;
+	while(psLine->length > 0 && rxBuffer[psLine->start & CONSOLE_RX_MASK] != ' ')
+	{
+		psToken->length++;
+		psLine->start++;
+		psLine->length--;
+	}
+}
+
+/*******************************************************************************
+ * @fn      ConsoleExecute
+ * @brief   Look up and run the command of a line
+ * @param   psLine
+ * @return  None
+ ******************************************************************************/
+static void ConsoleExecute(sCONSOLE_TOKEN *psLine)
+{
+	sCONSOLE_TOKEN sName;
+	sCONSOLE_TOKEN sArgument;
+	uint8_t i = 0;
+
+	ConsoleNextToken(&sName, psLine);
+	ConsoleNextToken(&sArgument, psLine);
+	if(sName.length == 0)
+	{
+		return;
+	}
+	for(i = 0; i < sizeof(sConsoleCommand) / sizeof(sConsoleCommand[0]); i++)
+	{
+		if(ConsoleTokenIs(&sName, sConsoleCommand[i].name))
+		{
+			sConsolePro.sStatistic.command++;
+			sConsoleCommand[i].Command(&sArgument);
+			return;
+		}
+	}
+	sConsolePro.sStatistic.unknownCommand++;
+	sLog.Printf("Unknown command, type help\n");
+}
+
+/*******************************************************************************
+ * @fn      ConsoleTransmit
+ * @brief   Start DMA on the contiguous part of TX ring, interrupt disabled
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ConsoleTransmit(void)
+{
+	uint16_t head = sConsolePro.txHead;
+	uint16_t tail = sConsolePro.txTail;
+
+	sConsolePro.txLength = (head >= tail ? head : CONSOLE_TX_SIZE) - tail;
+	if(sConsolePro.txLength > 0)
+	{
+		HAL_DMA_Start_IT(&hdma_usart2_tx, (uint32_t)&txBuffer[tail], (uint32_t)&USART2->TDR, sConsolePro.txLength);
+	}
+}
+
+/*******************************************************************************
+ * @fn      ConsoleTransmitCallback
+ * @brief   DMA block sent, release it and send the rest of TX ring
+ * @param   hdma
+ * @return  None
+ ******************************************************************************/
+static void ConsoleTransmitCallback(DMA_HandleTypeDef *hdma)
+{
+	sConsolePro.txTail = (sConsolePro.txTail + sConsolePro.txLength) & CONSOLE_TX_MASK;
+	ConsoleTransmit();
+}
+
+/*******************************************************************************
+ * @fn      ConsoleInitialize
+ * @brief   USART2 8N1 on HSI16, RX circular DMA with idle line interrupt,
+ *          TX DMA from TX ring
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ConsoleInitialize(void)
+{
+	static const sSCHEDULER_TASK sConsoleTask = {"console", ConsoleProcess, 50, 10000};
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+	if(!CONSOLE_ENABLE)
+	{
+		return;
+	}
+	sScheduler.Register(consoleEventFlag, &sConsoleTask);
+
+	__HAL_RCC_HSI_ENABLE();
+	while(__HAL_RCC_GET_FLAG(RCC_FLAG_HSIRDY) == 0)
+	{
+	}
+	__HAL_RCC_USART2_CONFIG(RCC_USART2CLKSOURCE_HSI);
+	__HAL_RCC_USART2_CLK_ENABLE();
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	GPIO_InitStruct.Pin = CONSOLE_TX_Pin | CONSOLE_RX_Pin;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF7_USART2;
+	HAL_GPIO_Init(CONSOLE_GPIO_Port, &GPIO_InitStruct);
+
+	hdma_usart2_rx.Instance = DMA1_Channel6;
+	hdma_usart2_rx.Init.Request = DMA_REQUEST_2;
+	hdma_usart2_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	hdma_usart2_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_usart2_rx.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_usart2_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_usart2_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	hdma_usart2_rx.Init.Mode = DMA_CIRCULAR;
+	hdma_usart2_rx.Init.Priority = DMA_PRIORITY_MEDIUM;
+	if(HAL_DMA_Init(&hdma_usart2_rx) != HAL_OK)
+	{
+		Error_Handler();
+	}
+
+	hdma_usart2_tx.Instance = DMA1_Channel7;
+	hdma_usart2_tx.Init.Request = DMA_REQUEST_2;
+	hdma_usart2_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	hdma_usart2_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_usart2_tx.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_usart2_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_usart2_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	hdma_usart2_tx.Init.Mode = DMA_NORMAL;
+	hdma_usart2_tx.Init.Priority = DMA_PRIORITY_LOW;
+	if(HAL_DMA_Init(&hdma_usart2_tx) != HAL_OK)
+	{
+		Error_Handler();
+	}
+	hdma_usart2_tx.XferCpltCallback = ConsoleTransmitCallback;
+
+	USART2->CR1 = 0;
+	USART2->BRR = (CONSOLE_CLOCK + CONSOLE_BAUDRATE / 2) / CONSOLE_BAUDRATE;
+	USART2->CR3 = USART_CR3_DMAR | USART_CR3_DMAT;
+	USART2->CR1 = USART_CR1_IDLEIE | USART_CR1_TE | USART_CR1_RE | USART_CR1_UE;
+
+	// RX DMA never stops, CNDTR gives the write position
+	if(HAL_DMA_Start(&hdma_usart2_rx, (uint32_t)&USART2->RDR, (uint32_t)rxBuffer, CONSOLE_RX_SIZE) != HAL_OK)
+	{
+		Error_Handler();
+	}
+
+	HAL_NVIC_SetPriority(USART2_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(USART2_IRQn);
+	HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+	// Send what was logged before
+	__disable_irq();
+	sConsolePro.initialized = true;
+	ConsoleTransmit();
+	__enable_irq();
+	sLog.Printf("Console ready, type help\n");
+}
+
+/*******************************************************************************
+ * @fn      ConsoleWrite
+ * @brief   Queue data to TX ring and start DMA when idle, safe from
+ *          interrupt. Data not fitting the ring is dropped. Before
+ *          initialization data waits in the ring, boot log is kept
+ * @param   data
+ *          length
+ * @return  None
+ ******************************************************************************/
+static void ConsoleWrite(const char *data, uint32_t length)
+{
+	uint32_t primask = 0;
+	uint16_t head = 0;
+	uint32_t i = 0;
+
+	if(!CONSOLE_ENABLE)
+	{
+		return;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	head = sConsolePro.txHead;
+	for(i = 0; i < length; i++)
+	{
+		if(((head + 1) & CONSOLE_TX_MASK) == sConsolePro.txTail)
+		{
+			sConsolePro.sStatistic.txDrop += length - i;
+			break;
+		}
+		txBuffer[head] = data[i];
+		head = (head + 1) & CONSOLE_TX_MASK;
+	}
+	sConsolePro.txHead = head;
+	if(sConsolePro.initialized && sConsolePro.txLength == 0)
+	{
+		ConsoleTransmit();
+	}
+	__set_PRIMASK(primask);
+}
+
+/*******************************************************************************
+ * @fn      ConsoleProcess
+ * @brief   Scan received bytes and run every complete line in place
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ConsoleProcess(void)
+{
+	uint16_t rxWrite = (CONSOLE_RX_SIZE - __HAL_DMA_GET_COUNTER(&hdma_usart2_rx)) & CONSOLE_RX_MASK;
+	sCONSOLE_TOKEN sLine;
+	uint8_t data = 0;
+
+	while(sConsolePro.rxRead != rxWrite)
+	{
+		data = rxBuffer[sConsolePro.rxRead];
+		sConsolePro.rxRead = (sConsolePro.rxRead + 1) & CONSOLE_RX_MASK;
+		if(data == '\r' || data == '\n')
+		{
+			if(sConsolePro.lineLength > 0 && !sConsolePro.lineDrop)
+			{
+				sLine.start = sConsolePro.lineStart;
+				sLine.length = sConsolePro.lineLength;
+				ConsoleExecute(&sLine);
+			}
+			sConsolePro.lineStart = sConsolePro.rxRead;
+			sConsolePro.lineLength = 0;
+			sConsolePro.lineDrop = false;
+		}
+		else if(++sConsolePro.lineLength >= CONSOLE_RX_SIZE / 2)
+		{
+			// DMA would overwrite the line before it ends
+			if(!sConsolePro.lineDrop)
+			{
+				sConsolePro.sStatistic.lineOverflow++;
+			}
+			sConsolePro.lineStart = sConsolePro.rxRead;
+			sConsolePro.lineLength = 0;
+			sConsolePro.lineDrop = true;
+		}
+	}
+}
+
+/*******************************************************************************
+ * @fn      ConsoleGetStatistic
+ * @brief   Get console statistic
+ * @param   psStatistic
+ * @return  None
+ ******************************************************************************/
+static void ConsoleGetStatistic(sCONSOLE_STATISTIC *psStatistic)
+{
+	*psStatistic = sConsolePro.sStatistic;
+}
+
+/*******************************************************************************
+ * @fn      HelpCommand
+ * @brief   List commands
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void HelpCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	uint8_t i = 0;
+
+	for(i = 0; i < sizeof(sConsoleCommand) / sizeof(sConsoleCommand[0]); i++)
+	{
+		sLog.Printf("%s\n", sConsoleCommand[i].name);
+	}
+}
+
+/*******************************************************************************
+ * @fn      StatusCommand
+ * @brief   Print machine status and credit
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void StatusCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	static const char *name[totalMachineStatus] = {"accept coin", "enough coin", "dispensing", "pause dispense"};
+	eMACHINE_STATUS eMachineStatus = sStateMachine.GetStatus();
+
+	sLog.Printf("Status %s, total coin %d\n", eMachineStatus < totalMachineStatus ? name[eMachineStatus] : "?",
+			sStateMachine.GetTotalCoin());
+}
+
+/*******************************************************************************
+ * @fn      CoinCommand
+ * @brief   Inject coins, "coin [number]"
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void CoinCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	uint32_t numOfCoin = ConsoleTokenNumber(psArgument, 1);
+
+	if(numOfCoin == 0 || numOfCoin > UINT8_MAX)
+	{
+		sLog.Printf("coin [1-255]\n");
+		return;
+	}
+	sStateMachine.InsertCoins(numOfCoin);
+}
+
+/*******************************************************************************
+ * @fn      ButtonCommand
+ * @brief   Inject dispense button press
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void ButtonCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	sStateMachine.DispenseButtonPressed();
+}
+
+/*******************************************************************************
+ * @fn      TimersCommand
+ * @brief   Dump software timers
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void TimersCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	sSoftwareTimer.Print();
+}
+
+/*******************************************************************************
+ * @fn      LatencyCommand
+ * @brief   Print input latency, "latency reset" clears it
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void LatencyCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	if(ConsoleTokenIs(psArgument, "reset"))
+	{
+		sLatencyTrace.Reset();
+		return;
+	}
+	sLatencyTrace.Print();
+}
+
+/*******************************************************************************
+ * @fn      GuardCommand
+ * @brief   Print EXTI storm counters
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void GuardCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	sExtiGuard.Print();
+}
+
+/*******************************************************************************
+ * @fn      BootCommand
+ * @brief   Print boot phases
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void BootCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	sBootProfiler.Print();
+}
+
+/*******************************************************************************
+ * @fn      ClockCommand
+ * @brief   Print clock residency and switch latency
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void ClockCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	sClockGovernor.Print();
+}
+
+/*******************************************************************************
+ * @fn      JournalCommand
+ * @brief   Print flash journal statistic
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void JournalCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	sFLASH_JOURNAL_STATISTIC sStatistic;
+
+	sFlashJournal.GetStatistic(&sStatistic);
+	sLog.Printf("Record %lu header %lu erase %lu error %lu mount %lu cycles\n",
+			(unsigned long)sStatistic.recordWrite, (unsigned long)sStatistic.headerWrite,
+			(unsigned long)sStatistic.pageErase, (unsigned long)sStatistic.errorCount,
+			(unsigned long)sStatistic.mountCycle);
+}
+
+/*******************************************************************************
+ * @fn      TelemetryCommand
+ * @brief   Start or stop binary telemetry, "telemetry on|off"
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void TelemetryCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	if(ConsoleTokenIs(psArgument, "on"))
+	{
+		sTelemetry.Stream(true);
+	}
+	else if(ConsoleTokenIs(psArgument, "off"))
+	{
+		sTelemetry.Stream(false);
+	}
+	else
+	{
+		sLog.Printf("telemetry on|off\n");
+	}
+}
+
+/*******************************************************************************
+ * @fn      ServiceCommand
+ * @brief   Start or end maintenance, "service on|off"
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void ServiceCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	if(ConsoleTokenIs(psArgument, "on"))
+	{
+		sStateMachine.Maintenance(true);
+	}
+	else if(ConsoleTokenIs(psArgument, "off"))
+	{
+		sStateMachine.Maintenance(false);
+	}
+	else
+	{
+		sLog.Printf("service on|off\n");
+	}
+}
+
+/*******************************************************************************
+ * @fn      RegionsCommand
+ * @brief   Print state machine regions and dispatch cost, "regions bench"
+ *          measures dispatch cost as regions grow
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void RegionsCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	if(ConsoleTokenIs(psArgument, "bench"))
+	{
+		sRegionEngine.Benchmark();
+		return;
+	}
+	sStateMachine.Print();
+}
+
+/*******************************************************************************
+ * @fn      CoverageCommand
+ * @brief   Print transition coverage, "coverage reset" clears it,
+ *          "coverage bench" times the counter update of dispatch
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void CoverageCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	if(ConsoleTokenIs(psArgument, "reset"))
+	{
+		sStateMachine.ResetCoverage();
+		return;
+	}
+	if(ConsoleTokenIs(psArgument, "bench"))
+	{
+		sStateMachine.BenchmarkCoverage();
+		return;
+	}
+	sStateMachine.PrintCoverage();
+}
+
+/*******************************************************************************
+ * @fn      FlowCommand
+ * @brief   Print flow program, "flow bench" compares it with native code
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void FlowCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	if(ConsoleTokenIs(psArgument, "bench"))
+	{
+		sFlowVm.Benchmark();
+		return;
+	}
+	sFlowVm.Print();
+}
+
+/*******************************************************************************
+ * @fn      CoroutinesCommand
+ * @brief   Print coroutine frames and resume cost
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void CoroutinesCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	sCoroutine.Print();
+}
+
+/*******************************************************************************
+ * @fn      TasksCommand
+ * @brief   Print scheduler tasks and tasks overrun since last call,
+ *          "tasks bench" measures a dispatch pass
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void TasksCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	uint64_t overrunMask = 0;
+
+	if(ConsoleTokenIs(psArgument, "bench"))
+	{
+		sScheduler.Benchmark();
+		return;
+	}
+	overrunMask = sScheduler.GetOverrun();
+	sScheduler.Print();
+	sLog.Printf("Overrun 0x%08lX%08lX\n", (unsigned long)(overrunMask >> 32), (unsigned long)overrunMask);
+}
+
+/*******************************************************************************
+ * @fn      LogCommand
+ * @brief   Print log level, "log n" sets run time level, "log bench"
+ *          compares log formatter with newlib
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void LogCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	uint32_t level = ConsoleTokenNumber(psArgument, UINT32_MAX);
+
+	if(ConsoleTokenIs(psArgument, "bench"))
+	{
+		sLog.Benchmark();
+		return;
+	}
+	if(psArgument->length > 0 && level == UINT32_MAX)
+	{
+		sLog.Printf("log [0-4]|bench\n");
+		return;
+	}
+	if(level != UINT32_MAX)
+	{
+		sLog.SetLevel(level);
+	}
+	sLog.Printf("Log level %d, compiled level %d, module mask 0x%02X\n", logLevel, LOG_LEVEL, LOG_MODULE_MASK);
+}
+
+/*******************************************************************************
+ * @fn      FaultCommand
+ * @brief   Print fault record left by last reset, "fault clear" drops it,
+ *          "fault test" raises UsageFault
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void FaultCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	if(ConsoleTokenIs(psArgument, "clear"))
+	{
+		sFaultCapture.Clear();
+	}
+	else if(ConsoleTokenIs(psArgument, "test"))
+	{
+		sFaultCapture.Test();
+	}
+	else if(psArgument->length > 0)
+	{
+		sLog.Printf("fault [clear|test]\n");
+		return;
+	}
+	sFaultCapture.Print();
+}
+
+/*******************************************************************************
+ * @fn      ItmCommand
+ * @brief   Print ITM channels, "itm bench" measures bytes per second
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void ItmCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	if(ConsoleTokenIs(psArgument, "bench"))
+	{
+		sItmTrace.Benchmark();
+		return;
+	}
+	sItmTrace.Print();
+}
+
+/*******************************************************************************
+ * @fn      MpuCommand
+ * @brief   Print MPU regions, "mpu bench" compares dispatch through RAM and
+ *          flash tables
+ * @param   psArgument
+ * @return  None
+ ******************************************************************************/
+static void MpuCommand(const sCONSOLE_TOKEN *psArgument)
+{
+	if(ConsoleTokenIs(psArgument, "bench"))
+	{
+		sMemoryProtection.Benchmark();
+		return;
+	}
+	sMemoryProtection.Print();
+}
+
+// Console function structure
+const sCONSOLE sConsole =
+{
+	ConsoleInitialize,
+	ConsoleWrite,
+	ConsoleProcess,
+	ConsoleGetStatistic,
+};
+
+/*******************************************************************************
+ * INTERRUPT CALLBACK
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      ConsoleInterruptCallback
+ * @brief   USART2 interrupt, RX line idle
+ * @param	None
+ * @return	None
+ ******************************************************************************/
+void ConsoleInterruptCallback(void)
+{
+	uint32_t status = USART2->ISR;
+
+	USART2->ICR = USART_ICR_IDLECF | USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF;
+	if((status & USART_ISR_IDLE) != 0)
+	{
+		sEventFlag.Set(consoleEventFlag);
+	}
+}
+
+/*******************************************************************************
+ * @fn      ConsoleDmaInterruptCallback
+ * @brief   DMA1 channel 7 interrupt, TX block sent
+ * @param	None
+ * @return	None
+ ******************************************************************************/
+void ConsoleDmaInterruptCallback(void)
+{
+	HAL_DMA_IRQHandler(&hdma_usart2_tx);
+}
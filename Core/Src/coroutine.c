@@ -0,0 +1,255 @@
+/*******************************************************************************
+ * Filename:			coroutine.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Stackless coroutine with static frame arena
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "coroutine.h"
+#include "software_timer.h"
+#include "cycle_counter.h"
+#include "main_loop.h"
+#include "scheduler.h"
+#include "log.h"
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define coroutine property structure
+typedef struct
+{
+	sCOROUTINE *psCoroutine[NUM_OF_COROUTINE];
+	uint8_t numOfCoroutine;
+	uint16_t arenaUsed;
+	uint32_t resumeCount;
+	uint64_t totalCycle;
+	uint32_t maximumCycle;
+}
+sCOROUTINE_PRO;
+static sCOROUTINE_PRO sCoroutinePro;
+
+// Frame arena, word aligned for frame pointers
+static uint32_t coroutineArena[COROUTINE_ARENA_SIZE / sizeof(uint32_t)];
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static sCOROUTINE *CoroutineCreate(COROUTINE_BODY Body, uint16_t localSize);
+static void CoroutineSignal(sCOROUTINE *psCoroutine, uint32_t signal);
+static void CoroutineRun(void);
+static void CoroutineDelay(sCOROUTINE *psCoroutine, uint32_t period);
+static bool CoroutineTake(sCOROUTINE *psCoroutine);
+static void CoroutinePrint(void);
+
+/*******************************************************************************
+ * @fn      CoroutineTimerCallback
+ * @brief   Delay of a coroutine expired, resumed in main loop
+ * @param   softwareTimerId
+ *          arg		Coroutine frame
+ * @return  None
+ ******************************************************************************/
+static void CoroutineTimerCallback(uint8_t softwareTimerId, void *arg)
+{
+	sCOROUTINE *psCoroutine = arg;
+
+	psCoroutine->signal |= COROUTINE_TIMEOUT_SIGNAL;
+	sEventFlag.Set(coroutineEventFlag);
+}
+
+/*******************************************************************************
+ * @fn      CoroutineCreate
+ * @brief   Allocate frame and locals from arena, coroutine runs up to its
+ *          first wait at next main loop pass
+ * @param   Body
+ *          localSize
+ * @return  Coroutine frame
+ ******************************************************************************/
+static sCOROUTINE *CoroutineCreate(COROUTINE_BODY Body, uint16_t localSize)
+{
+	static const sSCHEDULER_TASK sCoroutineTask = {"coroutine", CoroutineRun, 20, 2000};
+	uint16_t frameSize = (sizeof(sCOROUTINE) + localSize + 3) & ~3;
+	sCOROUTINE *psCoroutine = NULL;
+
+	if(sCoroutinePro.numOfCoroutine == NUM_OF_COROUTINE ||
+	   sCoroutinePro.arenaUsed + frameSize > sizeof(coroutineArena))
+	{
+		// Increase "NUM_OF_COROUTINE" or "COROUTINE_ARENA_SIZE"
+		for(;;)
+		{
+		}
+	}
+	if(sCoroutinePro.numOfCoroutine == 0)
+	{
+		sScheduler.Register(coroutineEventFlag, &sCoroutineTask);
+	}
+	psCoroutine = (sCOROUTINE *)((uint8_t *)coroutineArena + sCoroutinePro.arenaUsed);
+	memset(psCoroutine, 0, frameSize);
+	psCoroutine->Body = Body;
+	psCoroutine->local = localSize > 0 ? psCoroutine + 1 : NULL;
+	psCoroutine->timerId = sSoftwareTimer.Initialize(NULL, CoroutineTimerCallback, NULL, TIMER_ONCE_TYPE, psCoroutine);
+	sCoroutinePro.arenaUsed += frameSize;
+	sCoroutinePro.psCoroutine[sCoroutinePro.numOfCoroutine++] = psCoroutine;
+	sEventFlag.Set(coroutineEventFlag);
+	return psCoroutine;
+}
+
+/*******************************************************************************
+ * @fn      CoroutineSignal
+ * @brief   Raise signals of a coroutine, resumed in main loop when waiting
+ *          for one of them
+ * @param   psCoroutine
+ *          signal
+ * @return  None
+ ******************************************************************************/
+static void CoroutineSignal(sCOROUTINE *psCoroutine, uint32_t signal)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	psCoroutine->signal |= signal;
+	sEventFlag.Set(coroutineEventFlag);
+	__set_PRIMASK(primask);
+}
+
+/*******************************************************************************
+ * @fn      CoroutineReady
+ * @brief   Coroutine has not started or a signal it waits for is pending
+ * @param   psCoroutine
+ * @return  true
+ *          false
+ ******************************************************************************/
+static bool CoroutineReady(const sCOROUTINE *psCoroutine)
+{
+	return !psCoroutine->finished && (psCoroutine->resume == 0 || (psCoroutine->signal & psCoroutine->waitMask) != 0);
+}
+
+/*******************************************************************************
+ * @fn      CoroutineRun
+ * @brief   Resume ready coroutines until all of them wait, main loop only
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void CoroutineRun(void)
+{
+	sCOROUTINE *psCoroutine = NULL;
+	uint32_t startCycle = 0;
+	uint32_t cycle = 0;
+	bool resumed = true;
+	uint8_t i = 0;
+
+	while(resumed)
+	{
+		resumed = false;
+		for(i = 0; i < sCoroutinePro.numOfCoroutine; i++)
+		{
+			psCoroutine = sCoroutinePro.psCoroutine[i];
+			if(!CoroutineReady(psCoroutine))
+			{
+				continue;
+			}
+			startCycle = CYCLE_COUNTER_READ();
+			psCoroutine->Body(psCoroutine);
+			cycle = CYCLE_COUNTER_READ() - startCycle;
+			sCoroutinePro.resumeCount++;
+			sCoroutinePro.totalCycle += cycle;
+			if(cycle > sCoroutinePro.maximumCycle)
+			{
+				sCoroutinePro.maximumCycle = cycle;
+			}
+			resumed = true;
+		}
+	}
+}
+
+/*******************************************************************************
+ * @fn      CoroutineDelay
+ * @brief   Arm delay timer of coroutine, used by COROUTINE_DELAY
+ * @param   psCoroutine
+ *          period
+ * @return  None
+ ******************************************************************************/
+static void CoroutineDelay(sCOROUTINE *psCoroutine, uint32_t period)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	psCoroutine->signal &= ~COROUTINE_TIMEOUT_SIGNAL;
+	__set_PRIMASK(primask);
+	sSoftwareTimer.Start(psCoroutine->timerId, period);
+}
+
+/*******************************************************************************
+ * @fn      CoroutineTake
+ * @brief   Take waited signals, used by COROUTINE_WAIT. Ends a delay that
+ *          another signal cut short
+ * @param   psCoroutine
+ * @return  true	Wait is over
+ *          false	Keep waiting
+ ******************************************************************************/
+static bool CoroutineTake(sCOROUTINE *psCoroutine)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t received = 0;
+
+	__disable_irq();
+	received = psCoroutine->signal & psCoroutine->waitMask;
+	if(received != 0)
+	{
+		psCoroutine->signal &= ~(received | COROUTINE_TIMEOUT_SIGNAL);
+	}
+	__set_PRIMASK(primask);
+
+	if(received == 0)
+	{
+		return false;
+	}
+	if((received & COROUTINE_TIMEOUT_SIGNAL) == 0)
+	{
+		sSoftwareTimer.Stop(psCoroutine->timerId);
+	}
+	psCoroutine->received = received;
+	return true;
+}
+
+/*******************************************************************************
+ * @fn      CoroutinePrint
+ * @brief   Print frame RAM and resume cost
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void CoroutinePrint(void)
+{
+	const sCOROUTINE *psCoroutine = NULL;
+	uint16_t frameSize = 0;
+	uint8_t i = 0;
+
+	sLog.Printf("Coroutine arena %d/%d bytes, frame header %d bytes\n", sCoroutinePro.arenaUsed,
+			(int)sizeof(coroutineArena), (int)sizeof(sCOROUTINE));
+	for(i = 0; i < sCoroutinePro.numOfCoroutine; i++)
+	{
+		psCoroutine = sCoroutinePro.psCoroutine[i];
+		frameSize = (i + 1 < sCoroutinePro.numOfCoroutine ?
+					 (uint8_t *)sCoroutinePro.psCoroutine[i + 1] : (uint8_t *)coroutineArena + sCoroutinePro.arenaUsed) -
+					(const uint8_t *)psCoroutine;
+		sLog.Printf("%d: frame %d bytes, %s at line %d, signal 0x%08lX wait 0x%08lX\n", i, frameSize,
+				psCoroutine->finished ? "finished" : "suspended", psCoroutine->resume,
+				(unsigned long)psCoroutine->signal, (unsigned long)psCoroutine->waitMask);
+	}
+	sLog.Printf("%lu resumes, average %lu max %lu cycles\n", (unsigned long)sCoroutinePro.resumeCount,
+			(unsigned long)(sCoroutinePro.resumeCount > 0 ? sCoroutinePro.totalCycle / sCoroutinePro.resumeCount : 0),
+			(unsigned long)sCoroutinePro.maximumCycle);
+}
+
+// Coroutine function structure
+const sCOROUTINE_RUNTIME sCoroutine =
+{
+	CoroutineCreate,
+	CoroutineSignal,
+	CoroutineRun,
+	CoroutineDelay,
+	CoroutineTake,
+	CoroutinePrint,
+};
@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * Filename:			crc.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Hardware CRC-32 function
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "crc.h"
+#include "lazy_init.h"
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static uint32_t CrcCalculate(const void *data, uint32_t numOfWord);
+
+/*******************************************************************************
+ * @fn      CrcCalculate
+ * @brief   CRC-32 (0x04C11DB7, initial 0xFFFFFFFF) of word aligned data
+ *          with CRC unit at reset configuration, safe from interrupt
+ * @param   data
+ *          numOfWord
+ * @return  CRC
+ ******************************************************************************/
+static uint32_t CrcCalculate(const void *data, uint32_t numOfWord)
+{
+	const uint32_t *word = data;
+	uint32_t primask = __get_PRIMASK();
+	uint32_t crc = 0;
+	uint32_t i = 0;
+
+	sLazyInit.Use(crcLazyPeripheral);
+	__disable_irq();
+	CRC->CR = CRC_CR_RESET;
+	for(i = 0; i < numOfWord; i++)
+	{
+		CRC->DR = word[i];
+	}
+	crc = CRC->DR;
+	__set_PRIMASK(primask);
+	return crc;
+}
+
+// CRC function structure
+const sCRC sCrc =
+{
+	CrcCalculate,
+};
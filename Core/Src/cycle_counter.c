@@ -0,0 +1,38 @@
+/*******************************************************************************
+ * Filename:			cycle_counter.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    DWT cycle counter function
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "cycle_counter.h"
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void CycleCounterEnable(void);
+
+/*******************************************************************************
+ * @fn      CycleCounterEnable
+ * @brief   Enable DWT cycle counter, safe to call more than once
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void CycleCounterEnable(void)
+{
+	if((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0)
+	{
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CYCCNT = 0;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+}
+
+// Cycle counter function structure
+const sCYCLE_COUNTER sCycleCounter =
+{
+	CycleCounterEnable,
+};
@@ -0,0 +1,155 @@
+/*******************************************************************************
+ * Filename:			event_flag.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Lock free event flags shared by interrupts and main loop
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "event_flag.h"
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+volatile uint32_t eventFlags[EVENT_FLAG_NUM_OF_WORD] = {0};
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void EventFlagSet(uint8_t flag);
+static void EventFlagClear(uint8_t flag);
+static uint64_t EventFlagFetchAndClearAll(void);
+static uint64_t EventFlagWaitAny(uint64_t mask);
+
+/*******************************************************************************
+ * @fn      EventFlagSet
+ * @brief   Set flag, interrupt and thread safe
+ * @param   flag	Below EVENT_FLAG_MAXIMUM, others are ignored
+ * @return  None
+ ******************************************************************************/
+static void EventFlagSet(uint8_t flag)
+{
+	volatile uint32_t *word = NULL;
+	uint32_t mask = (uint32_t)0x01 << (flag % 32);
+#if EVENT_FLAG_EXCLUSIVE
+	uint32_t value = 0;
+#endif
+
+	if(flag >= EVENT_FLAG_MAXIMUM)
+	{
+		return;
+	}
+	word = &eventFlags[flag / 32];
+#if EVENT_FLAG_EXCLUSIVE
+	do
+	{
+		value = __LDREXW(word);
+	}
+	while(__STREXW(value | mask, word) != 0);
+#else
+	__atomic_fetch_or(word, mask, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/*******************************************************************************
+ * @fn      EventFlagClear
+ * @brief   Clear flag, interrupt and thread safe
+ * @param   flag	Below EVENT_FLAG_MAXIMUM, others are ignored
+ * @return  None
+ ******************************************************************************/
+static void EventFlagClear(uint8_t flag)
+{
+	volatile uint32_t *word = NULL;
+	uint32_t mask = (uint32_t)0x01 << (flag % 32);
+#if EVENT_FLAG_EXCLUSIVE
+	uint32_t value = 0;
+#endif
+
+	if(flag >= EVENT_FLAG_MAXIMUM)
+	{
+		return;
+	}
+	word = &eventFlags[flag / 32];
+#if EVENT_FLAG_EXCLUSIVE
+	do
+	{
+		value = __LDREXW(word);
+	}
+	while(__STREXW(value & ~mask, word) != 0);
+#else
+	__atomic_fetch_and(word, ~mask, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/*******************************************************************************
+ * @fn      EventFlagFetchAndClearAll
+ * @brief   Take all raised flags with one swap per word, none set meanwhile
+ *          is lost. A flag set between the two swaps is taken by this call
+ *          or the next one
+ * @param   None
+ * @return  Raised flags, word 1 in upper half
+ ******************************************************************************/
+static uint64_t EventFlagFetchAndClearAll(void)
+{
+	uint64_t flags = 0;
+	uint8_t i = 0;
+#if EVENT_FLAG_EXCLUSIVE
+	uint32_t value = 0;
+#endif
+
+	for(i = 0; i < EVENT_FLAG_NUM_OF_WORD; i++)
+	{
+#if EVENT_FLAG_EXCLUSIVE
+		do
+		{
+			value = __LDREXW(&eventFlags[i]);
+		}
+		while(__STREXW(0, &eventFlags[i]) != 0);
+		flags |= (uint64_t)value << (i * 32);
+#else
+		flags |= (uint64_t)__atomic_exchange_n(&eventFlags[i], 0, __ATOMIC_SEQ_CST) << (i * 32);
+#endif
+	}
+	return flags;
+}
+
+/*******************************************************************************
+ * @fn      EventFlagRead
+ * @brief   Both words, not a snapshot of one instant
+ * @param   None
+ * @return  Raised flags, word 1 in upper half
+ ******************************************************************************/
+static inline uint64_t EventFlagRead(void)
+{
+	return ((uint64_t)eventFlags[1] << 32) | eventFlags[0];
+}
+
+/*******************************************************************************
+ * @fn      EventFlagWaitAny
+ * @brief   Sleep until one of the flags is raised, flags are not cleared.
+ *          An interrupt between test and WFE sets the event register, so
+ *          WFE returns at once instead of missing the flag
+ * @param   mask
+ * @return  Raised flags of mask
+ ******************************************************************************/
+static uint64_t EventFlagWaitAny(uint64_t mask)
+{
+	uint64_t value = 0;
+
+	while((value = EventFlagRead() & mask) == 0)
+	{
+		__WFE();
+	}
+	return value;
+}
+
+// Event flag function structure
+const sEVENT_FLAG sEventFlag =
+{
+	EventFlagSet,
+	EventFlagClear,
+	EventFlagFetchAndClearAll,
+	EventFlagWaitAny,
+};
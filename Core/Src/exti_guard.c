@@ -0,0 +1,185 @@
+/*******************************************************************************
+ * Filename:			exti_guard.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    EXTI interrupt storm protection function
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "exti_guard.h"
+#include "software_timer.h"
+#include "latency_trace.h"
+#include "gpio.h"
+#include "log.h"
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define EXTI guard property structure
+typedef struct
+{
+	uint8_t timerId;
+	volatile uint32_t edgeCount[maximumDebounceInput];
+	uint16_t stableTick[maximumDebounceInput];
+	GPIO_PinState lastLevel[maximumDebounceInput];
+	sEXTI_GUARD_COUNTER sCounter[maximumDebounceInput];
+}
+sEXTI_GUARD_PRO;
+static sEXTI_GUARD_PRO sExtiGuardPro;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void ExtiGuardInitialize(void);
+static bool ExtiGuardEdge(eDEBOUNCE_INPUT eInput);
+static void ExtiGuardGetCounter(eDEBOUNCE_INPUT eInput, sEXTI_GUARD_COUNTER *psCounter);
+static void ExtiGuardPrint(void);
+
+/*******************************************************************************
+ * @fn      ExtiGuardPoll
+ * @brief   Sample a masked line, post event on stable low level and unmask
+ *          after quiet period
+ * @param   eInput
+ * @return  None
+ ******************************************************************************/
+static void ExtiGuardPoll(eDEBOUNCE_INPUT eInput)
+{
+	const sDEBOUNCE_INPUT *psInput = &sDebounceInput[eInput];
+	GPIO_PinState level = HAL_GPIO_ReadPin(psInput->port, psInput->gpioPin);
+
+	if(level != sExtiGuardPro.lastLevel[eInput])
+	{
+		sExtiGuardPro.lastLevel[eInput] = level;
+		sExtiGuardPro.stableTick[eInput] = 0;
+		return;
+	}
+	if(sExtiGuardPro.stableTick[eInput] < UINT16_MAX)
+	{
+		sExtiGuardPro.stableTick[eInput]++;
+	}
+
+	if(level == GPIO_PIN_RESET && sExtiGuardPro.stableTick[eInput] == EXTI_GUARD_DEBOUNCE_TICK)
+	{
+		sExtiGuardPro.sCounter[eInput].polledEventCount++;
+		sLatencyTrace.Stamp(eInput, debounceLatencyStage);
+		sEventFlag.Set(psInput->eEventFlag);
+	}
+	else if(level == GPIO_PIN_SET && sExtiGuardPro.stableTick[eInput] >= EXTI_GUARD_QUIET_TICK)
+	{
+		// Line quiet, drop edges latched while masked and go back to interrupt
+		sExtiGuardPro.sCounter[eInput].polling = false;
+		sExtiGuardPro.sCounter[eInput].recoverCount++;
+		sExtiGuardPro.edgeCount[eInput] = 0;
+		EXTI->PR1 = psInput->gpioPin;
+		EXTI->IMR1 |= psInput->gpioPin;
+	}
+}
+
+/*******************************************************************************
+ * @fn      ExtiGuardTimerCallback
+ * @brief   Guard tick, close edge rate window and sample masked lines
+ * @param   softwareTimerId
+ *          arg
+ * @return  None
+ ******************************************************************************/
+static void ExtiGuardTimerCallback(uint8_t softwareTimerId, void *arg)
+{
+	uint8_t i = 0;
+	uint32_t edgeRate = 0;
+
+	for(i = 0; i < maximumDebounceInput; i++)
+	{
+		edgeRate = sExtiGuardPro.edgeCount[i];
+		sExtiGuardPro.edgeCount[i] = 0;
+		if(edgeRate > sExtiGuardPro.sCounter[i].maximumEdgeRate)
+		{
+			sExtiGuardPro.sCounter[i].maximumEdgeRate = edgeRate;
+		}
+		if(sExtiGuardPro.sCounter[i].polling)
+		{
+			ExtiGuardPoll(i);
+		}
+	}
+}
+
+/*******************************************************************************
+ * @fn      ExtiGuardInitialize
+ * @brief   Start guard tick, call after debounce timers are allocated
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ExtiGuardInitialize(void)
+{
+	sExtiGuardPro.timerId = sSoftwareTimer.Initialize(NULL, ExtiGuardTimerCallback, NULL, TIMER_PERIODIC_TYPE, NULL);
+	sSoftwareTimer.Start(sExtiGuardPro.timerId, EXTI_GUARD_PERIOD);
+}
+
+/*******************************************************************************
+ * @fn      ExtiGuardEdge
+ * @brief   Count an edge, mask the line when edge rate exceeds threshold
+ * @param   eInput
+ * @return  true	Edge accepted, restart debounce
+ *          false	Line switched to polling, stop debounce
+ ******************************************************************************/
+static bool ExtiGuardEdge(eDEBOUNCE_INPUT eInput)
+{
+	const sDEBOUNCE_INPUT *psInput = &sDebounceInput[eInput];
+
+	if(++sExtiGuardPro.edgeCount[eInput] <= EXTI_GUARD_THRESHOLD)
+	{
+		return true;
+	}
+	EXTI->IMR1 &= ~((uint32_t)psInput->gpioPin);
+	EXTI->PR1 = psInput->gpioPin;
+	sExtiGuardPro.lastLevel[eInput] = HAL_GPIO_ReadPin(psInput->port, psInput->gpioPin);
+	sExtiGuardPro.stableTick[eInput] = 0;
+	sExtiGuardPro.sCounter[eInput].polling = true;
+	sExtiGuardPro.sCounter[eInput].stormCount++;
+	return false;
+}
+
+/*******************************************************************************
+ * @fn      ExtiGuardGetCounter
+ * @brief   Copy storm counters of an input
+ * @param   eInput
+ *          psCounter
+ * @return  None
+ ******************************************************************************/
+static void ExtiGuardGetCounter(eDEBOUNCE_INPUT eInput, sEXTI_GUARD_COUNTER *psCounter)
+{
+	__disable_irq();
+	*psCounter = sExtiGuardPro.sCounter[eInput];
+	__enable_irq();
+}
+
+/*******************************************************************************
+ * @fn      ExtiGuardPrint
+ * @brief   Print storm counters
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ExtiGuardPrint(void)
+{
+	sEXTI_GUARD_COUNTER sCounter;
+	uint8_t i = 0;
+
+	for(i = 0; i < maximumDebounceInput; i++)
+	{
+		ExtiGuardGetCounter(i, &sCounter);
+		sLog.Printf("%-6s: %s storm %lu recover %lu polled %lu max edge %lu/%dms\n", sDebounceInput[i].name,
+				sCounter.polling ? "polling" : "interrupt", (unsigned long)sCounter.stormCount,
+				(unsigned long)sCounter.recoverCount, (unsigned long)sCounter.polledEventCount,
+				(unsigned long)sCounter.maximumEdgeRate, EXTI_GUARD_PERIOD);
+	}
+}
+
+// EXTI guard function structure
+const sEXTI_GUARD sExtiGuard =
+{
+	ExtiGuardInitialize,
+	ExtiGuardEdge,
+	ExtiGuardGetCounter,
+	ExtiGuardPrint,
+};
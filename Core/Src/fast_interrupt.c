@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * Filename:			fast_interrupt.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Direct register interrupt dispatch for TIM6 and EXTI
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "fast_interrupt.h"
+#include "log.h"
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+volatile uint32_t fastInterruptEntryCycle = 0;
+sFAST_INTERRUPT_LATENCY sFastInterruptLatency[maximumFastInterrupt];
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void FastInterruptResetLatency(void);
+static void FastInterruptPrintLatency(void);
+
+/*******************************************************************************
+ * @fn      FastInterruptResetLatency
+ * @brief   Clear latency statistic
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void FastInterruptResetLatency(void)
+{
+	__disable_irq();
+	memset(sFastInterruptLatency, 0, sizeof(sFastInterruptLatency));
+	__enable_irq();
+}
+
+/*******************************************************************************
+ * @fn      FastInterruptPrintLatency
+ * @brief   Print entry-to-callback latency in cycles
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void FastInterruptPrintLatency(void)
+{
+	static const char *name[maximumFastInterrupt] = {"TIM6", "EXTI"};
+	sFAST_INTERRUPT_LATENCY sLatency;
+	uint8_t i = 0;
+
+	for(i = 0; i < maximumFastInterrupt; i++)
+	{
+		__disable_irq();
+		sLatency = sFastInterruptLatency[i];
+		__enable_irq();
+		sLog.Printf("%s %s path: count %lu last %lu min %lu max %lu cycles\n", name[i],
+				FAST_INTERRUPT_ENABLE ? "fast" : "HAL", (unsigned long)sLatency.count,
+				(unsigned long)sLatency.last, (unsigned long)sLatency.minimum,
+				(unsigned long)sLatency.maximum);
+	}
+}
+
+// Fast interrupt function structure
+const sFAST_INTERRUPT sFastInterrupt =
+{
+	FastInterruptResetLatency,
+	FastInterruptPrintLatency,
+};
@@ -0,0 +1,358 @@
+/*******************************************************************************
+ * Filename:			fault_capture.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Fault record kept in RAM over reset
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "fault_capture.h"
+#include "software_timer.h"
+#include "crc.h"
+#include "log.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define FAULT_MAGIC					0x4C554146
+// EXC_RETURN bit 4: frame without FPU registers
+#define FAULT_EXC_RETURN_BASIC		0x10
+// Stacked xPSR bit 9: one padding word to align frame
+#define FAULT_XPSR_ALIGN			(0x01 << 9)
+#define FAULT_BASIC_FRAME_SIZE		(8 * sizeof(uint32_t))
+#define FAULT_FPU_FRAME_SIZE		(26 * sizeof(uint32_t))
+// Repeated in HardFault_Handler asm
+#define FAULT_STACK_SIZE			256
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define fault capture property structure
+typedef struct
+{
+	uint8_t stableTimerId;
+	bool resetByException;			// This boot follows an exception record
+}
+sFAULT_CAPTURE_PRO;
+static sFAULT_CAPTURE_PRO sFaultCapturePro;
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static sFAULT_RECORD sFaultRecord NOINIT;
+// Handler runs here, faulting stack may be overflowed
+static uint64_t faultStack[FAULT_STACK_SIZE / sizeof(uint64_t)] __attribute__((used));
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void FaultCaptureInitialize(void);
+static void FaultCaptureError(uint32_t caller) __attribute__((noreturn));
+static void FaultCapturePrint(void);
+static void FaultCaptureClear(void);
+static void FaultCaptureTest(void);
+static bool FaultCaptureResetByException(void);
+
+/*******************************************************************************
+ * @fn      FaultCaptureValid
+ * @brief   Record in .noinit is complete
+ * @param   None
+ * @return  true: valid
+ ******************************************************************************/
+static bool FaultCaptureValid(void)
+{
+	return sFaultRecord.magic == FAULT_MAGIC &&
+		   sFaultRecord.eFaultSource <= errorHandlerFaultSource &&
+		   sFaultRecord.stackLength <= FAULT_STACK_WORD &&
+		   sFaultRecord.logLength <= FAULT_LOG_SIZE &&
+		   sFaultRecord.crc == sCrc.Calculate(&sFaultRecord, offsetof(sFAULT_RECORD, crc) / sizeof(uint32_t));
+}
+
+/*******************************************************************************
+ * @fn      FaultCaptureSave
+ * @brief   Fill record from stacked frame, fault status and log tail
+ * @param   eFaultSource
+ *          frame			r0 r1 r2 r3 r12 lr pc xpsr
+ *          excReturn
+ * @return  None
+ ******************************************************************************/
+static void FaultCaptureSave(eFAULT_SOURCE eFaultSource, const uint32_t *frame, uint32_t excReturn)
+{
+	uint32_t address = (uint32_t)frame;
+	uint32_t resetCount = 0;
+	bool stacked = false;
+	uint32_t i = 0;
+
+	__disable_irq();
+	// Previous fault reset not yet followed by a stable run
+	resetCount = FaultCaptureValid() ? sFaultRecord.resetCount : 0;
+	memset(&sFaultRecord, 0, sizeof(sFaultRecord));
+	sFaultRecord.magic = FAULT_MAGIC;
+	sFaultRecord.eFaultSource = eFaultSource;
+	sFaultRecord.ipsr = __get_IPSR();
+	sFaultRecord.excReturn = excReturn;
+
+	// Stacking may have failed, e.g. into stack guard. Frame and stack are
+	// read only inside SRAM1 and when it was stacked
+	stacked = (address & 0x03) == 0 && address >= SRAM1_BASE &&
+			  address <= SRAM1_BASE + SRAM1_SIZE_MAX - FAULT_BASIC_FRAME_SIZE &&
+			  (SCB->CFSR & (SCB_CFSR_MSTKERR_Msk | SCB_CFSR_STKERR_Msk)) == 0;
+	if(stacked)
+	{
+		memcpy(sFaultRecord.frame, frame, sizeof(sFaultRecord.frame));
+	}
+	if(eFaultSource == errorHandlerFaultSource)
+	{
+		sFaultRecord.stackPointer = __get_MSP();
+	}
+	else
+	{
+		sFaultRecord.stackPointer = address +
+			((excReturn & FAULT_EXC_RETURN_BASIC) ? FAULT_BASIC_FRAME_SIZE : FAULT_FPU_FRAME_SIZE) +
+			((sFaultRecord.frame[7] & FAULT_XPSR_ALIGN) ? sizeof(uint32_t) : 0);
+	}
+
+	// Stack grows down, words above stack pointer hold callers' return
+	// addresses
+	for(i = 0; stacked && i < FAULT_STACK_WORD &&
+			   sFaultRecord.stackPointer + (i + 1) * sizeof(uint32_t) <= SRAM1_BASE + SRAM1_SIZE_MAX; i++)
+	{
+		sFaultRecord.stack[i] = ((const uint32_t *)sFaultRecord.stackPointer)[i];
+	}
+	sFaultRecord.stackLength = i;
+
+	sFaultRecord.cfsr = SCB->CFSR;
+	sFaultRecord.hfsr = SCB->HFSR;
+	sFaultRecord.mmfar = SCB->MMFAR;
+	sFaultRecord.bfar = SCB->BFAR;
+	sFaultRecord.logLength = sLog.Tail(sFaultRecord.log, sizeof(sFaultRecord.log));
+	sFaultRecord.crc = sCrc.Calculate(&sFaultRecord, offsetof(sFAULT_RECORD, crc) / sizeof(uint32_t));
+	sFaultRecord.resetCount = resetCount + 1;
+}
+
+/*******************************************************************************
+ * @fn      FaultCaptureReset
+ * @brief   Reset after saved record. A fault that comes back after every
+ *          reset halts the device with record kept for debugger instead
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void __attribute__((noreturn)) FaultCaptureReset(void)
+{
+	if(sFaultRecord.resetCount >= FAULT_RESET_LIMIT)
+	{
+		for(;;)
+		{
+			__WFI();
+		}
+	}
+	NVIC_SystemReset();
+}
+
+/*******************************************************************************
+ * @fn      FaultCaptureException
+ * @brief   Save record and reset, entered from fault handler on fault stack
+ * @param   frame
+ *          excReturn
+ * @return  None
+ ******************************************************************************/
+static void __attribute__((used, noreturn)) FaultCaptureException(const uint32_t *frame, uint32_t excReturn)
+{
+	FaultCaptureSave(exceptionFaultSource, frame, excReturn);
+	FaultCaptureReset();
+}
+
+/*******************************************************************************
+ * @fn      FaultCaptureStableTimerCallback
+ * @brief   Device ran long enough after fault reset, series of fault resets
+ *          ends
+ * @param   softwareTimerId
+ *          arg
+ * @return  None
+ ******************************************************************************/
+static void FaultCaptureStableTimerCallback(uint8_t softwareTimerId, void *arg)
+{
+	sFaultRecord.resetCount = 0;
+}
+
+/*******************************************************************************
+ * @fn      FaultCaptureInitialize
+ * @brief   Give MemManage, BusFault and UsageFault their handler instead of
+ *          escalating to HardFault, dump record left by last reset
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void FaultCaptureInitialize(void)
+{
+	SCB->SHCSR |= SCB_SHCSR_USGFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_MEMFAULTENA_Msk;
+
+	if(!FaultCaptureValid())
+	{
+		return;
+	}
+	if(sFaultRecord.reported != FAULT_MAGIC)
+	{
+		sLog.Printf("Reset by fault, %lu in a row\n", (unsigned long)sFaultRecord.resetCount);
+		FaultCapturePrint();
+		sFaultRecord.reported = FAULT_MAGIC;
+		sFaultCapturePro.resetByException = sFaultRecord.eFaultSource == exceptionFaultSource;
+	}
+	sFaultCapturePro.stableTimerId = sSoftwareTimer.Initialize(NULL, FaultCaptureStableTimerCallback, NULL,
+															   TIMER_ONCE_TYPE, NULL);
+	sSoftwareTimer.Start(sFaultCapturePro.stableTimerId, FAULT_STABLE_PERIOD);
+}
+
+/*******************************************************************************
+ * @fn      FaultCaptureError
+ * @brief   Save record for Error_Handler and reset
+ * @param   caller	Return address into function that failed
+ * @return  None
+ ******************************************************************************/
+static void FaultCaptureError(uint32_t caller)
+{
+	uint32_t frame[8] = {0};
+
+	frame[6] = caller;
+	frame[7] = __get_xPSR();
+	FaultCaptureSave(errorHandlerFaultSource, frame, 0);
+	FaultCaptureReset();
+}
+
+/*******************************************************************************
+ * @fn      FaultCapturePrint
+ * @brief   Print record, host/tool/fault_symbolize turns it into a
+ *          backtrace with the ELF
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void FaultCapturePrint(void)
+{
+	static const char *const cfsrName[32] =
+	{
+		[0] = "IACCVIOL", [1] = "DACCVIOL", [3] = "MUNSTKERR", [4] = "MSTKERR",
+		[5] = "MLSPERR", [7] = "MMARVALID", [8] = "IBUSERR", [9] = "PRECISERR",
+		[10] = "IMPRECISERR", [11] = "UNSTKERR", [12] = "STKERR", [13] = "LSPERR",
+		[15] = "BFARVALID", [16] = "UNDEFINSTR", [17] = "INVSTATE", [18] = "INVPC",
+		[19] = "NOCP", [24] = "UNALIGNED", [25] = "DIVBYZERO",
+	};
+	static const char *const sourceName[] = {"exception", "Error_Handler"};
+	const uint32_t *frame = sFaultRecord.frame;
+	uint8_t i = 0;
+
+	if(!FaultCaptureValid())
+	{
+		sLog.Printf("No fault record\n");
+		return;
+	}
+	sLog.Printf("Fault %s %lu, exc_return 0x%08lX, %lu of %d resets in a row\n", sourceName[sFaultRecord.eFaultSource],
+			(unsigned long)sFaultRecord.ipsr, (unsigned long)sFaultRecord.excReturn,
+			(unsigned long)sFaultRecord.resetCount, FAULT_RESET_LIMIT);
+	sLog.Printf("pc 0x%08lX lr 0x%08lX xpsr 0x%08lX sp 0x%08lX\n", (unsigned long)frame[6],
+			(unsigned long)frame[5], (unsigned long)frame[7], (unsigned long)sFaultRecord.stackPointer);
+	sLog.Printf("r0 0x%08lX r1 0x%08lX r2 0x%08lX r3 0x%08lX r12 0x%08lX\n", (unsigned long)frame[0],
+			(unsigned long)frame[1], (unsigned long)frame[2], (unsigned long)frame[3], (unsigned long)frame[4]);
+	sLog.Printf("cfsr 0x%08lX hfsr 0x%08lX mmfar 0x%08lX bfar 0x%08lX\n", (unsigned long)sFaultRecord.cfsr,
+			(unsigned long)sFaultRecord.hfsr, (unsigned long)sFaultRecord.mmfar, (unsigned long)sFaultRecord.bfar);
+	for(i = 0; i < 32; i++)
+	{
+		if((sFaultRecord.cfsr >> i) & 0x01 && cfsrName[i] != NULL)
+		{
+			sLog.Printf("%s ", cfsrName[i]);
+		}
+	}
+	if(sFaultRecord.hfsr & SCB_HFSR_FORCED_Msk)
+	{
+		sLog.Printf("FORCED ");
+	}
+	for(i = 0; i < sFaultRecord.stackLength; i++)
+	{
+		if(i % 8 == 0)
+		{
+			sLog.Printf("\nstack 0x%08lX:", (unsigned long)(sFaultRecord.stackPointer + i * sizeof(uint32_t)));
+		}
+		sLog.Printf(" 0x%08lX", (unsigned long)sFaultRecord.stack[i]);
+	}
+	sLog.Printf("\nLog tail:\n");
+	sLog.Write(sFaultRecord.log, sFaultRecord.logLength);
+	sLog.Printf("\n");
+}
+
+/*******************************************************************************
+ * @fn      FaultCaptureClear
+ * @brief   Drop record
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void FaultCaptureClear(void)
+{
+	sFaultRecord.magic = 0;
+}
+
+/*******************************************************************************
+ * @fn      FaultCaptureTest
+ * @brief   Execute undefined instruction, UsageFault saves record and resets
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void FaultCaptureTest(void)
+{
+	__asm volatile("udf #0");
+}
+
+/*******************************************************************************
+ * @fn      FaultCaptureResetByException
+ * @brief   Last reset came from a fault exception, RAM state kept over it
+ *          may be what faulted
+ * @param   None
+ * @return  true
+ *          false
+ ******************************************************************************/
+static bool FaultCaptureResetByException(void)
+{
+	return sFaultCapturePro.resetByException;
+}
+
+/*******************************************************************************
+ * INTERRUPT CALLBACK
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      HardFault_Handler
+ * @brief   Take frame from stack in use at fault, move to fault stack so an
+ *          overflowed stack does not fault again, then save record
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+void __attribute__((naked)) HardFault_Handler(void)
+{
+	__asm volatile
+	(
+		// EXC_RETURN bit 2: frame on PSP
+		"tst lr, #4								\n"
+		"ite eq									\n"
+		"mrseq r0, msp							\n"
+		"mrsne r0, psp							\n"
+		"mov r1, lr								\n"
+		"movw r2, #:lower16:faultStack + 256	\n"
+		"movt r2, #:upper16:faultStack + 256	\n"
+		"mov sp, r2								\n"
+		"b FaultCaptureException				\n"
+	);
+}
+
+// Configurable faults share the path, IPSR tells them apart
+void MemManage_Handler(void) __attribute__((alias("HardFault_Handler")));
+void BusFault_Handler(void) __attribute__((alias("HardFault_Handler")));
+void UsageFault_Handler(void) __attribute__((alias("HardFault_Handler")));
+
+// Fault capture function structure
+const sFAULT_CAPTURE sFaultCapture =
+{
+	FaultCaptureInitialize,
+	FaultCaptureError,
+	FaultCapturePrint,
+	FaultCaptureClear,
+	FaultCaptureTest,
+	FaultCaptureResetByException,
+};
@@ -0,0 +1,499 @@
+/*******************************************************************************
+ * Filename:			flash_journal.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Wear leveled flash journal for credit and audit counters
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "flash_journal.h"
+#include "cycle_counter.h"
+#include "main_loop.h"
+#include "lazy_init.h"
+
+/*******************************************************************************
+ * EXTERNAL VARIABLES
+ ******************************************************************************/
+// Journal pages reserved by linker script at the top of bank 2, so
+// programming never stalls code fetch from bank 1
+extern uint32_t _sjournal;
+extern uint32_t _ejournal;
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define JOURNAL_START			((uint32_t)&_sjournal)
+#define JOURNAL_NUM_OF_PAGE		((((uint32_t)&_ejournal) - JOURNAL_START) / FLASH_PAGE_SIZE)
+#define JOURNAL_NUM_OF_SLOT		(FLASH_PAGE_SIZE / sizeof(uint64_t))
+// Slot 0 of every page holds the page header, slot 1 its vend epoch
+#define JOURNAL_EPOCH_SLOT		1
+#define JOURNAL_FIRST_SLOT		2
+// lifetimeVend bits kept in every record, the rest is the page epoch
+#define JOURNAL_EPOCH_SHIFT		16
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Flash operation in flight
+typedef enum
+{
+	noneJournalOperation = 0,
+	eraseJournalOperation,
+	epochJournalOperation,
+	headerJournalOperation,
+	recordJournalOperation,
+}
+eJOURNAL_OPERATION;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Record as programmed, one double word
+typedef struct
+{
+	uint32_t lifetimeCoin;
+	uint16_t lifetimeVend;		// Below JOURNAL_EPOCH_SHIFT, rest is page epoch
+	uint8_t totalCoin;
+	uint8_t check;				// Inverted byte sum, erased record never valid
+}
+sJOURNAL_SLOT;
+
+// Define flash journal property structure
+typedef struct
+{
+	uint32_t page;
+	uint32_t sequence;
+	uint32_t epoch;				// Vend epoch of the newest page
+	uint32_t nextSlot;
+	bool mounted;
+	bool epochPending;
+	bool headerPending;
+	volatile eJOURNAL_OPERATION eOperation;
+	volatile bool recordPending;
+	sFLASH_JOURNAL_RECORD sRecord;
+	sFLASH_JOURNAL_STATISTIC sStatistic;
+}
+sFLASH_JOURNAL_PRO;
+static sFLASH_JOURNAL_PRO sFlashJournalPro;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static bool FlashJournalMount(sFLASH_JOURNAL_RECORD *psRecord);
+static void FlashJournalWrite(const sFLASH_JOURNAL_RECORD *psRecord);
+static void FlashJournalProcess(void);
+static void FlashJournalGetStatistic(sFLASH_JOURNAL_STATISTIC *psStatistic);
+
+/*******************************************************************************
+ * @fn      FlashJournalSlot
+ * @brief   Address of a slot
+ * @param   page
+ *          slot
+ * @return  Pointer to slot
+ ******************************************************************************/
+static const uint32_t *FlashJournalSlot(uint32_t page, uint32_t slot)
+{
+	return (const uint32_t *)(JOURNAL_START + page * FLASH_PAGE_SIZE + slot * sizeof(uint64_t));
+}
+
+/*******************************************************************************
+ * @fn      FlashJournalCheck
+ * @brief   Inverted sum of all slot bytes except check
+ * @param   psSlot
+ * @return  Check byte
+ ******************************************************************************/
+static uint8_t FlashJournalCheck(const sJOURNAL_SLOT *psSlot)
+{
+	const uint8_t *byte = (const uint8_t *)psSlot;
+	uint8_t sum = 0;
+	uint8_t i = 0;
+
+	for(i = 0; i < sizeof(sJOURNAL_SLOT) - 1; i++)
+	{
+		sum += byte[i];
+	}
+	return ~sum;
+}
+
+/*******************************************************************************
+ * @fn      FlashJournalEpoch
+ * @brief   Vend epoch of a record
+ * @param   psRecord
+ * @return  lifetimeVend above JOURNAL_EPOCH_SHIFT
+ ******************************************************************************/
+static uint32_t FlashJournalEpoch(const sFLASH_JOURNAL_RECORD *psRecord)
+{
+	return psRecord->lifetimeVend >> JOURNAL_EPOCH_SHIFT;
+}
+
+/*******************************************************************************
+ * @fn      FlashJournalErased
+ * @brief   Slot is still erased
+ * @param   page
+ *          slot
+ * @return  true
+ *          false
+ ******************************************************************************/
+static bool FlashJournalErased(uint32_t page, uint32_t slot)
+{
+	const uint32_t *word = FlashJournalSlot(page, slot);
+
+	return word[0] == 0xFFFFFFFF && word[1] == 0xFFFFFFFF;
+}
+
+/*******************************************************************************
+ * @fn      FlashJournalLastRecord
+ * @brief   Binary search first erased slot of a page, then step back over
+ *          a record torn by reset. Vend is joined with the page epoch
+ * @param   page
+ *          psRecord	Last valid record
+ *          pFound		Valid record found
+ * @return  First erased slot
+ ******************************************************************************/
+static uint32_t FlashJournalLastRecord(uint32_t page, sFLASH_JOURNAL_RECORD *psRecord, bool *pFound)
+{
+	sJOURNAL_SLOT sSlot;
+	uint32_t low = JOURNAL_FIRST_SLOT;
+	uint32_t high = JOURNAL_NUM_OF_SLOT;
+	uint32_t middle = 0;
+	uint32_t slot = 0;
+
+	// Records are appended in order, programmed slots come before erased ones
+	while(low < high)
+	{
+		middle = (low + high) / 2;
+		if(FlashJournalErased(page, middle))
+		{
+			high = middle;
+		}
+		else
+		{
+			low = middle + 1;
+		}
+	}
+
+	*pFound = false;
+	for(slot = low; slot > JOURNAL_FIRST_SLOT; slot--)
+	{
+		memcpy(&sSlot, FlashJournalSlot(page, slot - 1), sizeof(sSlot));
+		if(sSlot.check == FlashJournalCheck(&sSlot))
+		{
+			psRecord->lifetimeCoin = sSlot.lifetimeCoin;
+			psRecord->lifetimeVend = (FlashJournalSlot(page, JOURNAL_EPOCH_SLOT)[0] << JOURNAL_EPOCH_SHIFT) |
+					sSlot.lifetimeVend;
+			psRecord->totalCoin = sSlot.totalCoin;
+			*pFound = true;
+			break;
+		}
+	}
+	return low;
+}
+
+/*******************************************************************************
+ * @fn      FlashJournalLocate
+ * @brief   Find newest page by header sequence and its last valid record.
+ *          Only page state is set, a queued record is kept
+ * @param   psRecord
+ * @return  true	Record found
+ *          false	Journal empty
+ ******************************************************************************/
+static bool FlashJournalLocate(sFLASH_JOURNAL_RECORD *psRecord)
+{
+	uint32_t startCycle = CYCLE_COUNTER_READ();
+	const uint32_t *header = NULL;
+	uint32_t page = 0;
+	uint32_t previousPage = 0;
+	bool found = false;
+	bool valid = false;
+
+	sFlashJournalPro.sequence = 0;
+	// Empty journal, first write rotates to page 0
+	sFlashJournalPro.page = JOURNAL_NUM_OF_PAGE - 1;
+	sFlashJournalPro.nextSlot = JOURNAL_NUM_OF_SLOT;
+
+	for(page = 0; page < JOURNAL_NUM_OF_PAGE; page++)
+	{
+		header = FlashJournalSlot(page, 0);
+		if(header[0] == FLASH_JOURNAL_MAGIC && (!found || (int32_t)(header[1] - sFlashJournalPro.sequence) > 0))
+		{
+			found = true;
+			sFlashJournalPro.page = page;
+			sFlashJournalPro.sequence = header[1];
+		}
+	}
+	// Header is programmed after the epoch, a page with header has both
+	sFlashJournalPro.epoch = found ? FlashJournalSlot(sFlashJournalPro.page, JOURNAL_EPOCH_SLOT)[0] : 0;
+
+	if(found)
+	{
+		sFlashJournalPro.nextSlot = FlashJournalLastRecord(sFlashJournalPro.page, psRecord, &valid);
+		// Reset between page rotation and its first record
+		previousPage = (sFlashJournalPro.page + JOURNAL_NUM_OF_PAGE - 1) % JOURNAL_NUM_OF_PAGE;
+		header = FlashJournalSlot(previousPage, 0);
+		if(!valid && header[0] == FLASH_JOURNAL_MAGIC && header[1] == sFlashJournalPro.sequence - 1)
+		{
+			FlashJournalLastRecord(previousPage, psRecord, &valid);
+		}
+	}
+
+	sFlashJournalPro.mounted = true;
+	sFlashJournalPro.sStatistic.mountCycle = CYCLE_COUNTER_READ() - startCycle;
+	return valid;
+}
+
+/*******************************************************************************
+ * @fn      FlashJournalMount
+ * @brief   Reset journal state and read the newest record. Without Mount,
+ *          e.g. on warm restart, the first Process finds the newest page
+ * @param   psRecord
+ * @return  true	Record found
+ *          false	Journal empty
+ ******************************************************************************/
+static bool FlashJournalMount(sFLASH_JOURNAL_RECORD *psRecord)
+{
+	memset(&sFlashJournalPro, 0, sizeof(sFlashJournalPro));
+	return FlashJournalLocate(psRecord);
+}
+
+/*******************************************************************************
+ * @fn      FlashJournalWrite
+ * @brief   Queue record, only the newest queued record is programmed.
+ *          Safe from interrupt, flash work runs in main loop
+ * @param   psRecord
+ * @return  None
+ ******************************************************************************/
+static void FlashJournalWrite(const sFLASH_JOURNAL_RECORD *psRecord)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	sFlashJournalPro.sRecord = *psRecord;
+	sFlashJournalPro.recordPending = true;
+	__set_PRIMASK(primask);
+	sEventFlag.Set(flashJournalEventFlag);
+}
+
+/*******************************************************************************
+ * @fn      FlashJournalRetry
+ * @brief   HAL refused to start operation, journal state is unchanged and
+ *          main loop tries again
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void FlashJournalRetry(void)
+{
+	sFlashJournalPro.sStatistic.errorCount++;
+	sEventFlag.Set(flashJournalEventFlag);
+}
+
+/*******************************************************************************
+ * @fn      FlashJournalProcess
+ * @brief   Start next flash operation with interrupt, never waits. Journal
+ *          state moves on only once HAL has started the operation, with
+ *          interrupts masked so the end of operation callback sees it
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void FlashJournalProcess(void)
+{
+	FLASH_EraseInitTypeDef sEraseInit = {0};
+	sFLASH_JOURNAL_RECORD sRecord;
+	sJOURNAL_SLOT sSlot;
+	uint32_t primask = 0;
+	uint32_t address = 0;
+	uint32_t page = 0;
+	uint64_t data = 0;
+	bool started = false;
+
+	if(sFlashJournalPro.eOperation != noneJournalOperation)
+	{
+		return;
+	}
+	if(!sFlashJournalPro.headerPending && !sFlashJournalPro.recordPending)
+	{
+		HAL_FLASH_Lock();
+		return;
+	}
+
+	// Mount skipped at start, page is found on the first write
+	if(!sFlashJournalPro.mounted)
+	{
+		FlashJournalLocate(&sRecord);
+	}
+
+	sLazyInit.Use(flashLazyPeripheral);
+	HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+	// Page full or vend epoch moved on, erase the oldest page and make it newest
+	if(!sFlashJournalPro.headerPending && (sFlashJournalPro.nextSlot >= JOURNAL_NUM_OF_SLOT ||
+			FlashJournalEpoch(&sFlashJournalPro.sRecord) != sFlashJournalPro.epoch))
+	{
+		page = (sFlashJournalPro.page + 1) % JOURNAL_NUM_OF_PAGE;
+		address = (uint32_t)FlashJournalSlot(page, 0);
+		sEraseInit.TypeErase = FLASH_TYPEERASE_PAGES;
+		sEraseInit.Banks = (address - FLASH_BASE) < FLASH_BANK_SIZE ? FLASH_BANK_1 : FLASH_BANK_2;
+		sEraseInit.Page = ((address - FLASH_BASE) % FLASH_BANK_SIZE) / FLASH_PAGE_SIZE;
+		sEraseInit.NbPages = 1;
+
+		primask = __get_PRIMASK();
+		__disable_irq();
+		started = HAL_FLASHEx_Erase_IT(&sEraseInit) == HAL_OK;
+		if(started)
+		{
+			sFlashJournalPro.page = page;
+			sFlashJournalPro.sequence++;
+			sFlashJournalPro.epoch = FlashJournalEpoch(&sFlashJournalPro.sRecord);
+			sFlashJournalPro.nextSlot = JOURNAL_FIRST_SLOT;
+			sFlashJournalPro.epochPending = true;
+			sFlashJournalPro.headerPending = true;
+			sFlashJournalPro.eOperation = eraseJournalOperation;
+		}
+		__set_PRIMASK(primask);
+	}
+	// Epoch before header, mount never finds a header without its epoch
+	else if(sFlashJournalPro.epochPending)
+	{
+		address = (uint32_t)FlashJournalSlot(sFlashJournalPro.page, JOURNAL_EPOCH_SLOT);
+		data = sFlashJournalPro.epoch;
+
+		primask = __get_PRIMASK();
+		__disable_irq();
+		started = HAL_FLASH_Program_IT(FLASH_TYPEPROGRAM_DOUBLEWORD, address, data) == HAL_OK;
+		if(started)
+		{
+			sFlashJournalPro.eOperation = epochJournalOperation;
+		}
+		__set_PRIMASK(primask);
+	}
+	else if(sFlashJournalPro.headerPending)
+	{
+		address = (uint32_t)FlashJournalSlot(sFlashJournalPro.page, 0);
+		data = ((uint64_t)sFlashJournalPro.sequence << 32) | FLASH_JOURNAL_MAGIC;
+
+		primask = __get_PRIMASK();
+		__disable_irq();
+		started = HAL_FLASH_Program_IT(FLASH_TYPEPROGRAM_DOUBLEWORD, address, data) == HAL_OK;
+		if(started)
+		{
+			sFlashJournalPro.eOperation = headerJournalOperation;
+		}
+		__set_PRIMASK(primask);
+	}
+	else
+	{
+		address = (uint32_t)FlashJournalSlot(sFlashJournalPro.page, sFlashJournalPro.nextSlot);
+
+		// Record taken and pending cleared together, a newer Write is kept
+		primask = __get_PRIMASK();
+		__disable_irq();
+		if(FlashJournalEpoch(&sFlashJournalPro.sRecord) != sFlashJournalPro.epoch)
+		{
+			// Write from interrupt moved the epoch on, next pass rotates
+			__set_PRIMASK(primask);
+			sEventFlag.Set(flashJournalEventFlag);
+			return;
+		}
+		sSlot.lifetimeCoin = sFlashJournalPro.sRecord.lifetimeCoin;
+		sSlot.lifetimeVend = (uint16_t)sFlashJournalPro.sRecord.lifetimeVend;
+		sSlot.totalCoin = sFlashJournalPro.sRecord.totalCoin;
+		sSlot.check = FlashJournalCheck(&sSlot);
+		memcpy(&data, &sSlot, sizeof(data));
+		started = HAL_FLASH_Program_IT(FLASH_TYPEPROGRAM_DOUBLEWORD, address, data) == HAL_OK;
+		if(started)
+		{
+			sFlashJournalPro.recordPending = false;
+			// A failed slot is skipped, never programmed twice
+			sFlashJournalPro.nextSlot++;
+			sFlashJournalPro.eOperation = recordJournalOperation;
+		}
+		__set_PRIMASK(primask);
+	}
+
+	if(!started)
+	{
+		FlashJournalRetry();
+	}
+}
+
+/*******************************************************************************
+ * @fn      FlashJournalGetStatistic
+ * @brief   Copy journal statistic
+ * @param   psStatistic
+ * @return  None
+ ******************************************************************************/
+static void FlashJournalGetStatistic(sFLASH_JOURNAL_STATISTIC *psStatistic)
+{
+	*psStatistic = sFlashJournalPro.sStatistic;
+}
+
+// Flash journal function structure
+const sFLASH_JOURNAL sFlashJournal =
+{
+	FlashJournalMount,
+	FlashJournalWrite,
+	FlashJournalProcess,
+	FlashJournalGetStatistic,
+};
+
+/*******************************************************************************
+ * INTERRUPT CALLBACK
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      HAL_FLASH_EndOfOperationCallback
+ * @brief   Flash operation completed, next operation starts from main loop
+ *          because HAL is still locked here
+ * @param   returnValue
+ * @return  None
+ ******************************************************************************/
+void HAL_FLASH_EndOfOperationCallback(uint32_t returnValue)
+{
+	switch(sFlashJournalPro.eOperation)
+	{
+		case eraseJournalOperation:
+			sFlashJournalPro.sStatistic.pageErase++;
+			break;
+		case epochJournalOperation:
+			sFlashJournalPro.epochPending = false;
+			sFlashJournalPro.sStatistic.headerWrite++;
+			break;
+		case headerJournalOperation:
+			sFlashJournalPro.headerPending = false;
+			sFlashJournalPro.sStatistic.headerWrite++;
+			break;
+		case recordJournalOperation:
+			sFlashJournalPro.sStatistic.recordWrite++;
+			break;
+		default:
+			break;
+	}
+	sFlashJournalPro.eOperation = noneJournalOperation;
+	sEventFlag.Set(flashJournalEventFlag);
+}
+
+/*******************************************************************************
+ * @fn      HAL_FLASH_OperationErrorCallback
+ * @brief   Flash operation failed
+ * @param   returnValue
+ * @return  None
+ ******************************************************************************/
+void HAL_FLASH_OperationErrorCallback(uint32_t returnValue)
+{
+	// Failed erase, epoch or header, move on to next page
+	if(sFlashJournalPro.eOperation != recordJournalOperation)
+	{
+		sFlashJournalPro.epochPending = false;
+		sFlashJournalPro.headerPending = false;
+		sFlashJournalPro.nextSlot = JOURNAL_NUM_OF_SLOT;
+	}
+	// Failed record goes to next slot, a newer queued one replaces it
+	else
+	{
+		sFlashJournalPro.recordPending = true;
+	}
+	sFlashJournalPro.sStatistic.errorCount++;
+	sFlashJournalPro.eOperation = noneJournalOperation;
+	sEventFlag.Set(flashJournalEventFlag);
+}
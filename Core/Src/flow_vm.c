@@ -0,0 +1,511 @@
+/*******************************************************************************
+ * Filename:			flow_vm.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Vending flow bytecode interpreter
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "flow_vm.h"
+#include "software_timer.h"
+#include "cycle_counter.h"
+#include "crc.h"
+#include "gpio.h"
+#include "log.h"
+
+/*******************************************************************************
+ * EXTERNAL VARIABLES
+ ******************************************************************************/
+// Flow program page reserved by linker script below the journal
+extern uint32_t _sflow;
+extern uint32_t _eflow;
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define FLOW_VM_PAGE_SIZE		((uint32_t)&_eflow - (uint32_t)&_sflow)
+#define FLOW_VM_MAXIMUM_CODE	(FLOW_VM_PAGE_SIZE - sizeof(sFLOW_VM_HEADER))
+// Code bytes instruction start bitmap covers, longer programs are refused
+#define FLOW_VM_BITMAP_CODE		2048
+#define FLOW_VM_BENCHMARK_RUN	1000
+#define LOG_MODULE				LOG_MODULE_FLOW_VM
+// Built-in flow settings
+#define MINIMUM_COINS			5
+#define DISPENSE_PERIOD			1000
+
+#define IMM16(value)			((value) & 0xFF), (((value) >> 8) & 0xFF)
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Built-in program, same flow as the native regions without maintenance
+typedef struct
+{
+	sFLOW_VM_HEADER sHeader;
+	uint8_t code[57];
+}
+sFLOW_VM_BUILT_IN;
+
+// Define flow VM property structure
+typedef struct
+{
+	sFLOW_VM_CONTEXT sContext;
+	const sFLOW_VM_HEADER *psProgram;
+	const uint8_t *code;
+	bool fromFlash;
+	uint32_t runCount;
+	uint64_t totalCycle;
+	uint32_t maximumCycle;
+}
+sFLOW_VM_PRO;
+static sFLOW_VM_PRO sFlowVmPro;
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+// Instruction length including operands
+static const uint8_t FlowOpLength[maximumFlowOp] =
+{
+	[endFlowOp] = 1,
+	[loadCreditFlowOp] = 1,
+	[loadParameterFlowOp] = 1,
+	[loadImmediateFlowOp] = 3,
+	[addCreditFlowOp] = 1,
+	[useCreditFlowOp] = 1,
+	[saveFlowOp] = 1,
+	[jumpFlowOp] = 2,
+	[jumpLessFlowOp] = 4,
+	[jumpEqualFlowOp] = 4,
+	[timerStartFlowOp] = 3,
+	[timerStopFlowOp] = 1,
+	[gotoFlowOp] = 2,
+	[printFlowOp] = 2,
+	[printCreditFlowOp] = 1,
+	[printRemainFlowOp] = 1,
+};
+
+// Messages of printFlowOp
+static const char *const FlowMessage[maximumFlowMessage] =
+{
+	[buttonRefusedFlowMessage] = "Cannot press button at this status",
+	[buttonEnoughFlowMessage] = "Press button at enough coin machine status",
+	[buttonDispensingFlowMessage] = "Press button at dispensing machine status",
+	[buttonPauseFlowMessage] = "Press button at pause dispense machine status",
+	[coinRefusedFlowMessage] = "Cannot insert coin at this status",
+};
+
+static const sFLOW_VM_BUILT_IN sBuiltInProgram =
+{
+	{
+		FLOW_VM_MAGIC,
+		0,
+		FLOW_VM_VERSION,
+		sizeof(sBuiltInProgram.code),
+		{
+			[acceptCoinMachineStatus] = {4, 0, 17, FLOW_VM_NO_HANDLER, FLOW_VM_NO_HANDLER, FLOW_VM_NO_HANDLER},
+			[enoughCoinMachineStatus] = {FLOW_VM_NO_HANDLER, 0, 20, FLOW_VM_NO_HANDLER, FLOW_VM_NO_HANDLER, FLOW_VM_NO_HANDLER},
+			[dispensingMachineStatus] = {FLOW_VM_NO_HANDLER, 12, 28, 42, FLOW_VM_NO_HANDLER, FLOW_VM_NO_HANDLER},
+			[pauseDispenseMachineStatus] = {FLOW_VM_NO_HANDLER, 12, 34, FLOW_VM_NO_HANDLER, FLOW_VM_NO_HANDLER, FLOW_VM_NO_HANDLER},
+		},
+	},
+	{
+		// 0: Insert coin at accept and enough, falls through to 4
+		loadParameterFlowOp, addCreditFlowOp, saveFlowOp, printCreditFlowOp,
+		// 4: Start, go to enough when credit is enough
+		loadCreditFlowOp, jumpLessFlowOp, IMM16(MINIMUM_COINS), 2, gotoFlowOp, enoughCoinMachineStatus, endFlowOp,
+		// 12: Insert coin while dispensing, credit extends dispense
+		loadParameterFlowOp, addCreditFlowOp, saveFlowOp, printCreditFlowOp, endFlowOp,
+		// 17: Button at accept
+		printFlowOp, buttonRefusedFlowMessage, endFlowOp,
+		// 20: Button at enough
+		printFlowOp, buttonEnoughFlowMessage, timerStartFlowOp, IMM16(DISPENSE_PERIOD), gotoFlowOp, dispensingMachineStatus, endFlowOp,
+		// 28: Button at dispensing
+		printFlowOp, buttonDispensingFlowMessage, timerStopFlowOp, gotoFlowOp, pauseDispenseMachineStatus, endFlowOp,
+		// 34: Button at pause
+		printFlowOp, buttonPauseFlowMessage, timerStartFlowOp, IMM16(DISPENSE_PERIOD), gotoFlowOp, dispensingMachineStatus, endFlowOp,
+		// 42: Dispensing timer, 54 when credit is used up
+		useCreditFlowOp, saveFlowOp, loadCreditFlowOp, jumpEqualFlowOp, IMM16(0), 5,
+		printRemainFlowOp, timerStartFlowOp, IMM16(DISPENSE_PERIOD), endFlowOp,
+		gotoFlowOp, acceptCoinMachineStatus, endFlowOp,
+	},
+};
+
+// Instruction start bitmap used by validation
+static uint8_t instructionStart[(FLOW_VM_BITMAP_CODE + 7) / 8];
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void FlowVmInitialize(const sFLOW_VM_CONTEXT *psContext);
+static void FlowVmRun(eMACHINE_EVENT eMachineEvent, uint32_t parameter);
+static void FlowVmBenchmark(void);
+static void FlowVmPrint(void);
+
+/*******************************************************************************
+ * @fn      FlowVmIsStart
+ * @brief   Offset is the first byte of an instruction
+ * @param   offset
+ * @return  true
+ *          false
+ ******************************************************************************/
+static bool FlowVmIsStart(uint32_t offset)
+{
+	return (instructionStart[offset / 8] & (0x01 << (offset % 8))) != 0;
+}
+
+/*******************************************************************************
+ * @fn      FlowVmValidate
+ * @brief   Check program so the interpreter needs no run time checks:
+ *          known opcodes, operands in range, forward jumps to instruction
+ *          starts and last instruction is end
+ * @param   psProgram
+ *          size		Bytes available for header and code
+ *          checkCrc
+ * @return  true
+ *          false
+ ******************************************************************************/
+static bool FlowVmValidate(const sFLOW_VM_HEADER *psProgram, uint32_t size, bool checkCrc)
+{
+	const uint8_t *code = (const uint8_t *)(psProgram + 1);
+	uint32_t numOfWord = 0;
+	uint32_t target = 0;
+	uint32_t pc = 0;
+	uint8_t op = endFlowOp;
+	uint8_t i = 0;
+	uint8_t j = 0;
+
+	if(psProgram->magic != FLOW_VM_MAGIC || psProgram->version != FLOW_VM_VERSION ||
+	   psProgram->codeLength == 0 || psProgram->codeLength > FLOW_VM_MAXIMUM_CODE ||
+	   psProgram->codeLength > FLOW_VM_BITMAP_CODE ||
+	   ((sizeof(sFLOW_VM_HEADER) + psProgram->codeLength + 3) & ~3) > size)
+	{
+		return false;
+	}
+	if(checkCrc)
+	{
+		numOfWord = (sizeof(sFLOW_VM_HEADER) - offsetof(sFLOW_VM_HEADER, version) + psProgram->codeLength + 3) / 4;
+		if(sCrc.Calculate(&psProgram->version, numOfWord) != psProgram->crc)
+		{
+			return false;
+		}
+	}
+
+	memset(instructionStart, 0, sizeof(instructionStart));
+	for(pc = 0; pc < psProgram->codeLength; pc += FlowOpLength[op])
+	{
+		op = code[pc];
+		if(op >= maximumFlowOp || pc + FlowOpLength[op] > psProgram->codeLength)
+		{
+			return false;
+		}
+		if((op == gotoFlowOp && code[pc + 1] >= totalMachineStatus) ||
+		   (op == printFlowOp && code[pc + 1] >= maximumFlowMessage))
+		{
+			return false;
+		}
+		instructionStart[pc / 8] |= (0x01 << (pc % 8));
+	}
+	if(op != endFlowOp)
+	{
+		return false;
+	}
+
+	for(pc = 0; pc < psProgram->codeLength; pc += FlowOpLength[op])
+	{
+		op = code[pc];
+		if(op == jumpFlowOp || op == jumpLessFlowOp || op == jumpEqualFlowOp)
+		{
+			target = pc + FlowOpLength[op] + code[pc + FlowOpLength[op] - 1];
+			if(target >= psProgram->codeLength || !FlowVmIsStart(target))
+			{
+				return false;
+			}
+		}
+	}
+
+	for(i = 0; i < totalMachineStatus; i++)
+	{
+		for(j = 0; j < totalMachineEvent; j++)
+		{
+			if(psProgram->handler[i][j] != FLOW_VM_NO_HANDLER &&
+			   (psProgram->handler[i][j] >= psProgram->codeLength || !FlowVmIsStart(psProgram->handler[i][j])))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*******************************************************************************
+ * @fn      FlowVmExecute
+ * @brief   Threaded interpreter, every handler jumps straight to the next
+ *          through computed goto. Program is validated, no checks here
+ * @param   psContext
+ *          code
+ *          offset
+ *          parameter
+ * @return  None
+ ******************************************************************************/
+static void FlowVmExecute(const sFLOW_VM_CONTEXT *psContext, const uint8_t *code, uint16_t offset, uint32_t parameter)
+{
+	static const void *const dispatch[maximumFlowOp] =
+	{
+		[endFlowOp] = &&endOp,
+		[loadCreditFlowOp] = &&loadCreditOp,
+		[loadParameterFlowOp] = &&loadParameterOp,
+		[loadImmediateFlowOp] = &&loadImmediateOp,
+		[addCreditFlowOp] = &&addCreditOp,
+		[useCreditFlowOp] = &&useCreditOp,
+		[saveFlowOp] = &&saveOp,
+		[jumpFlowOp] = &&jumpOp,
+		[jumpLessFlowOp] = &&jumpLessOp,
+		[jumpEqualFlowOp] = &&jumpEqualOp,
+		[timerStartFlowOp] = &&timerStartOp,
+		[timerStopFlowOp] = &&timerStopOp,
+		[gotoFlowOp] = &&gotoOp,
+		[printFlowOp] = &&printOp,
+		[printCreditFlowOp] = &&printCreditOp,
+		[printRemainFlowOp] = &&printRemainOp,
+	};
+	const uint8_t *pc = code + offset;
+	uint32_t acc = 0;
+
+#define FLOW_NEXT()				goto *dispatch[*pc++]
+#define FLOW_IMM16(operand)		((uint32_t)(operand)[0] | ((uint32_t)(operand)[1] << 8))
+
+	FLOW_NEXT();
+
+loadCreditOp:
+	acc = *psContext->totalCoin;
+	FLOW_NEXT();
+loadParameterOp:
+	acc = parameter;
+	FLOW_NEXT();
+loadImmediateOp:
+	acc = FLOW_IMM16(pc);
+	pc += 2;
+	FLOW_NEXT();
+addCreditOp:
+	*psContext->lifetimeCoin += acc;
+	// Coins beyond uint8_t credit are held, not dropped
+	if(acc > (uint32_t)(UINT8_MAX - *psContext->totalCoin))
+	{
+		*psContext->heldCoin += acc - (UINT8_MAX - *psContext->totalCoin);
+		acc = UINT8_MAX - *psContext->totalCoin;
+	}
+	*psContext->totalCoin += acc;
+	FLOW_NEXT();
+useCreditOp:
+	if(*psContext->totalCoin > 0 && *psContext->heldCoin > 0)
+	{
+		(*psContext->heldCoin)--;
+	}
+	else if(*psContext->totalCoin > 0 && --(*psContext->totalCoin) == 0)
+	{
+		(*psContext->lifetimeVend)++;
+	}
+	FLOW_NEXT();
+saveOp:
+	psContext->Save();
+	FLOW_NEXT();
+jumpOp:
+	pc += 1 + pc[0];
+	FLOW_NEXT();
+jumpLessOp:
+	pc += acc < FLOW_IMM16(pc) ? 3 + pc[2] : 3;
+	FLOW_NEXT();
+jumpEqualOp:
+	pc += acc == FLOW_IMM16(pc) ? 3 + pc[2] : 3;
+	FLOW_NEXT();
+timerStartOp:
+	sSoftwareTimer.Start(psContext->timerId, FLOW_IMM16(pc));
+	pc += 2;
+	FLOW_NEXT();
+timerStopOp:
+	sSoftwareTimer.Stop(psContext->timerId);
+	FLOW_NEXT();
+gotoOp:
+	*psContext->status = *pc++;
+	FLOW_NEXT();
+printOp:
+	// Operand read outside, log call may be compiled out
+	LOG_INFO("%s\n", FlowMessage[*pc]);
+	pc++;
+	FLOW_NEXT();
+printCreditOp:
+	LOG_INFO("Total coin = %d\n", *psContext->totalCoin);
+	FLOW_NEXT();
+printRemainOp:
+	LOG_INFO("Still remain %d second\n", *psContext->totalCoin);
+	FLOW_NEXT();
+endOp:
+	return;
+
+#undef FLOW_NEXT
+#undef FLOW_IMM16
+}
+
+/*******************************************************************************
+ * @fn      FlowVmInitialize
+ * @brief   Run program of flow page when valid, built-in program otherwise
+ * @param   psContext
+ * @return  None
+ ******************************************************************************/
+static void FlowVmInitialize(const sFLOW_VM_CONTEXT *psContext)
+{
+	const sFLOW_VM_HEADER *psFlash = (const sFLOW_VM_HEADER *)&_sflow;
+
+	sFlowVmPro.sContext = *psContext;
+	if(FlowVmValidate(psFlash, FLOW_VM_PAGE_SIZE, true))
+	{
+		sFlowVmPro.psProgram = psFlash;
+		sFlowVmPro.fromFlash = true;
+	}
+	else if(FlowVmValidate(&sBuiltInProgram.sHeader, sizeof(sBuiltInProgram), false))
+	{
+		sFlowVmPro.psProgram = &sBuiltInProgram.sHeader;
+		sFlowVmPro.fromFlash = false;
+	}
+	else
+	{
+		Error_Handler();
+	}
+	sFlowVmPro.code = (const uint8_t *)(sFlowVmPro.psProgram + 1);
+	LOG_INFO("Flow program from %s, %d bytes\n", sFlowVmPro.fromFlash ? "flash" : "firmware",
+			sFlowVmPro.psProgram->codeLength);
+}
+
+/*******************************************************************************
+ * @fn      FlowVmRun
+ * @brief   Run handler of current status for event
+ * @param   eMachineEvent
+ *          parameter
+ * @return  None
+ ******************************************************************************/
+static void FlowVmRun(eMACHINE_EVENT eMachineEvent, uint32_t parameter)
+{
+	uint32_t startCycle = CYCLE_COUNTER_READ();
+	uint16_t offset = FLOW_VM_NO_HANDLER;
+	uint32_t cycle = 0;
+
+	if(sFlowVmPro.psProgram == NULL || eMachineEvent >= totalMachineEvent)
+	{
+		return;
+	}
+	offset = sFlowVmPro.psProgram->handler[*sFlowVmPro.sContext.status][eMachineEvent];
+	if(offset == FLOW_VM_NO_HANDLER)
+	{
+		return;
+	}
+	FlowVmExecute(&sFlowVmPro.sContext, sFlowVmPro.code, offset, parameter);
+
+	cycle = CYCLE_COUNTER_READ() - startCycle;
+	sFlowVmPro.runCount++;
+	sFlowVmPro.totalCycle += cycle;
+	if(cycle > sFlowVmPro.maximumCycle)
+	{
+		sFlowVmPro.maximumCycle = cycle;
+	}
+}
+
+/*******************************************************************************
+ * BENCHMARK FUNCTIONS
+ ******************************************************************************/
+static uint8_t benchmarkStatus;
+static uint8_t benchmarkCoin;
+static uint32_t benchmarkLifetimeCoin;
+static uint32_t benchmarkLifetimeVend;
+static uint32_t benchmarkHeldCoin;
+
+static void FlowVmBenchmarkSave(void)
+{
+}
+
+// Native version of the built-in start handler
+static void FlowVmNativeStart(void)
+{
+	if(benchmarkCoin >= MINIMUM_COINS)
+	{
+		benchmarkStatus = enoughCoinMachineStatus;
+	}
+}
+
+// Native handler table, volatile keeps the call indirect like a region table
+static void (*volatile const FlowVmNativeHandler[totalMachineStatus][totalMachineEvent])(void) =
+{
+	[acceptCoinMachineStatus] = {[startMachineEvent] = FlowVmNativeStart},
+};
+
+/*******************************************************************************
+ * @fn      FlowVmBenchmark
+ * @brief   Cycles per event of the built-in start handler, interpreted and
+ *          native, on scratch data so the machine is not touched
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void FlowVmBenchmark(void)
+{
+	const sFLOW_VM_CONTEXT sContext =
+	{
+		&benchmarkStatus, &benchmarkCoin, &benchmarkLifetimeCoin, &benchmarkLifetimeVend, &benchmarkHeldCoin, 0,
+		FlowVmBenchmarkSave,
+	};
+	const uint8_t *code = sBuiltInProgram.code;
+	uint32_t interpretedCycle = 0;
+	uint32_t nativeCycle = 0;
+	uint32_t startCycle = 0;
+	uint32_t i = 0;
+
+	startCycle = CYCLE_COUNTER_READ();
+	for(i = 0; i < FLOW_VM_BENCHMARK_RUN; i++)
+	{
+		benchmarkStatus = acceptCoinMachineStatus;
+		benchmarkCoin = i & 0x07;
+		FlowVmExecute(&sContext, code, sBuiltInProgram.sHeader.handler[benchmarkStatus][startMachineEvent], 0);
+	}
+	interpretedCycle = CYCLE_COUNTER_READ() - startCycle;
+
+	startCycle = CYCLE_COUNTER_READ();
+	for(i = 0; i < FLOW_VM_BENCHMARK_RUN; i++)
+	{
+		benchmarkStatus = acceptCoinMachineStatus;
+		benchmarkCoin = i & 0x07;
+		FlowVmNativeHandler[benchmarkStatus][startMachineEvent]();
+	}
+	nativeCycle = CYCLE_COUNTER_READ() - startCycle;
+
+	sLog.Printf("Start handler x%d: interpreted %lu, native %lu cycles/event\n", FLOW_VM_BENCHMARK_RUN,
+			(unsigned long)(interpretedCycle / FLOW_VM_BENCHMARK_RUN), (unsigned long)(nativeCycle / FLOW_VM_BENCHMARK_RUN));
+}
+
+/*******************************************************************************
+ * @fn      FlowVmPrint
+ * @brief   Print program source and run cost
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void FlowVmPrint(void)
+{
+	if(sFlowVmPro.psProgram == NULL)
+	{
+		sLog.Printf("Flow program not loaded\n");
+		return;
+	}
+	sLog.Printf("Flow program from %s, %d bytes, %lu runs, average %lu max %lu cycles\n",
+			sFlowVmPro.fromFlash ? "flash" : "firmware", sFlowVmPro.psProgram->codeLength,
+			(unsigned long)sFlowVmPro.runCount,
+			(unsigned long)(sFlowVmPro.runCount > 0 ? sFlowVmPro.totalCycle / sFlowVmPro.runCount : 0),
+			(unsigned long)sFlowVmPro.maximumCycle);
+}
+
+// Flow VM function structure
+const sFLOW_VM sFlowVm =
+{
+	FlowVmInitialize,
+	FlowVmRun,
+	FlowVmBenchmark,
+	FlowVmPrint,
+};
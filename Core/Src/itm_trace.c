@@ -0,0 +1,236 @@
+/*******************************************************************************
+ * Filename:			itm_trace.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    ITM trace channels, one stimulus port per subsystem
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "itm_trace.h"
+#include "cycle_counter.h"
+#include "log.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define ITM_UNLOCK_KEY			0xC5ACCE55
+#define ITM_BENCHMARK_WORD		64
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static const char *const itmChannelName[maximumItmChannel] = {"log", "transition", "timer", "profile"};
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define ITM trace property structure
+typedef struct
+{
+	uint32_t byteCount[maximumItmChannel];
+}
+sITM_TRACE_PRO;
+static sITM_TRACE_PRO sItmTracePro;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void ItmTraceInitialize(void);
+static void ItmTraceWord(eITM_CHANNEL eItmChannel, uint32_t value);
+static void ItmTraceText(eITM_CHANNEL eItmChannel, const char *data, uint32_t length);
+static void ItmTraceBenchmark(void);
+static void ItmTracePrint(void);
+
+/*******************************************************************************
+ * @fn      ItmTraceOn
+ * @brief   ITM and stimulus port enabled by debugger
+ * @param   eItmChannel
+ * @return  true: on
+ ******************************************************************************/
+static inline bool ItmTraceOn(eITM_CHANNEL eItmChannel)
+{
+	return (ITM->TCR & ITM_TCR_ITMENA_Msk) != 0 && (ITM->TER & ((uint32_t)0x01 << eItmChannel)) != 0;
+}
+
+/*******************************************************************************
+ * @fn      ItmTraceWait
+ * @brief   Wait for room in stimulus port FIFO, SWO drains it
+ * @param   eItmChannel
+ * @return  None
+ ******************************************************************************/
+static inline void ItmTraceWait(eITM_CHANNEL eItmChannel)
+{
+	while(ITM->PORT[eItmChannel].u32 == 0)
+	{
+		__NOP();
+	}
+}
+
+/*******************************************************************************
+ * @fn      ItmTraceInitialize
+ * @brief   Open channel ports when debugger has enabled ITM, SWV settings
+ *          may list port 0 only
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ItmTraceInitialize(void)
+{
+	if(!ITM_TRACE_ENABLE || (ITM->TCR & ITM_TCR_ITMENA_Msk) == 0)
+	{
+		return;
+	}
+	ITM->LAR = ITM_UNLOCK_KEY;
+	ITM->TER |= ((uint32_t)0x01 << maximumItmChannel) - 1;
+}
+
+/*******************************************************************************
+ * @fn      ItmTraceWord
+ * @brief   One 32-bit stimulus write, waits while port FIFO is full.
+ *          Each channel has one writer context, except log
+ * @param   eItmChannel
+ *          value
+ * @return  None
+ ******************************************************************************/
+static void ItmTraceWord(eITM_CHANNEL eItmChannel, uint32_t value)
+{
+	if(!ITM_TRACE_ENABLE || !ItmTraceOn(eItmChannel))
+	{
+		return;
+	}
+	ItmTraceWait(eItmChannel);
+	ITM->PORT[eItmChannel].u32 = value;
+	sItmTracePro.byteCount[eItmChannel] += sizeof(uint32_t);
+}
+
+/*******************************************************************************
+ * @fn      ItmTraceText
+ * @brief   Text in 32-bit writes, rest in 16-bit and 8-bit writes so no
+ *          padding reaches the viewer
+ * @param   eItmChannel
+ *          data
+ *          length
+ * @return  None
+ ******************************************************************************/
+static void ItmTraceText(eITM_CHANNEL eItmChannel, const char *data, uint32_t length)
+{
+	uint32_t word = 0;
+	uint16_t halfWord = 0;
+
+	if(!ITM_TRACE_ENABLE || !ItmTraceOn(eItmChannel))
+	{
+		return;
+	}
+	sItmTracePro.byteCount[eItmChannel] += length;
+	for(; length >= sizeof(word); length -= sizeof(word), data += sizeof(word))
+	{
+		memcpy(&word, data, sizeof(word));
+		ItmTraceWait(eItmChannel);
+		ITM->PORT[eItmChannel].u32 = word;
+	}
+	if(length >= sizeof(halfWord))
+	{
+		memcpy(&halfWord, data, sizeof(halfWord));
+		ItmTraceWait(eItmChannel);
+		ITM->PORT[eItmChannel].u16 = halfWord;
+		length -= sizeof(halfWord);
+		data += sizeof(halfWord);
+	}
+	if(length > 0)
+	{
+		ItmTraceWait(eItmChannel);
+		ITM->PORT[eItmChannel].u8 = (uint8_t)*data;
+	}
+}
+
+/*******************************************************************************
+ * @fn      ItmTraceRate
+ * @brief   Bytes per second from cycles at current clock
+ * @param   numOfByte
+ *          cycle
+ * @return  Bytes per second
+ ******************************************************************************/
+static uint32_t ItmTraceRate(uint32_t numOfByte, uint32_t cycle)
+{
+	return cycle == 0 ? 0 : (uint32_t)((uint64_t)numOfByte * SystemCoreClock / cycle);
+}
+
+/*******************************************************************************
+ * @fn      ItmTraceBenchmark
+ * @brief   Bytes per second of each channel with 32-bit writes, then log
+ *          channel with the 8-bit writes ITM_SendChar makes. SWO clock
+ *          limits both once FIFO is full
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ItmTraceBenchmark(void)
+{
+	uint32_t wordRate[maximumItmChannel] = {0};
+	uint32_t byteRate = 0;
+	uint32_t startCycle = 0;
+	uint8_t eItmChannel = 0;
+	uint32_t i = 0;
+
+	if(!ITM_TRACE_ENABLE || (ITM->TCR & ITM_TCR_ITMENA_Msk) == 0)
+	{
+		sLog.Printf("ITM off, start SWV trace first\n");
+		return;
+	}
+	for(eItmChannel = 0; eItmChannel < maximumItmChannel; eItmChannel++)
+	{
+		if(!ItmTraceOn(eItmChannel))
+		{
+			continue;
+		}
+		startCycle = CYCLE_COUNTER_READ();
+		// Spaces, harmless on text port
+		for(i = 0; i < ITM_BENCHMARK_WORD; i++)
+		{
+			ItmTraceWord(eItmChannel, 0x20202020);
+		}
+		wordRate[eItmChannel] = ItmTraceRate(ITM_BENCHMARK_WORD * sizeof(uint32_t), CYCLE_COUNTER_READ() - startCycle);
+	}
+	if(ItmTraceOn(logItmChannel))
+	{
+		startCycle = CYCLE_COUNTER_READ();
+		for(i = 0; i < ITM_BENCHMARK_WORD * sizeof(uint32_t); i++)
+		{
+			ITM_SendChar(' ');
+		}
+		byteRate = ItmTraceRate(ITM_BENCHMARK_WORD * sizeof(uint32_t), CYCLE_COUNTER_READ() - startCycle);
+	}
+
+	for(eItmChannel = 0; eItmChannel < maximumItmChannel; eItmChannel++)
+	{
+		sLog.Printf("%-10s port %d: %lu bytes/s\n", itmChannelName[eItmChannel], eItmChannel, (unsigned long)wordRate[eItmChannel]);
+	}
+	sLog.Printf("log 8-bit writes: %lu bytes/s\n", (unsigned long)byteRate);
+}
+
+/*******************************************************************************
+ * @fn      ItmTracePrint
+ * @brief   Print port state and bytes written per channel
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ItmTracePrint(void)
+{
+	uint8_t eItmChannel = 0;
+
+	for(eItmChannel = 0; eItmChannel < maximumItmChannel; eItmChannel++)
+	{
+		sLog.Printf("%-10s port %d %-3s %lu bytes\n", itmChannelName[eItmChannel], eItmChannel,
+				ItmTraceOn(eItmChannel) ? "on" : "off", (unsigned long)sItmTracePro.byteCount[eItmChannel]);
+	}
+}
+
+// ITM trace function structure
+const sITM_TRACE sItmTrace =
+{
+	ItmTraceInitialize,
+	ItmTraceWord,
+	ItmTraceText,
+	ItmTraceBenchmark,
+	ItmTracePrint,
+};
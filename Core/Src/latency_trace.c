@@ -0,0 +1,229 @@
+/*******************************************************************************
+ * Filename:			latency_trace.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Edge-to-state-change latency trace function
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "latency_trace.h"
+#include "log.h"
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define latency trace property structure
+typedef struct
+{
+	// Timer stamp of each stage for the event in flight
+	uint32_t stamp[maximumDebounceInput][maximumLatencyStage];
+	// Next stage expected, edgeLatencyStage means idle
+	eLATENCY_STAGE eNextStage[maximumDebounceInput];
+	// Stage n keeps stamp[n] - stamp[n - 1], edgeLatencyStage keeps total
+	uint32_t sample[maximumDebounceInput][maximumLatencyStage][LATENCY_TRACE_SAMPLES];
+	uint32_t numOfSample[maximumDebounceInput];
+}
+sLATENCY_TRACE_PRO;
+static sLATENCY_TRACE_PRO sLatencyTracePro;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void LatencyTraceInitialize(void);
+static void LatencyTraceRetune(void);
+static void LatencyTraceStamp(eDEBOUNCE_INPUT eInput, eLATENCY_STAGE eStage);
+static void LatencyTraceAbort(eDEBOUNCE_INPUT eInput);
+static void LatencyTraceReset(void);
+static void LatencyTracePrint(void);
+
+/*******************************************************************************
+ * @fn      LatencyTraceInitialize
+ * @brief   Start stamp timer, counts up to 2^32 us and wraps. TIM5 stays
+ *          clocked in sleep mode after reset
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void LatencyTraceInitialize(void)
+{
+	if(!LATENCY_TRACE_ENABLE)
+	{
+		return;
+	}
+	__HAL_RCC_TIM5_CLK_ENABLE();
+	LATENCY_TRACE_TIMER->CR1 = 0;
+	LATENCY_TRACE_TIMER->ARR = 0xFFFFFFFF;
+	LATENCY_TRACE_TIMER->CNT = 0;
+	LatencyTraceRetune();
+	LATENCY_TRACE_TIMER->CR1 = TIM_CR1_CEN;
+}
+
+/*******************************************************************************
+ * @fn      LatencyTraceRetune
+ * @brief   Keep 1 us count at current core clock, call with interrupts
+ *          disabled after SystemCoreClock changed. Prescaler is reloaded at
+ *          once with the counter kept, a switch costs less than 1 us
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void LatencyTraceRetune(void)
+{
+	uint32_t counter = 0;
+
+	if(!LATENCY_TRACE_ENABLE)
+	{
+		return;
+	}
+	counter = LATENCY_TRACE_TIMER->CNT;
+	LATENCY_TRACE_TIMER->PSC = SystemCoreClock / LATENCY_TRACE_CLOCK - 1;
+	// Update generation only reloads prescaler, no interrupt
+	LATENCY_TRACE_TIMER->CR1 |= TIM_CR1_URS;
+	LATENCY_TRACE_TIMER->EGR = TIM_EGR_UG;
+	LATENCY_TRACE_TIMER->CNT = counter;
+	LATENCY_TRACE_TIMER->CR1 &= ~TIM_CR1_URS;
+}
+
+/*******************************************************************************
+ * @fn      LatencyTraceStamp
+ * @brief   Stamp a stage, the last stage stores the stage deltas
+ * @param   eInput
+ *          eStage
+ * @return  None
+ ******************************************************************************/
+static void LatencyTraceStamp(eDEBOUNCE_INPUT eInput, eLATENCY_STAGE eStage)
+{
+#if LATENCY_TRACE_ENABLE
+	uint32_t time = LATENCY_TRACE_TIMER->CNT;
+	uint32_t *stamp = sLatencyTracePro.stamp[eInput];
+	uint32_t slot = 0;
+	uint8_t i = 0;
+
+	// Bounces after the first edge belong to the event in flight
+	if(eInput >= maximumDebounceInput || eStage != sLatencyTracePro.eNextStage[eInput])
+	{
+		return;
+	}
+	stamp[eStage] = time;
+	if(eStage + 1 < maximumLatencyStage)
+	{
+		sLatencyTracePro.eNextStage[eInput] = eStage + 1;
+		return;
+	}
+
+	slot = sLatencyTracePro.numOfSample[eInput] % LATENCY_TRACE_SAMPLES;
+	sLatencyTracePro.sample[eInput][edgeLatencyStage][slot] = stamp[eStage] - stamp[edgeLatencyStage];
+	for(i = debounceLatencyStage; i < maximumLatencyStage; i++)
+	{
+		sLatencyTracePro.sample[eInput][i][slot] = stamp[i] - stamp[i - 1];
+	}
+	sLatencyTracePro.numOfSample[eInput]++;
+	sLatencyTracePro.eNextStage[eInput] = edgeLatencyStage;
+#else
+	(void)eInput;
+	(void)eStage;
+#endif
+}
+
+/*******************************************************************************
+ * @fn      LatencyTraceAbort
+ * @brief   Drop the event in flight, e.g. rejected by pin level check
+ * @param   eInput
+ * @return  None
+ ******************************************************************************/
+static void LatencyTraceAbort(eDEBOUNCE_INPUT eInput)
+{
+	if(eInput >= maximumDebounceInput)
+	{
+		return;
+	}
+	sLatencyTracePro.eNextStage[eInput] = edgeLatencyStage;
+}
+
+/*******************************************************************************
+ * @fn      LatencyTraceReset
+ * @brief   Clear all samples
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void LatencyTraceReset(void)
+{
+	__disable_irq();
+	memset(&sLatencyTracePro, 0, sizeof(sLatencyTracePro));
+	__enable_irq();
+}
+
+/*******************************************************************************
+ * @fn      LatencyTraceSort
+ * @brief   Insertion sort, sample sets are small
+ * @param   sample
+ *          numOfSample
+ * @return  None
+ ******************************************************************************/
+static void LatencyTraceSort(uint32_t *sample, uint32_t numOfSample)
+{
+	uint32_t i = 0;
+	uint32_t j = 0;
+	uint32_t value = 0;
+
+	for(i = 1; i < numOfSample; i++)
+	{
+		value = sample[i];
+		for(j = i; j > 0 && sample[j - 1] > value; j--)
+		{
+			sample[j] = sample[j - 1];
+		}
+		sample[j] = value;
+	}
+}
+
+/*******************************************************************************
+ * @fn      LatencyTracePrint
+ * @brief   Print p50, p99 and max us of every stage
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void LatencyTracePrint(void)
+{
+	static const char *stageName[maximumLatencyStage] = {"total", "edge->debounce", "debounce->dispatch", "dispatch->state"};
+	uint32_t sorted[LATENCY_TRACE_SAMPLES];
+	uint32_t numOfSample = 0;
+	uint8_t i = 0;
+	uint8_t j = 0;
+
+	for(i = 0; i < maximumDebounceInput; i++)
+	{
+		numOfSample = sLatencyTracePro.numOfSample[i];
+		sLog.Printf("%s latency, %lu events, us p50/p99/max:\n", sDebounceInput[i].name, (unsigned long)numOfSample);
+		if(numOfSample > LATENCY_TRACE_SAMPLES)
+		{
+			numOfSample = LATENCY_TRACE_SAMPLES;
+		}
+		if(numOfSample == 0)
+		{
+			continue;
+		}
+		for(j = 0; j < maximumLatencyStage; j++)
+		{
+			__disable_irq();
+			memcpy(sorted, sLatencyTracePro.sample[i][j], numOfSample * sizeof(uint32_t));
+			__enable_irq();
+			LatencyTraceSort(sorted, numOfSample);
+			sLog.Printf("  %-20s %10lu %10lu %10lu\n", stageName[j],
+					(unsigned long)sorted[(numOfSample - 1) * 50 / 100],
+					(unsigned long)sorted[(numOfSample - 1) * 99 / 100],
+					(unsigned long)sorted[numOfSample - 1]);
+		}
+	}
+}
+
+// Latency trace function structure
+const sLATENCY_TRACE sLatencyTrace =
+{
+	LatencyTraceInitialize,
+	LatencyTraceRetune,
+	LatencyTraceStamp,
+	LatencyTraceAbort,
+	LatencyTraceReset,
+	LatencyTracePrint,
+};
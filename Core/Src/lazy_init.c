@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * Filename:			lazy_init.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Peripheral initialization on first use or in the
+ *						first idle slots after boot, whichever comes first
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "lazy_init.h"
+#include "boot_profiler.h"
+#include "console.h"
+#include "itm_trace.h"
+#include "pulse_counter.h"
+#include "coin_capture.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static volatile uint32_t initializedPeripheral = 0;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void LazyInitUse(eLAZY_PERIPHERAL eLazyPeripheral);
+static bool LazyInitIdle(void);
+
+/*******************************************************************************
+ * PERIPHERAL INITIALIZE FUNCTIONS
+ ******************************************************************************/
+static void CrcInitialize(void);
+static void FlashInitialize(void);
+static void UsartInitialize(void);
+static void ItmInitialize(void);
+static void LptimInitialize(void);
+static void Tim2Initialize(void);
+static void TelemetryTimerInitialize(void);
+
+// Initialize jump table, every function must be safe to run twice
+static void (*const PeripheralInitialize[maximumLazyPeripheral])(void) =
+{
+	[crcLazyPeripheral] = CrcInitialize,
+	[flashLazyPeripheral] = FlashInitialize,
+	[consoleLazyPeripheral] = UsartInitialize,
+	[itmLazyPeripheral] = ItmInitialize,
+	[pulseCounterLazyPeripheral] = LptimInitialize,
+	[coinCaptureLazyPeripheral] = Tim2Initialize,
+	[telemetryLazyPeripheral] = TelemetryTimerInitialize,
+};
+
+/*******************************************************************************
+ * @fn      CrcInitialize
+ * @brief   CRC unit clock
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void CrcInitialize(void)
+{
+	__HAL_RCC_CRC_CLK_ENABLE();
+}
+
+/*******************************************************************************
+ * @fn      FlashInitialize
+ * @brief   Flash end of operation interrupt
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void FlashInitialize(void)
+{
+	HAL_NVIC_SetPriority(FLASH_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(FLASH_IRQn);
+}
+
+/*******************************************************************************
+ * @fn      UsartInitialize
+ * @brief   Console USART2, HSI start is the longest wait of boot. Log
+ *          written before queues in TX ring
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void UsartInitialize(void)
+{
+	sConsole.Initialize();
+}
+
+/*******************************************************************************
+ * @fn      ItmInitialize
+ * @brief   ITM stimulus ports besides log
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ItmInitialize(void)
+{
+	sItmTrace.Initialize();
+}
+
+/*******************************************************************************
+ * @fn      LptimInitialize
+ * @brief   LPTIM coin pulse counters
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void LptimInitialize(void)
+{
+	sPulseCounter.Initialize();
+}
+
+/*******************************************************************************
+ * @fn      Tim2Initialize
+ * @brief   TIM2 coin pulse width capture
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void Tim2Initialize(void)
+{
+	sCoinCapture.Initialize();
+}
+
+/*******************************************************************************
+ * @fn      TelemetryTimerInitialize
+ * @brief   Telemetry snapshot timer
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void TelemetryTimerInitialize(void)
+{
+	sTelemetry.Initialize();
+}
+
+/*******************************************************************************
+ * @fn      LazyInitUse
+ * @brief   Initialize peripheral on its first use, one bit test afterwards.
+ *          Marked first so that an initializer using itself does not recurse
+ * @param   eLazyPeripheral
+ * @return  None
+ ******************************************************************************/
+static void LazyInitUse(eLAZY_PERIPHERAL eLazyPeripheral)
+{
+	if((initializedPeripheral & (0x01 << eLazyPeripheral)) == 0)
+	{
+		initializedPeripheral |= (0x01 << eLazyPeripheral);
+		PeripheralInitialize[eLazyPeripheral]();
+	}
+}
+
+/*******************************************************************************
+ * @fn      LazyInitIdle
+ * @brief   Main loop has nothing ready, initialize one peripheral not used
+ *          yet. Boot profiler stamps the deferred phase when none is left
+ * @param   None
+ * @return  true: one initialized, look for events before the next
+ ******************************************************************************/
+static bool LazyInitIdle(void)
+{
+	uint8_t i = 0;
+
+	for(i = 0; i < maximumLazyPeripheral; i++)
+	{
+		if((initializedPeripheral & (0x01 << i)) == 0)
+		{
+			LazyInitUse(i);
+			return true;
+		}
+	}
+	sBootProfiler.Stamp(deferredBootPhase);
+	return false;
+}
+
+// Lazy initialization function structure
+const sLAZY_INIT sLazyInit =
+{
+	LazyInitUse,
+	LazyInitIdle,
+};
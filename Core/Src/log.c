@@ -0,0 +1,362 @@
+/*******************************************************************************
+ * Filename:			log.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Integer only formatter writing to log sink
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "log.h"
+#include "console.h"
+#include "cycle_counter.h"
+#include "itm_trace.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define LOG_BENCHMARK_RUN		100
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+// Ring of last log output, index counts every character written
+static char logTail[LOG_TAIL_SIZE];
+static uint32_t logTailIndex;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+uint8_t logLevel = LOG_LEVEL;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void LogPrintf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+static uint32_t LogFormat(char *buffer, uint32_t size, const char *format, va_list args);
+static void LogWrite(const char *data, uint32_t length);
+static void LogSetLevel(uint8_t level);
+static uint32_t LogTail(char *buffer, uint32_t size);
+static void LogBenchmark(void);
+
+/*******************************************************************************
+ * @fn      LogPut
+ * @brief   Append character, keep room for terminator
+ * @param   buffer
+ *          size
+ *          length
+ *          c
+ * @return  None
+ ******************************************************************************/
+static inline void LogPut(char *buffer, uint32_t size, uint32_t *length, char c)
+{
+	if(*length + 1 < size)
+	{
+		buffer[*length] = c;
+	}
+	(*length)++;
+}
+
+/*******************************************************************************
+ * @fn      LogFormat
+ * @brief   Format into buffer, no heap and no float
+ * @param   buffer
+ *          size
+ *          format
+ *          args
+ * @return  Length written without terminator, cut to size - 1
+ ******************************************************************************/
+static uint32_t LogFormat(char *buffer, uint32_t size, const char *format, va_list args)
+{
+	static const char lowerDigit[] = "0123456789abcdef";
+	static const char upperDigit[] = "0123456789ABCDEF";
+	const char *digit = lowerDigit;
+	const char *string = NULL;
+	char number[11];
+	uint32_t length = 0;
+	uint32_t value = 0;
+	uint32_t base = 10;
+	uint32_t numOfDigit = 0;
+	uint32_t numOfChar = 0;
+	uint8_t width = 0;
+	bool leftAlign = false;
+	bool zeroPad = false;
+	bool negative = false;
+
+	if(size == 0)
+	{
+		return 0;
+	}
+	for(; *format != '\0'; format++)
+	{
+		if(*format != '%')
+		{
+			LogPut(buffer, size, &length, *format);
+			continue;
+		}
+		format++;
+		leftAlign = false;
+		zeroPad = false;
+		for(; *format == '-' || *format == '0'; format++)
+		{
+			leftAlign |= *format == '-';
+			zeroPad |= *format == '0';
+		}
+		for(width = 0; *format >= '0' && *format <= '9'; format++)
+		{
+			width = width * 10 + (*format - '0');
+		}
+		// int and long are both 32-bit
+		for(; *format == 'l' || *format == 'h'; format++)
+		{
+		}
+
+		numOfDigit = 0;
+		negative = false;
+		string = number;
+		digit = lowerDigit;
+		base = 10;
+		switch(*format)
+		{
+			case 'd':
+			case 'i':
+				value = va_arg(args, int32_t);
+				if((int32_t)value < 0)
+				{
+					negative = true;
+					value = -value;
+				}
+				break;
+			case 'u':
+				value = va_arg(args, uint32_t);
+				break;
+			case 'X':
+				digit = upperDigit;
+				base = 16;
+				value = va_arg(args, uint32_t);
+				break;
+			case 'x':
+			case 'p':
+				base = 16;
+				value = *format == 'p' ? (uint32_t)(uintptr_t)va_arg(args, void *) : va_arg(args, uint32_t);
+				break;
+			case 'c':
+				number[0] = (char)va_arg(args, int);
+				numOfDigit = 1;
+				break;
+			case 's':
+				string = va_arg(args, const char *);
+				if(string == NULL)
+				{
+					string = "(null)";
+				}
+				numOfDigit = strlen(string);
+				break;
+			case '\0':
+				format--;
+				continue;
+			default:
+				// %% and unknown conversions print as is
+				LogPut(buffer, size, &length, *format);
+				continue;
+		}
+
+		// Number digits are built backwards at end of number
+		if(string == number && numOfDigit == 0)
+		{
+			do
+			{
+				number[sizeof(number) - 1 - numOfDigit++] = digit[value % base];
+				value /= base;
+			}
+			while(value != 0);
+			string = &number[sizeof(number) - numOfDigit];
+		}
+
+		numOfChar = numOfDigit + negative;
+		if(negative && zeroPad)
+		{
+			LogPut(buffer, size, &length, '-');
+		}
+		for(; !leftAlign && width > numOfChar; width--)
+		{
+			LogPut(buffer, size, &length, zeroPad ? '0' : ' ');
+		}
+		if(negative && !zeroPad)
+		{
+			LogPut(buffer, size, &length, '-');
+		}
+		while(numOfDigit-- > 0)
+		{
+			LogPut(buffer, size, &length, *string++);
+		}
+		for(; leftAlign && width > numOfChar; width--)
+		{
+			LogPut(buffer, size, &length, ' ');
+		}
+	}
+
+	if(length >= size)
+	{
+		length = size - 1;
+	}
+	buffer[length] = '\0';
+	return length;
+}
+
+/*******************************************************************************
+ * @fn      LogPrintf
+ * @brief   Format message on stack and write it to log sink
+ * @param   format
+ * @return  None
+ ******************************************************************************/
+static void LogPrintf(const char *format, ...)
+{
+	char buffer[LOG_LINE_SIZE];
+	uint32_t length = 0;
+	va_list args;
+
+	va_start(args, format);
+	length = LogFormat(buffer, sizeof(buffer), format, args);
+	va_end(args);
+	LogWrite(buffer, length);
+}
+
+/*******************************************************************************
+ * @fn      LogWrite
+ * @brief   Log sink, ITM log channel and USART2 console
+ * @param   data
+ *          length
+ * @return  None
+ ******************************************************************************/
+static void LogWrite(const char *data, uint32_t length)
+{
+	uint32_t i = 0;
+
+	sItmTrace.Text(logItmChannel, data, length);
+	for(i = 0; i < length; i++)
+	{
+		logTail[logTailIndex++ & (LOG_TAIL_SIZE - 1)] = data[i];
+	}
+	sConsole.Write(data, length);
+}
+
+/*******************************************************************************
+ * @fn      LogSetLevel
+ * @brief   Set run time threshold, levels above LOG_LEVEL stay compiled out
+ * @param   level
+ * @return  None
+ ******************************************************************************/
+static void LogSetLevel(uint8_t level)
+{
+	logLevel = level > LOG_LEVEL_DEBUG ? LOG_LEVEL_DEBUG : level;
+	if(logLevel > LOG_LEVEL)
+	{
+		sLog.Printf("Level %d above compiled level %d\n", logLevel, LOG_LEVEL);
+	}
+}
+
+/*******************************************************************************
+ * @fn      LogTail
+ * @brief   Copy last log output, oldest first. Safe from fault handler
+ * @param   buffer
+ *          size
+ * @return  Length copied
+ ******************************************************************************/
+static uint32_t LogTail(char *buffer, uint32_t size)
+{
+	uint32_t end = logTailIndex;
+	uint32_t length = end < LOG_TAIL_SIZE ? end : LOG_TAIL_SIZE;
+	uint32_t i = 0;
+
+	if(length > size)
+	{
+		length = size;
+	}
+	for(i = 0; i < length; i++)
+	{
+		buffer[i] = logTail[(end - length + i) & (LOG_TAIL_SIZE - 1)];
+	}
+	return length;
+}
+
+/*******************************************************************************
+ * @fn      LogBenchmarkFormat
+ * @brief   Format through LogFormat like LogPrintf does
+ * @param   buffer
+ *          size
+ *          format
+ * @return  None
+ ******************************************************************************/
+static void LogBenchmarkFormat(char *buffer, uint32_t size, const char *format, ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	LogFormat(buffer, size, format, args);
+	va_end(args);
+}
+
+/*******************************************************************************
+ * @fn      LogBenchmark
+ * @brief   Cycles to format a state machine message, this formatter against
+ *          newlib snprintf when LOG_BENCHMARK_NEWLIB, sink excluded. Then
+ *          cost of a log site filtered at run time, a site filtered at
+ *          compile time costs none
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void LogBenchmark(void)
+{
+	char buffer[LOG_LINE_SIZE];
+	uint32_t logCycle = 0;
+	uint32_t newlibCycle = 0;
+	uint32_t filterCycle = 0;
+	uint32_t startCycle = 0;
+	uint8_t level = logLevel;
+	uint32_t i = 0;
+
+	startCycle = CYCLE_COUNTER_READ();
+	for(i = 0; i < LOG_BENCHMARK_RUN; i++)
+	{
+		LogBenchmarkFormat(buffer, sizeof(buffer), "Total coin = %d\n", (int)i);
+	}
+	logCycle = (CYCLE_COUNTER_READ() - startCycle) / LOG_BENCHMARK_RUN;
+
+#if LOG_BENCHMARK_NEWLIB
+	startCycle = CYCLE_COUNTER_READ();
+	for(i = 0; i < LOG_BENCHMARK_RUN; i++)
+	{
+		snprintf(buffer, sizeof(buffer), "Total coin = %d\n", (int)i);
+	}
+	newlibCycle = (CYCLE_COUNTER_READ() - startCycle) / LOG_BENCHMARK_RUN;
+#endif
+
+	logLevel = LOG_LEVEL_NONE;
+	startCycle = CYCLE_COUNTER_READ();
+	for(i = 0; i < LOG_BENCHMARK_RUN; i++)
+	{
+		LOG(LOG_LEVEL_ERROR, LOG_MODULE_STATE_MACHINE, "Total coin = %d\n", (int)i);
+	}
+	filterCycle = (CYCLE_COUNTER_READ() - startCycle) / LOG_BENCHMARK_RUN;
+	logLevel = level;
+
+	LogPrintf("\"Total coin = %%d\": log %lu, filtered at run time %lu cycles per message\n",
+			(unsigned long)logCycle, (unsigned long)filterCycle);
+	if(LOG_BENCHMARK_NEWLIB)
+	{
+		LogPrintf("newlib %lu cycles per message\n", (unsigned long)newlibCycle);
+	}
+}
+
+// Log function structure
+const sLOG sLog =
+{
+	LogPrintf,
+	LogFormat,
+	LogWrite,
+	LogSetLevel,
+	LogTail,
+	LogBenchmark,
+};
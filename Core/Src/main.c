@@ -26,6 +26,9 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "main_loop.h"
+#include "boot_profiler.h"
+#include "fault_capture.h"
+#include "memory_protection.h"
 
 /* USER CODE END Includes */
 
@@ -36,6 +39,7 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define PLL_LOCK_TIMEOUT	2U
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -52,11 +56,59 @@
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
+static void SystemClockStart(void);
+static void SystemClockComplete(void);
 
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+/**
+  * @brief  Start PLL from MSI 4 MHz (M1 N40 R2, 80 MHz) without waiting for
+  *         lock so that peripheral initialization overlaps the lock time.
+  *         Same clock tree as SystemClock_Config, VOS1 is the reset value.
+  * @retval None
+  */
+static void SystemClockStart(void)
+{
+  __HAL_RCC_PLL_CONFIG(RCC_PLLSOURCE_MSI, 1, 40, RCC_PLLP_DIV7, RCC_PLLQ_DIV2, RCC_PLLR_DIV2);
+  __HAL_RCC_PLL_ENABLE();
+  __HAL_RCC_PLLCLKOUT_ENABLE(RCC_PLL_SYSCLK);
+}
+
+/**
+  * @brief  Wait PLL lock and switch SYSCLK to PLL, wait states raised first
+  * @retval None
+  */
+static void SystemClockComplete(void)
+{
+  uint32_t tickStart = HAL_GetTick();
+
+  while(__HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) == 0)
+  {
+    if((HAL_GetTick() - tickStart) > PLL_LOCK_TIMEOUT)
+    {
+      Error_Handler();
+    }
+  }
+
+  __HAL_FLASH_SET_LATENCY(FLASH_LATENCY_4);
+  if(__HAL_FLASH_GET_LATENCY() != FLASH_LATENCY_4)
+  {
+    Error_Handler();
+  }
+
+  __HAL_RCC_SYSCLK_CONFIG(RCC_SYSCLKSOURCE_PLLCLK);
+  while(__HAL_RCC_GET_SYSCLK_SOURCE() != RCC_SYSCLKSOURCE_STATUS_PLLCLK)
+  {
+  }
+
+  SystemCoreClockUpdate();
+  if(HAL_InitTick(uwTickPrio) != HAL_OK)
+  {
+    Error_Handler();
+  }
+}
 
 /* USER CODE END 0 */
 
@@ -67,6 +119,7 @@ void SystemClock_Config(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
+  sBootProfiler.Start();
 
   /* USER CODE END 1 */
 
@@ -76,19 +129,27 @@ int main(void)
   HAL_Init();
 
   /* USER CODE BEGIN Init */
+  sBootProfiler.Stamp(halInitBootPhase);
+  sMemoryProtection.Initialize();
 
   /* USER CODE END Init */
 
-  /* Configure the system clock */
-  SystemClock_Config();
-
   /* USER CODE BEGIN SysInit */
+  /* The .ioc sets "Do Not Generate Function Call" for SystemClock_Config,
+     MX_GPIO_Init and MX_TIM6_Init, they are called here. PLL lock overlaps
+     GPIO initialization, see SystemClockStart */
+  SystemClockStart();
+  sBootProfiler.Stamp(pllStartBootPhase);
+  MX_GPIO_Init();
+  sBootProfiler.Stamp(gpioBootPhase);
+  SystemClockComplete();
+  sBootProfiler.Stamp(clockSwitchBootPhase);
+  MX_TIM6_Init();
+  sBootProfiler.Stamp(timerBootPhase);
 
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
-  MX_GPIO_Init();
-  MX_TIM6_Init();
   /* USER CODE BEGIN 2 */
 
   /* USER CODE END 2 */
@@ -164,7 +225,7 @@ void Error_Handler(void)
 {
   /* USER CODE BEGIN Error_Handler_Debug */
   /* User can add his own implementation to report the HAL error return state */
-
+  sFaultCapture.Error((uint32_t)__builtin_return_address(0));
   /* USER CODE END Error_Handler_Debug */
 }
 
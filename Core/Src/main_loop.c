@@ -12,31 +12,72 @@
 #include "software_timer.h"
 #include "state_machine.h"
 #include "gpio.h"
+#include "cycle_counter.h"
+#include "fast_interrupt.h"
+#include "latency_trace.h"
+#include "exti_guard.h"
+#include "pulse_counter.h"
+#include "coin_capture.h"
+#include "flash_journal.h"
+#include "boot_profiler.h"
+#include "clock_governor.h"
+#include "scheduler.h"
+#include "fault_capture.h"
+#include "lazy_init.h"
+#include "log.h"
 
 /*******************************************************************************
  * CONSTANTS
  ******************************************************************************/
 #define DEBOUNCE_DELAY	50
+#define LOG_MODULE		LOG_MODULE_MAIN_LOOP
+#define DEBOUNCE_NO_TIMER	0xFF
+#define DEBOUNCE_NO_INPUT	0xFF
+// Periodic events that do not count as load for the clock governor
+#define IDLE_EVENT_FLAGS	(((uint64_t)0x01 << clockGovernorEventFlag) | ((uint64_t)0x01 << telemetryEventFlag))
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Debounce state of an EXTI line
+typedef struct
+{
+	eDEBOUNCE_INPUT eInput;
+	uint8_t timerId;
+}
+sDEBOUNCE_LINE;
 
 /*******************************************************************************
  * PUBLIC VARIABLES
  ******************************************************************************/
-volatile uint32_t eventFlags = 0;
+// Any event flag may serve an input, add a line here to add an input
+const sDEBOUNCE_INPUT sDebounceInput[maximumDebounceInput] =
+{
+	[coinDebounceInput] = {"Coin", INSERT_COIN_GPIO_Port, INSERT_COIN_Pin, coinInsertEventFlag},
+	[buttonDebounceInput] = {"Button", BUTTON_GPIO_Port, BUTTON_Pin, buttonPressedEventFlag},
+};
 
 /*******************************************************************************
  * LOCAL VARIABLES
  ******************************************************************************/
-uint8_t debounceTimerId[2];
+// Indexed by EXTI line, lines without input keep DEBOUNCE_NO_TIMER
+static sDEBOUNCE_LINE sDebounceLine[16];
+// Input of every event flag, DEBOUNCE_NO_INPUT for other events
+static uint8_t debounceInputOf[maximumEventFlag];
 
 /*******************************************************************************
  * @fn      DebounceTimerCallback
  * @brief   Debounce timer callback
  * @paramz  softwareTimerId
+ *          arg		Input
  * @return  None
  ******************************************************************************/
-void DebounceTimerCallback(uint8_t softwareTimerId)
+static void DebounceTimerCallback(uint8_t softwareTimerId, void *arg)
 {
-	eventFlags |= (0x01 << softwareTimerId);
+	eDEBOUNCE_INPUT eInput = (eDEBOUNCE_INPUT)(uintptr_t)arg;
+
+	sLatencyTrace.Stamp(eInput, debounceLatencyStage);
+	sEventFlag.Set(sDebounceInput[eInput].eEventFlag);
 }
 
 /*******************************************************************************
@@ -47,12 +88,23 @@ void DebounceTimerCallback(uint8_t softwareTimerId)
  ******************************************************************************/
 static void InsertCoinEventFlag(void);
 static void ButtonPressedEventFlag(void);
+static void CoinPulseEventFlag(void);
+static void CoinCaptureEventFlag(void);
+static void FlashJournalEventFlag(void);
+static void ClockGovernorEventFlag(void);
+static void DispensingTimerEventFlag(void);
 
-// Initial event flag jump table
-static void (*EventFlags[])(void) =
+// Tasks of event flags served by main loop, other modules register their own.
+// Deadline in ms after the flag is seen, budget in us of execution time
+static const sSCHEDULER_TASK sEventTask[maximumEventFlag] =
 {
-	InsertCoinEventFlag,
-	ButtonPressedEventFlag,
+	[coinInsertEventFlag] =			{"coinInsert",		InsertCoinEventFlag,		10,		2000},
+	[buttonPressedEventFlag] =		{"buttonPressed",	ButtonPressedEventFlag,		10,		2000},
+	[coinPulseEventFlag] =			{"coinPulse",		CoinPulseEventFlag,			10,		2000},
+	[coinCaptureEventFlag] =		{"coinCapture",		CoinCaptureEventFlag,		10,		4000},
+	[flashJournalEventFlag] =		{"flashJournal",	FlashJournalEventFlag,		5,		500},
+	[clockGovernorEventFlag] =		{"clockGovernor",	ClockGovernorEventFlag,		100,	500},
+	[dispensingTimerEventFlag] =	{"dispensingTimer",	DispensingTimerEventFlag,	20,		2000},
 };
 
 /*******************************************************************************
@@ -66,6 +118,11 @@ static void InsertCoinEventFlag(void)
 	if(HAL_GPIO_ReadPin(INSERT_COIN_GPIO_Port, INSERT_COIN_Pin) == GPIO_PIN_RESET)
 	{
 		sStateMachine.InsertCoin();
+		sLatencyTrace.Stamp(coinDebounceInput, stateLatencyStage);
+	}
+	else
+	{
+		sLatencyTrace.Abort(coinDebounceInput);
 	}
 }
 
@@ -80,7 +137,95 @@ static void ButtonPressedEventFlag(void)
 	if(HAL_GPIO_ReadPin(BUTTON_GPIO_Port, BUTTON_Pin) == GPIO_PIN_RESET)
 	{
 		sStateMachine.DispenseButtonPressed();
+		sLatencyTrace.Stamp(buttonDebounceInput, stateLatencyStage);
+	}
+	else
+	{
+		sLatencyTrace.Abort(buttonDebounceInput);
+	}
+}
+
+/*******************************************************************************
+ * @fn      CoinPulseEventFlag
+ * @brief   Coin pulse train counted by LPTIM completed
+ * @paramz  None
+ * @return  None
+ ******************************************************************************/
+static void CoinPulseEventFlag(void)
+{
+	uint32_t numOfPulse = sPulseCounter.Take();
+
+	if(numOfPulse > 0)
+	{
+		sStateMachine.InsertCoins(numOfPulse);
+	}
+}
+
+/*******************************************************************************
+ * @fn      CoinCaptureEventFlag
+ * @brief   Classify captured coin pulses by width
+ * @paramz  None
+ * @return  None
+ ******************************************************************************/
+static void CoinCaptureEventFlag(void)
+{
+	sCOIN_CAPTURE_EVENT sEvent[8];
+	uint8_t numOfEvent = 0;
+	uint8_t i = 0;
+
+	do
+	{
+		numOfEvent = sCoinCapture.Classify(sEvent, sizeof(sEvent) / sizeof(sEvent[0]));
+		for(i = 0; i < numOfEvent; i++)
+		{
+			LOG_DEBUG("Coin pulse %lu us, value %d\n", (unsigned long)sEvent[i].width, sEvent[i].value);
+			sStateMachine.InsertCoins(sEvent[i].value);
+		}
+	}
+	while(numOfEvent == sizeof(sEvent) / sizeof(sEvent[0]));
+}
+
+/*******************************************************************************
+ * @fn      FlashJournalEventFlag
+ * @brief   Start next flash journal operation
+ * @paramz  None
+ * @return  None
+ ******************************************************************************/
+static void FlashJournalEventFlag(void)
+{
+	sFlashJournal.Process();
+}
+
+/*******************************************************************************
+ * @fn      ClockGovernorEventFlag
+ * @brief   No event for idle period, drop clock while waiting for customer
+ * @paramz  None
+ * @return  None
+ ******************************************************************************/
+static void ClockGovernorEventFlag(void)
+{
+	eMACHINE_STATUS eMachineStatus = sStateMachine.GetStatus();
+
+	if(eMachineStatus == acceptCoinMachineStatus || eMachineStatus == enoughCoinMachineStatus)
+	{
+		sClockGovernor.Idle();
 	}
+	else
+	{
+		// Dispensing in progress, check again after next idle period
+		sClockGovernor.Busy();
+	}
+}
+
+/*******************************************************************************
+ * @fn      DispensingTimerEventFlag
+ * @brief   Dispensing timer expired
+ * @paramz  None
+ * @return  None
+ ******************************************************************************/
+static void DispensingTimerEventFlag(void)
+{
+	sStateMachine.DispensingTimeout();
 }
 
 /*******************************************************************************
@@ -94,34 +239,89 @@ static void ButtonPressedEventFlag(void)
 // https://blog.csdn.net/liangsir_l/article/details/50707864
 void MainLoop(void)
 {
+    uint64_t pendingFlags = 0;
     uint8_t i = 0;
+    uint8_t input = 0;
+    bool bootReported = false;
+
+    // Cycle counter for cost measurement, latency stamps have their own timer
+    sCycleCounter.Enable();
+    sLatencyTrace.Initialize();
+
+    // Modules register their event flag tasks in initialize
+    sScheduler.Initialize();
+    for(i = 0; i < maximumEventFlag; i++)
+    {
+    	if(sEventTask[i].Run != NULL)
+    	{
+    		sScheduler.Register(i, &sEventTask[i]);
+    	}
+    }
+
+    // Dump fault record left by last reset, console sends it once up
+    sFaultCapture.Initialize();
 
     // Enable software timer
     sSoftwareTimer.Enable();
 
-    for(i = 0; i < 2; i++)
+    for(i = 0; i < sizeof(sDebounceLine) / sizeof(sDebounceLine[0]); i++)
     {
-  	  debounceTimerId[i] = sSoftwareTimer.Initialize(NULL, DebounceTimerCallback, NULL, TIMER_ONCE_TYPE);
+    	sDebounceLine[i].timerId = DEBOUNCE_NO_TIMER;
     }
+    memset(debounceInputOf, DEBOUNCE_NO_INPUT, sizeof(debounceInputOf));
+    for(i = 0; i < maximumDebounceInput; i++)
+    {
+    	debounceInputOf[sDebounceInput[i].eEventFlag] = i;
+    	sDebounceLine[POSITION_VAL(sDebounceInput[i].gpioPin)].eInput = i;
+    	sDebounceLine[POSITION_VAL(sDebounceInput[i].gpioPin)].timerId =
+    		sSoftwareTimer.Initialize(NULL, DebounceTimerCallback, NULL, TIMER_ONCE_TYPE, (void *)(uintptr_t)i);
+    }
+
+    sExtiGuard.Initialize();
 
     sStateMachine.Initialize();
+    sClockGovernor.Initialize();
+    // Console, ITM, LPTIM, TIM2 and telemetry follow in idle slots
+    sBootProfiler.Stamp(applicationBootPhase);
 
     for(;;)
     {
-        if(eventFlags != 0)
-        {
-            for(i = 0; i < maximumEventFlag; i++)
-            {
-            	// Detected event flag
-                if(((eventFlags >> i) & 0x01) == 0x01)
-                {
-                	// Call related function through jump table
-                    (*EventFlags[i])();
-                    // Clear event flag
-                    eventFlags &= (~(0x01 << i));
-                }
-            }
-        }
+    	// Take raised event flags, tasks of both words become ready
+    	pendingFlags = sEventFlag.FetchAndClearAll();
+    	sScheduler.Release(0, (uint32_t)pendingFlags);
+    	sScheduler.Release(1, (uint32_t)(pendingFlags >> 32));
+
+    	// Run one task with earliest deadline, then look for new flags
+    	i = sScheduler.Next();
+    	if(i == SCHEDULER_NO_TASK)
+    	{
+    		if(sLazyInit.Idle())
+    		{
+    			continue;
+    		}
+    		// Nothing ready, sleep until an interrupt raises a flag. DWT stops
+    		// in sleep, latency stamps run on their timer so sleep is safe
+    		sEventFlag.WaitAny(UINT64_MAX);
+    		continue;
+    	}
+    	input = i < maximumEventFlag ? debounceInputOf[i] : DEBOUNCE_NO_INPUT;
+    	if(input != DEBOUNCE_NO_INPUT)
+    	{
+    		sLatencyTrace.Stamp(input, dispatchLatencyStage);
+    	}
+    	// Handle event at full clock
+    	if(((IDLE_EVENT_FLAGS >> i) & 0x01) == 0)
+    	{
+    		sClockGovernor.Busy();
+    	}
+    	sScheduler.Run(i);
+    	// Boot ends at the first handled coin or button
+    	if(input != DEBOUNCE_NO_INPUT && !bootReported)
+    	{
+    		sBootProfiler.Stamp(firstEventBootPhase);
+    		sBootProfiler.Print();
+    		bootReported = true;
+    	}
     }
 }
 
@@ -136,15 +336,24 @@ void MainLoop(void)
  ******************************************************************************/
 void HAL_GPIO_EXTI_Callback(uint16_t gpioPin)
 {
-	switch(gpioPin)
+	// One pin per callback, EXTI line is its bit position
+	const sDEBOUNCE_LINE *psLine = &sDebounceLine[POSITION_VAL(gpioPin)];
+
+#if !FAST_INTERRUPT_ENABLE
+	// Fast path records latency before calling this callback
+	FastInterruptMark(extiFastInterrupt);
+#endif
+	if(psLine->timerId == DEBOUNCE_NO_TIMER)
+	{
+		return;
+	}
+	sLatencyTrace.Stamp(psLine->eInput, edgeLatencyStage);
+	if(sExtiGuard.Edge(psLine->eInput))
+	{
+		sSoftwareTimer.Start(psLine->timerId, DEBOUNCE_DELAY);
+	}
+	else
 	{
-		case INSERT_COIN_Pin:
-			sSoftwareTimer.Start(debounceTimerId[0], DEBOUNCE_DELAY);
-			break;
-		case BUTTON_Pin:
-			sSoftwareTimer.Start(debounceTimerId[1], DEBOUNCE_DELAY);
-			break;
-		default:
-			break;
+		sSoftwareTimer.Stop(psLine->timerId);
 	}
 }
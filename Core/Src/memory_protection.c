@@ -0,0 +1,309 @@
+/*******************************************************************************
+ * Filename:			memory_protection.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    MPU stack guard, read only flash and execute never RAM
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "memory_protection.h"
+#include "cycle_counter.h"
+#include "log.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Linker symbols
+extern uint32_t _end;
+extern uint32_t _estack;
+extern uint32_t _Min_Stack_Size;
+extern uint32_t _sjournal;
+
+#define JOURNAL_START			((uint32_t)&_sjournal)
+#define GUARD_ALIGN(address)	(((address) + STACK_GUARD_SIZE - 1) & ~(STACK_GUARD_SIZE - 1))
+// Frames of painting function and an interrupt stay unpainted
+#define STACK_PAINT_MARGIN		64
+#define MPU_BENCHMARK_RUN		1000
+#define MPU_BENCHMARK_TABLE		4
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define memory protection property structure
+typedef struct
+{
+	uint32_t guard;					// Stack guard base, 0 until heap end is known
+}
+sMEMORY_PROTECTION_PRO;
+static sMEMORY_PROTECTION_PRO sMemoryProtectionPro;
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static const char *const mpuRegionName[maximumMpuRegion] = {"flash", "journal", "sram1", "sram2", "stack guard"};
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void MemoryProtectionInitialize(void);
+static bool MemoryProtectionHeapGrow(uint32_t heapEnd);
+static void MemoryProtectionBenchmark(void);
+static void MemoryProtectionPrint(void);
+
+/*******************************************************************************
+ * @fn      MemoryProtectionRegion
+ * @brief   Configure one region, normal memory
+ * @param   eMpuRegion
+ *          base			Aligned to size
+ *          size			MPU_REGION_SIZE_x
+ *          permission		MPU_REGION_x
+ *          executeNever
+ *          bufferable		RAM, flash is written through
+ * @return  None
+ ******************************************************************************/
+static void MemoryProtectionRegion(eMPU_REGION eMpuRegion, uint32_t base, uint8_t size, uint8_t permission,
+								   bool executeNever, bool bufferable)
+{
+	MPU_Region_InitTypeDef sRegion = {0};
+
+	sRegion.Enable = MPU_REGION_ENABLE;
+	sRegion.Number = eMpuRegion;
+	sRegion.BaseAddress = base;
+	sRegion.Size = size;
+	sRegion.SubRegionDisable = 0x00;
+	sRegion.TypeExtField = MPU_TEX_LEVEL0;
+	sRegion.AccessPermission = permission;
+	sRegion.DisableExec = executeNever ? MPU_INSTRUCTION_ACCESS_DISABLE : MPU_INSTRUCTION_ACCESS_ENABLE;
+	sRegion.IsShareable = MPU_ACCESS_NOT_SHAREABLE;
+	sRegion.IsCacheable = MPU_ACCESS_CACHEABLE;
+	sRegion.IsBufferable = bufferable ? MPU_ACCESS_BUFFERABLE : MPU_ACCESS_NOT_BUFFERABLE;
+	HAL_MPU_ConfigRegion(&sRegion);
+}
+
+/*******************************************************************************
+ * @fn      MemoryProtectionGuard
+ * @brief   Place no access guard, moved up as heap grows
+ * @param   guard	Aligned to STACK_GUARD_SIZE
+ * @return  None
+ ******************************************************************************/
+static void MemoryProtectionGuard(uint32_t guard)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	sMemoryProtectionPro.guard = guard;
+	if(!MEMORY_PROTECTION_ENABLE || (MPU->CTRL & MPU_CTRL_ENABLE_Msk) == 0)
+	{
+		return;
+	}
+	__disable_irq();
+	MemoryProtectionRegion(stackGuardMpuRegion, guard, MPU_REGION_SIZE_32B, MPU_REGION_NO_ACCESS, true, true);
+	__DSB();
+	__ISB();
+	__set_PRIMASK(primask);
+}
+
+/*******************************************************************************
+ * @fn      MemoryProtectionStackPaint
+ * @brief   Fill free stack between guard and stack in use with pattern
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void MemoryProtectionStackPaint(void)
+{
+	uint32_t *word = (uint32_t *)(sMemoryProtectionPro.guard + STACK_GUARD_SIZE);
+	uint32_t primask = __get_PRIMASK();
+
+	// No interrupt frame is stacked into painted words meanwhile
+	__disable_irq();
+	while((uint32_t)word < __get_MSP() - STACK_PAINT_MARGIN)
+	{
+		*word++ = STACK_PAINT_PATTERN;
+	}
+	__set_PRIMASK(primask);
+}
+
+/*******************************************************************************
+ * @fn      MemoryProtectionStackUsed
+ * @brief   Stack high water, from top of stack to lowest overwritten word
+ * @param   None
+ * @return  Bytes
+ ******************************************************************************/
+static uint32_t MemoryProtectionStackUsed(void)
+{
+	const uint32_t *word = (const uint32_t *)(sMemoryProtectionPro.guard + STACK_GUARD_SIZE);
+
+	while((uint32_t)word < (uint32_t)&_estack && *word == STACK_PAINT_PATTERN)
+	{
+		word++;
+	}
+	return (uint32_t)&_estack - (uint32_t)word;
+}
+
+/*******************************************************************************
+ * @fn      MemoryProtectionInitialize
+ * @brief   Flash read only except journal, RAM execute never when code runs
+ *          from flash, no access guard just above heap end. Peripherals
+ *          and system space keep default map
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void MemoryProtectionInitialize(void)
+{
+	uint32_t code = (uint32_t)&MemoryProtectionInitialize;
+	// RAM linker script runs code from SRAM1
+	bool flashCode = code >= FLASH_BASE && code <= FLASH_END;
+
+	// Heap may have grown already, e.g. by printf buffer
+	if(sMemoryProtectionPro.guard == 0)
+	{
+		sMemoryProtectionPro.guard = GUARD_ALIGN((uint32_t)&_end);
+	}
+	MemoryProtectionStackPaint();
+	if(!MEMORY_PROTECTION_ENABLE)
+	{
+		return;
+	}
+	HAL_MPU_Disable();
+	// Function tables and sXxx structures are const, a stray write faults
+	MemoryProtectionRegion(flashMpuRegion, FLASH_BASE, MPU_REGION_SIZE_1MB, MPU_REGION_PRIV_RO, false, false);
+	// Flash journal programs through data writes
+	MemoryProtectionRegion(journalMpuRegion, JOURNAL_START, MPU_REGION_SIZE_32KB, MPU_REGION_FULL_ACCESS, true, false);
+	MemoryProtectionRegion(sram1MpuRegion, SRAM1_BASE, MPU_REGION_SIZE_128KB, MPU_REGION_FULL_ACCESS, flashCode, true);
+	MemoryProtectionRegion(sram2MpuRegion, SRAM2_BASE, MPU_REGION_SIZE_32KB, MPU_REGION_FULL_ACCESS, flashCode, true);
+	// Stack may use all RAM down to guard, _Min_Stack_Size is no limit
+	MemoryProtectionRegion(stackGuardMpuRegion, sMemoryProtectionPro.guard, MPU_REGION_SIZE_32B, MPU_REGION_NO_ACCESS,
+						   true, true);
+	// MPU stays off in HardFault, fault capture still reads guard
+	HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
+}
+
+/*******************************************************************************
+ * @fn      MemoryProtectionHeapGrow
+ * @brief   Called by _sbrk before heap grows, guard moves up to new heap
+ *          end. Heap keeps _Min_Stack_Size away from stack in use
+ * @param   heapEnd
+ * @return  true	Heap may grow
+ *          false	Out of memory
+ ******************************************************************************/
+static bool MemoryProtectionHeapGrow(uint32_t heapEnd)
+{
+	uint32_t guard = GUARD_ALIGN(heapEnd);
+
+	if(guard + STACK_GUARD_SIZE + (uint32_t)&_Min_Stack_Size > __get_MSP())
+	{
+		return false;
+	}
+	if(guard > sMemoryProtectionPro.guard)
+	{
+		MemoryProtectionGuard(guard);
+	}
+	return true;
+}
+
+/*******************************************************************************
+ * BENCHMARK FUNCTIONS
+ ******************************************************************************/
+static void MemoryProtectionBenchmarkEntry(void)
+{
+}
+
+static void (*const mpuFlashTable[MPU_BENCHMARK_TABLE])(void) =
+{
+	MemoryProtectionBenchmarkEntry,
+	MemoryProtectionBenchmarkEntry,
+	MemoryProtectionBenchmarkEntry,
+	MemoryProtectionBenchmarkEntry,
+};
+static void (*mpuRamTable[MPU_BENCHMARK_TABLE])(void) =
+{
+	MemoryProtectionBenchmarkEntry,
+	MemoryProtectionBenchmarkEntry,
+	MemoryProtectionBenchmarkEntry,
+	MemoryProtectionBenchmarkEntry,
+};
+// Table hidden from compiler, every call loads its entry
+static void (*const *volatile mpuBenchmarkTable)(void);
+
+/*******************************************************************************
+ * @fn      MemoryProtectionDispatchCycle
+ * @brief   Cycles of a call through table entry
+ * @param   table
+ * @return  Cycles per call
+ ******************************************************************************/
+static uint32_t MemoryProtectionDispatchCycle(void (*const *table)(void))
+{
+	uint32_t startCycle = 0;
+	uint32_t i = 0;
+
+	mpuBenchmarkTable = table;
+	startCycle = CYCLE_COUNTER_READ();
+	for(i = 0; i < MPU_BENCHMARK_RUN; i++)
+	{
+		mpuBenchmarkTable[i & (MPU_BENCHMARK_TABLE - 1)]();
+	}
+	return (CYCLE_COUNTER_READ() - startCycle) / MPU_BENCHMARK_RUN;
+}
+
+/*******************************************************************************
+ * @fn      MemoryProtectionBenchmark
+ * @brief   Dispatch through table in RAM against same table in flash, at
+ *          current clock and flash wait states. ART data cache hides
+ *          flash latency after first access
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void MemoryProtectionBenchmark(void)
+{
+	uint32_t ramCycle = 0;
+	uint32_t flashCycle = 0;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	ramCycle = MemoryProtectionDispatchCycle(mpuRamTable);
+	flashCycle = MemoryProtectionDispatchCycle(mpuFlashTable);
+	__set_PRIMASK(primask);
+
+	sLog.Printf("Dispatch: RAM table %lu, flash table %lu cycles per call, %lu Hz, %lu wait states\n",
+			(unsigned long)ramCycle, (unsigned long)flashCycle, (unsigned long)SystemCoreClock,
+			(unsigned long)(FLASH->ACR & FLASH_ACR_LATENCY));
+}
+
+/*******************************************************************************
+ * @fn      MemoryProtectionPrint
+ * @brief   Print regions from MPU registers
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void MemoryProtectionPrint(void)
+{
+	uint32_t rasr = 0;
+	uint8_t i = 0;
+
+	sLog.Printf("MPU %s, stack guard 0x%08lX, stack pointer 0x%08lX\n", (MPU->CTRL & MPU_CTRL_ENABLE_Msk) ? "on" : "off",
+			(unsigned long)sMemoryProtectionPro.guard, (unsigned long)__get_MSP());
+	sLog.Printf("Stack high water %lu of %lu bytes\n", (unsigned long)MemoryProtectionStackUsed(),
+			(unsigned long)((uint32_t)&_estack - sMemoryProtectionPro.guard - STACK_GUARD_SIZE));
+	for(i = 0; i < maximumMpuRegion; i++)
+	{
+		MPU->RNR = i;
+		rasr = MPU->RASR;
+		if((rasr & MPU_RASR_ENABLE_Msk) == 0)
+		{
+			continue;
+		}
+		sLog.Printf("%-12s 0x%08lX %7lu bytes AP %lu%s\n", mpuRegionName[i], (unsigned long)(MPU->RBAR & MPU_RBAR_ADDR_Msk),
+				(unsigned long)0x02 << ((rasr & MPU_RASR_SIZE_Msk) >> MPU_RASR_SIZE_Pos),
+				(unsigned long)((rasr & MPU_RASR_AP_Msk) >> MPU_RASR_AP_Pos), (rasr & MPU_RASR_XN_Msk) ? " XN" : "");
+	}
+}
+
+// Memory protection function structure
+const sMEMORY_PROTECTION sMemoryProtection =
+{
+	MemoryProtectionInitialize,
+	MemoryProtectionHeapGrow,
+	MemoryProtectionBenchmark,
+	MemoryProtectionPrint,
+};
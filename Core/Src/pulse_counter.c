@@ -0,0 +1,238 @@
+/*******************************************************************************
+ * Filename:			pulse_counter.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    LPTIM hardware coin pulse counter function
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "pulse_counter.h"
+#include "software_timer.h"
+#include "main_loop.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define NUM_OF_PULSE_CHANNEL	2
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Pulse counter channel hardware
+typedef struct
+{
+	LPTIM_TypeDef *lptim;
+	IRQn_Type irq;
+	GPIO_TypeDef *port;
+	uint16_t pin;
+	uint8_t alternate;
+}
+sPULSE_CHANNEL;
+
+// Define pulse counter property structure
+typedef struct
+{
+	uint8_t timerId;
+	uint16_t lastCount[NUM_OF_PULSE_CHANNEL];
+	uint32_t trainPulse[NUM_OF_PULSE_CHANNEL];
+	uint8_t idleTick[NUM_OF_PULSE_CHANNEL];
+	volatile uint32_t completedPulse;
+}
+sPULSE_COUNTER_PRO;
+static sPULSE_COUNTER_PRO sPulseCounterPro;
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static const sPULSE_CHANNEL sPulseChannel[NUM_OF_PULSE_CHANNEL] =
+{
+	{LPTIM1, LPTIM1_IRQn, COIN_PULSE1_GPIO_Port, COIN_PULSE1_Pin, COIN_PULSE1_AF},
+	{LPTIM2, LPTIM2_IRQn, COIN_PULSE2_GPIO_Port, COIN_PULSE2_Pin, COIN_PULSE2_AF},
+};
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void PulseCounterInitialize(void);
+static uint32_t PulseCounterTake(void);
+
+/*******************************************************************************
+ * @fn      PulseCounterRead
+ * @brief   Read counter, CNT is asynchronous to APB so read until stable
+ * @param   lptim
+ * @return  Counter value
+ ******************************************************************************/
+static uint16_t PulseCounterRead(LPTIM_TypeDef *lptim)
+{
+	uint32_t count = 0;
+
+	do
+	{
+		count = lptim->CNT;
+	}
+	while(count != lptim->CNT);
+	return (uint16_t)count;
+}
+
+/*******************************************************************************
+ * @fn      PulseCounterUpdate
+ * @brief   Add pulses counted since last read to the current train
+ * @param   channel
+ * @return  Number of new pulses
+ ******************************************************************************/
+static uint16_t PulseCounterUpdate(uint8_t channel)
+{
+	uint16_t count = PulseCounterRead(sPulseChannel[channel].lptim);
+	uint16_t numOfPulse = count - sPulseCounterPro.lastCount[channel];
+
+	sPulseCounterPro.lastCount[channel] = count;
+	sPulseCounterPro.trainPulse[channel] += numOfPulse;
+	return numOfPulse;
+}
+
+/*******************************************************************************
+ * @fn      PulseCounterComplete
+ * @brief   Hand completed train to main loop and arm next compare match
+ * @param   channel
+ * @return  None
+ ******************************************************************************/
+static void PulseCounterComplete(uint8_t channel)
+{
+	sPulseCounterPro.completedPulse += sPulseCounterPro.trainPulse[channel];
+	sPulseCounterPro.trainPulse[channel] = 0;
+	sPulseCounterPro.idleTick[channel] = 0;
+	sPulseChannel[channel].lptim->CMP = (uint16_t)(sPulseCounterPro.lastCount[channel] + PULSE_COUNTER_COMPARE);
+	sEventFlag.Set(coinPulseEventFlag);
+}
+
+/*******************************************************************************
+ * @fn      PulseCounterTimerCallback
+ * @brief   Read counters, a train ends after PULSE_COUNTER_TIMEOUT idle periods
+ * @param   softwareTimerId
+ *          arg
+ * @return  None
+ ******************************************************************************/
+static void PulseCounterTimerCallback(uint8_t softwareTimerId, void *arg)
+{
+	uint8_t i = 0;
+
+	for(i = 0; i < NUM_OF_PULSE_CHANNEL; i++)
+	{
+		if(PulseCounterUpdate(i) > 0)
+		{
+			sPulseCounterPro.idleTick[i] = 0;
+		}
+		else if(sPulseCounterPro.trainPulse[i] > 0 &&
+				++sPulseCounterPro.idleTick[i] >= PULSE_COUNTER_TIMEOUT)
+		{
+			PulseCounterComplete(i);
+		}
+	}
+}
+
+/*******************************************************************************
+ * @fn      PulseCounterInitialize
+ * @brief   Count falling edges of LPTIM Input1 with APB kernel clock
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void PulseCounterInitialize(void)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	LPTIM_TypeDef *lptim = NULL;
+	uint8_t i = 0;
+
+	if(!PULSE_COUNTER_ENABLE)
+	{
+		return;
+	}
+
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	__HAL_RCC_LPTIM1_CLK_ENABLE();
+	__HAL_RCC_LPTIM2_CLK_ENABLE();
+
+	for(i = 0; i < NUM_OF_PULSE_CHANNEL; i++)
+	{
+		lptim = sPulseChannel[i].lptim;
+
+		GPIO_InitStruct.Pin = sPulseChannel[i].pin;
+		GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+		GPIO_InitStruct.Pull = GPIO_PULLUP;
+		GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+		GPIO_InitStruct.Alternate = sPulseChannel[i].alternate;
+		HAL_GPIO_Init(sPulseChannel[i].port, &GPIO_InitStruct);
+
+		// CFGR and IER are only writable while LPTIM is disabled
+		lptim->CR = 0;
+		lptim->CFGR = LPTIM_CFGR_COUNTMODE | LPTIM_CFGR_CKPOL_0 | LPTIM_CFGR_CKFLT;
+		lptim->IER = LPTIM_IER_CMPMIE;
+		lptim->CR = LPTIM_CR_ENABLE;
+		lptim->ARR = 0xFFFF;
+		while((lptim->ISR & LPTIM_ISR_ARROK) == 0)
+		{
+		}
+		sPulseCounterPro.lastCount[i] = PulseCounterRead(lptim);
+		lptim->CMP = (uint16_t)(sPulseCounterPro.lastCount[i] + PULSE_COUNTER_COMPARE);
+		lptim->CR |= LPTIM_CR_CNTSTRT;
+
+		HAL_NVIC_SetPriority(sPulseChannel[i].irq, 0, 0);
+		HAL_NVIC_EnableIRQ(sPulseChannel[i].irq);
+	}
+
+	sPulseCounterPro.timerId = sSoftwareTimer.Initialize(NULL, PulseCounterTimerCallback, NULL, TIMER_PERIODIC_TYPE, NULL);
+	sSoftwareTimer.Start(sPulseCounterPro.timerId, PULSE_COUNTER_PERIOD);
+}
+
+/*******************************************************************************
+ * @fn      PulseCounterTake
+ * @brief   Take pulses of all completed trains
+ * @param   None
+ * @return  Number of pulses
+ ******************************************************************************/
+static uint32_t PulseCounterTake(void)
+{
+	uint32_t numOfPulse = 0;
+
+	__disable_irq();
+	numOfPulse = sPulseCounterPro.completedPulse;
+	sPulseCounterPro.completedPulse = 0;
+	__enable_irq();
+	return numOfPulse;
+}
+
+// Pulse counter function structure
+const sPULSE_COUNTER sPulseCounter =
+{
+	PulseCounterInitialize,
+	PulseCounterTake,
+};
+
+/*******************************************************************************
+ * INTERRUPT CALLBACK
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      PulseCounterInterruptCallback
+ * @brief   LPTIM compare match interrupt callback
+ * @param   lptim
+ * @return  None
+ ******************************************************************************/
+void PulseCounterInterruptCallback(LPTIM_TypeDef *lptim)
+{
+	uint8_t i = 0;
+
+	if((lptim->ISR & LPTIM_ISR_CMPM) == 0)
+	{
+		return;
+	}
+	lptim->ICR = LPTIM_ICR_CMPMCF | LPTIM_ICR_CMPOKCF;
+	for(i = 0; i < NUM_OF_PULSE_CHANNEL; i++)
+	{
+		if(sPulseChannel[i].lptim == lptim)
+		{
+			PulseCounterUpdate(i);
+			PulseCounterComplete(i);
+		}
+	}
+}
@@ -0,0 +1,188 @@
+/*******************************************************************************
+ * Filename:			region.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Orthogonal region state machine engine
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "region.h"
+#include "cycle_counter.h"
+#include "log.h"
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void RegionDispatch(sREGION_SET *psRegionSet, uint8_t event, uint32_t parameter);
+static bool RegionValid(const sREGION_SET *psRegionSet);
+static void RegionPrint(const sREGION_SET *psRegionSet);
+static void RegionBenchmark(void);
+
+/*******************************************************************************
+ * @fn      RegionToggle
+ * @brief   Benchmark region handler, flips between its two states
+ * @param   state
+ *          parameter
+ * @return  Next state
+ ******************************************************************************/
+static uint8_t RegionToggle(uint8_t state, uint32_t parameter)
+{
+	return state ^ 0x01;
+}
+
+// Benchmark region, two states by two events, event 0 toggles and event 1
+// is ignored so both engine paths are timed
+static const REGION_HANDLER regionToggleHandler[2 * 2] =
+{
+	RegionToggle, NULL,
+	RegionToggle, NULL,
+};
+
+/*******************************************************************************
+ * @fn      RegionDispatch
+ * @brief   Give one event to every region in turn. A region sees states
+ *          already changed by regions before it
+ * @param   psRegionSet
+ *          event
+ *          parameter
+ * @return  None
+ ******************************************************************************/
+static void RegionDispatch(sREGION_SET *psRegionSet, uint8_t event, uint32_t parameter)
+{
+	uint32_t startCycle = CYCLE_COUNTER_READ();
+	REGION_HANDLER handler = NULL;
+	uint32_t handlerCycle = 0;
+	uint32_t handlerStart = 0;
+	uint32_t cycle = 0;
+	uint8_t i = 0;
+
+	if(event >= psRegionSet->numOfEvent)
+	{
+		return;
+	}
+	for(i = 0; i < psRegionSet->numOfRegion; i++)
+	{
+		handler = psRegionSet->psRegion[i].handler[psRegionSet->state[i] * psRegionSet->numOfEvent + event];
+		if(handler != NULL)
+		{
+			handlerStart = CYCLE_COUNTER_READ();
+			psRegionSet->state[i] = handler(psRegionSet->state[i], parameter);
+			handlerCycle += CYCLE_COUNTER_READ() - handlerStart;
+			psRegionSet->sStatistic.handlerCount++;
+		}
+	}
+
+	cycle = CYCLE_COUNTER_READ() - startCycle;
+	psRegionSet->sStatistic.dispatchCount++;
+	psRegionSet->sStatistic.totalCycle += cycle;
+	cycle -= handlerCycle;
+	psRegionSet->sStatistic.engineCycle += cycle;
+	if(cycle > psRegionSet->sStatistic.maximumEngineCycle)
+	{
+		psRegionSet->sStatistic.maximumEngineCycle = cycle;
+	}
+}
+
+/*******************************************************************************
+ * @fn      RegionValid
+ * @brief   Every region state is in range, e.g. after restore
+ * @param   psRegionSet
+ * @return  true
+ *          false
+ ******************************************************************************/
+static bool RegionValid(const sREGION_SET *psRegionSet)
+{
+	uint8_t i = 0;
+
+	for(i = 0; i < psRegionSet->numOfRegion; i++)
+	{
+		if(psRegionSet->state[i] >= psRegionSet->psRegion[i].numOfState)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*******************************************************************************
+ * @fn      RegionPrint
+ * @brief   Print region states and dispatch cost, handlers included
+ * @param   psRegionSet
+ * @return  None
+ ******************************************************************************/
+static void RegionPrint(const sREGION_SET *psRegionSet)
+{
+	const sREGION_STATISTIC *psStatistic = &psRegionSet->sStatistic;
+	uint32_t average = 0;
+	uint32_t engine = 0;
+	uint8_t i = 0;
+
+	for(i = 0; i < psRegionSet->numOfRegion; i++)
+	{
+		sLog.Printf("%-12s state %d\n", psRegionSet->psRegion[i].name, psRegionSet->state[i]);
+	}
+	if(psStatistic->dispatchCount > 0)
+	{
+		average = psStatistic->totalCycle / psStatistic->dispatchCount;
+		engine = psStatistic->engineCycle / psStatistic->dispatchCount;
+	}
+	sLog.Printf("%d regions, %lu events, %lu handlers, %lu cycles/event\n", psRegionSet->numOfRegion,
+			(unsigned long)psStatistic->dispatchCount, (unsigned long)psStatistic->handlerCount,
+			(unsigned long)average);
+	sLog.Printf("Engine %lu cycles/event (max %lu), %lu cycles/region\n", (unsigned long)engine,
+			(unsigned long)psStatistic->maximumEngineCycle, (unsigned long)(engine / psRegionSet->numOfRegion));
+}
+
+/*******************************************************************************
+ * @fn      RegionBenchmark
+ * @brief   Dispatch cost per event as regions grow, same events through
+ *          sets of 1..REGION_BENCHMARK_REGION dummy regions
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void RegionBenchmark(void)
+{
+	sREGION sRegion[REGION_BENCHMARK_REGION];
+	uint8_t state[REGION_BENCHMARK_REGION];
+	sREGION_SET sRegionSet;
+	uint32_t average = 0;
+	uint32_t engine = 0;
+	uint32_t i = 0;
+	uint8_t n = 0;
+
+	for(i = 0; i < REGION_BENCHMARK_REGION; i++)
+	{
+		sRegion[i].name = "benchmark";
+		sRegion[i].numOfState = 2;
+		sRegion[i].handler = regionToggleHandler;
+	}
+	sLog.Printf("Regions cycles/event engine/event max engine/region\n");
+	for(n = 1; n <= REGION_BENCHMARK_REGION; n++)
+	{
+		memset(state, 0, sizeof(state));
+		memset(&sRegionSet, 0, sizeof(sRegionSet));
+		sRegionSet.psRegion = sRegion;
+		sRegionSet.state = state;
+		sRegionSet.numOfRegion = n;
+		sRegionSet.numOfEvent = 2;
+		for(i = 0; i < REGION_BENCHMARK_EVENT; i++)
+		{
+			RegionDispatch(&sRegionSet, i & 0x01, 0);
+		}
+		average = sRegionSet.sStatistic.totalCycle / REGION_BENCHMARK_EVENT;
+		engine = sRegionSet.sStatistic.engineCycle / REGION_BENCHMARK_EVENT;
+		sLog.Printf("%7d %12lu %12lu %4lu %13lu\n", n, (unsigned long)average, (unsigned long)engine,
+				(unsigned long)sRegionSet.sStatistic.maximumEngineCycle, (unsigned long)(engine / n));
+	}
+}
+
+// Region engine function structure
+const sREGION_ENGINE sRegionEngine =
+{
+	RegionDispatch,
+	RegionValid,
+	RegionPrint,
+	RegionBenchmark,
+};
@@ -9,10 +9,11 @@
  * INCLUDES
  ******************************************************************************/
 #include "common.h"
+#include "log.h"
 
 /*******************************************************************************
  * @fn      _write
- * @brief   Retaget printf to SWV ITM data console
+ * @brief   Retaget printf to SWV ITM data console and USART2 console
  * @param	file
  * 			ptr
  * 			len
@@ -20,10 +21,6 @@
  ******************************************************************************/
 uint32_t _write(uint32_t file, char *ptr, uint32_t len)
 {
-	uint32_t i = 0;
-	for(i = 0; i < len; i++)
-	{
-		ITM_SendChar((*ptr++));
-	}
+	sLog.Write(ptr, len);
 	return len;
 }
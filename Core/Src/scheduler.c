@@ -0,0 +1,350 @@
+/*******************************************************************************
+ * Filename:			scheduler.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Cooperative earliest deadline first scheduler
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "scheduler.h"
+#include "cycle_counter.h"
+#include "itm_trace.h"
+#include "log.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define SCHEDULER_BENCHMARK_RUN	100
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Registered tasks and ready queue
+typedef struct
+{
+	const sSCHEDULER_TASK *psTask[SCHEDULER_MAXIMUM_TASK];
+	uint32_t ready[SCHEDULER_NUM_OF_WORD];
+	uint32_t deadline[SCHEDULER_MAXIMUM_TASK];	// Absolute, HAL tick
+}
+sSCHEDULER_QUEUE;
+
+// Define scheduler property structure
+typedef struct
+{
+	sSCHEDULER_QUEUE sQueue;
+	uint64_t overrunMask;			// Tasks that missed deadline or budget
+	sSCHEDULER_STATISTIC sStatistic[SCHEDULER_MAXIMUM_TASK];
+}
+sSCHEDULER_PRO;
+static sSCHEDULER_PRO sSchedulerPro;
+
+// Queue of benchmark, kept apart from running tasks
+static sSCHEDULER_QUEUE sBenchmarkQueue;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void SchedulerInitialize(void);
+static void SchedulerRegister(uint8_t taskId, const sSCHEDULER_TASK *psTask);
+static void SchedulerRelease(uint8_t word, uint32_t taskMask);
+static uint8_t SchedulerNext(void);
+static void SchedulerRun(uint8_t taskId);
+static uint64_t SchedulerGetOverrun(void);
+static bool SchedulerGetStatistic(uint8_t taskId, sSCHEDULER_STATISTIC *psStatistic);
+static void SchedulerBenchmark(void);
+static void SchedulerPrint(void);
+
+/*******************************************************************************
+ * @fn      QueueRelease
+ * @brief   Make registered tasks ready, one CLZ per set bit. A task already
+ *          ready keeps its earlier deadline
+ * @param   psQueue
+ *          word
+ *          taskMask
+ *          now
+ * @return  None
+ ******************************************************************************/
+static void QueueRelease(sSCHEDULER_QUEUE *psQueue, uint8_t word, uint32_t taskMask, uint32_t now)
+{
+	uint8_t taskId = 0;
+	uint8_t bit = 0;
+
+	taskMask &= ~psQueue->ready[word];
+	while(taskMask != 0)
+	{
+		bit = 31 - __CLZ(taskMask);
+		taskMask &= ~((uint32_t)0x01 << bit);
+		taskId = word * 32 + bit;
+		if(psQueue->psTask[taskId] != NULL)
+		{
+			psQueue->deadline[taskId] = now + psQueue->psTask[taskId]->deadline;
+			psQueue->ready[word] |= ((uint32_t)0x01 << bit);
+		}
+	}
+}
+
+/*******************************************************************************
+ * @fn      QueueNext
+ * @brief   Ready task with earliest deadline, visits set bits only
+ * @param   psQueue
+ * @return  Task ID, SCHEDULER_NO_TASK when none is ready
+ ******************************************************************************/
+static uint8_t QueueNext(const sSCHEDULER_QUEUE *psQueue)
+{
+	uint8_t taskId = SCHEDULER_NO_TASK;
+	uint32_t ready = 0;
+	uint8_t word = 0;
+	uint8_t bit = 0;
+
+	for(word = SCHEDULER_NUM_OF_WORD; word-- > 0;)
+	{
+		ready = psQueue->ready[word];
+		// High bits first, so a lower ID with the same deadline replaces it
+		while(ready != 0)
+		{
+			bit = 31 - __CLZ(ready);
+			ready &= ~((uint32_t)0x01 << bit);
+			// Wrap safe compare of HAL ticks
+			if(taskId == SCHEDULER_NO_TASK ||
+			   (int32_t)(psQueue->deadline[word * 32 + bit] - psQueue->deadline[taskId]) <= 0)
+			{
+				taskId = word * 32 + bit;
+			}
+		}
+	}
+	return taskId;
+}
+
+/*******************************************************************************
+ * @fn      SchedulerInitialize
+ * @brief   Clear task table, modules register their tasks afterwards
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void SchedulerInitialize(void)
+{
+	memset(&sSchedulerPro, 0, sizeof(sSchedulerPro));
+}
+
+/*******************************************************************************
+ * @fn      SchedulerRegister
+ * @brief   Register task of an event flag, task ID is the event flag
+ * @param   taskId
+ *          psTask
+ * @return  None
+ ******************************************************************************/
+static void SchedulerRegister(uint8_t taskId, const sSCHEDULER_TASK *psTask)
+{
+	if(taskId >= SCHEDULER_MAXIMUM_TASK || sSchedulerPro.sQueue.psTask[taskId] != NULL)
+	{
+		// Task ID used twice or beyond "SCHEDULER_MAXIMUM_TASK"
+		for(;;)
+		{
+		}
+	}
+	sSchedulerPro.sQueue.psTask[taskId] = psTask;
+}
+
+/*******************************************************************************
+ * @fn      SchedulerRelease
+ * @brief   Make tasks of one ready word ready
+ * @param   word		Task IDs word * 32 to word * 32 + 31
+ *          taskMask
+ * @return  None
+ ******************************************************************************/
+static void SchedulerRelease(uint8_t word, uint32_t taskMask)
+{
+	if(word < SCHEDULER_NUM_OF_WORD && taskMask != 0)
+	{
+		QueueRelease(&sSchedulerPro.sQueue, word, taskMask, HAL_GetTick());
+	}
+}
+
+/*******************************************************************************
+ * @fn      SchedulerNext
+ * @brief   Ready task with earliest deadline
+ * @param   None
+ * @return  Task ID, SCHEDULER_NO_TASK when none is ready
+ ******************************************************************************/
+static uint8_t SchedulerNext(void)
+{
+	return QueueNext(&sSchedulerPro.sQueue);
+}
+
+/*******************************************************************************
+ * @fn      SchedulerRun
+ * @brief   Run ready task to completion, flag deadline miss and overrun
+ * @param   taskId
+ * @return  None
+ ******************************************************************************/
+static void SchedulerRun(uint8_t taskId)
+{
+	const sSCHEDULER_TASK *psTask = NULL;
+	sSCHEDULER_STATISTIC *psStatistic = NULL;
+	uint32_t startCycle = 0;
+	uint32_t endCycle = 0;
+	uint32_t time = 0;
+
+	if(taskId >= SCHEDULER_MAXIMUM_TASK || sSchedulerPro.sQueue.psTask[taskId] == NULL)
+	{
+		return;
+	}
+	psTask = sSchedulerPro.sQueue.psTask[taskId];
+	psStatistic = &sSchedulerPro.sStatistic[taskId];
+	sSchedulerPro.sQueue.ready[taskId / 32] &= ~((uint32_t)0x01 << (taskId % 32));
+	startCycle = CYCLE_COUNTER_READ();
+	sItmTrace.Word(profileItmChannel, ITM_TRACE_PROFILE(taskId, 0, startCycle));
+	psTask->Run();
+	endCycle = CYCLE_COUNTER_READ();
+	sItmTrace.Word(profileItmChannel, ITM_TRACE_PROFILE(taskId, 1, endCycle));
+	// Clock may change inside a task, time is an estimate at current clock
+	time = (endCycle - startCycle) / (SystemCoreClock / 1000000);
+
+	psStatistic->runCount++;
+	if(time > psStatistic->maximumTime)
+	{
+		psStatistic->maximumTime = time;
+	}
+	if(time > psTask->budget)
+	{
+		psStatistic->overrunCount++;
+		sSchedulerPro.overrunMask |= ((uint64_t)0x01 << taskId);
+	}
+	if((int32_t)(HAL_GetTick() - sSchedulerPro.sQueue.deadline[taskId]) > 0)
+	{
+		psStatistic->missCount++;
+		sSchedulerPro.overrunMask |= ((uint64_t)0x01 << taskId);
+	}
+}
+
+/*******************************************************************************
+ * @fn      SchedulerGetOverrun
+ * @brief   Get and clear tasks that missed deadline or budget
+ * @param   None
+ * @return  Task mask
+ ******************************************************************************/
+static uint64_t SchedulerGetOverrun(void)
+{
+	uint64_t overrunMask = sSchedulerPro.overrunMask;
+
+	sSchedulerPro.overrunMask = 0;
+	return overrunMask;
+}
+
+/*******************************************************************************
+ * @fn      SchedulerGetStatistic
+ * @brief   Get timing of a registered task
+ * @param   taskId
+ *          psStatistic
+ * @return  false: task not registered
+ ******************************************************************************/
+static bool SchedulerGetStatistic(uint8_t taskId, sSCHEDULER_STATISTIC *psStatistic)
+{
+	if(taskId >= SCHEDULER_MAXIMUM_TASK || sSchedulerPro.sQueue.psTask[taskId] == NULL)
+	{
+		return false;
+	}
+	*psStatistic = sSchedulerPro.sStatistic[taskId];
+	return true;
+}
+
+/*******************************************************************************
+ * BENCHMARK FUNCTIONS
+ ******************************************************************************/
+static void SchedulerBenchmarkTask(void)
+{
+}
+
+static const sSCHEDULER_TASK sBenchmarkTask = {"benchmark", SchedulerBenchmarkTask, 10, 0};
+
+/*******************************************************************************
+ * @fn      SchedulerBenchmark
+ * @brief   Cycles of a dispatch pass, release every pending event and run
+ *          them in deadline order, at 2, 32 and 64 events
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void SchedulerBenchmark(void)
+{
+	static const uint8_t numOfEvent[] = {2, 32, 64};
+	// Pending events, 2 events sit at both ends of the ready words
+	static const uint32_t pending[][SCHEDULER_NUM_OF_WORD] =
+	{
+		{0x00000001, 0x80000000},
+		{0xFFFFFFFF, 0x00000000},
+		{0xFFFFFFFF, 0xFFFFFFFF},
+	};
+	uint32_t startCycle = 0;
+	uint32_t cycle = 0;
+	uint8_t taskId = 0;
+	uint8_t word = 0;
+	uint8_t i = 0;
+	uint8_t j = 0;
+
+	for(i = 0; i < SCHEDULER_MAXIMUM_TASK; i++)
+	{
+		sBenchmarkQueue.psTask[i] = &sBenchmarkTask;
+	}
+	for(i = 0; i < sizeof(numOfEvent); i++)
+	{
+		startCycle = CYCLE_COUNTER_READ();
+		for(j = 0; j < SCHEDULER_BENCHMARK_RUN; j++)
+		{
+			for(word = 0; word < SCHEDULER_NUM_OF_WORD; word++)
+			{
+				QueueRelease(&sBenchmarkQueue, word, pending[i][word], j);
+			}
+			while((taskId = QueueNext(&sBenchmarkQueue)) != SCHEDULER_NO_TASK)
+			{
+				sBenchmarkQueue.ready[taskId / 32] &= ~((uint32_t)0x01 << (taskId % 32));
+				sBenchmarkQueue.psTask[taskId]->Run();
+			}
+		}
+		cycle = (CYCLE_COUNTER_READ() - startCycle) / SCHEDULER_BENCHMARK_RUN;
+		sLog.Printf("%2d events: %6lu cycles per pass, %4lu per event\n", numOfEvent[i],
+				(unsigned long)cycle, (unsigned long)(cycle / numOfEvent[i]));
+	}
+}
+
+/*******************************************************************************
+ * @fn      SchedulerPrint
+ * @brief   Print timing of registered tasks
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void SchedulerPrint(void)
+{
+	const sSCHEDULER_STATISTIC *psStatistic = NULL;
+	const sSCHEDULER_TASK *psTask = NULL;
+	uint8_t i = 0;
+
+	sLog.Printf("ID Task            deadline budget     runs   miss overrun max us\n");
+	for(i = 0; i < SCHEDULER_MAXIMUM_TASK; i++)
+	{
+		psTask = sSchedulerPro.sQueue.psTask[i];
+		if(psTask == NULL)
+		{
+			continue;
+		}
+		psStatistic = &sSchedulerPro.sStatistic[i];
+		sLog.Printf("%2d %-15s %5d ms %5d %8lu %6lu %7lu %6lu\n", i, psTask->name, psTask->deadline, psTask->budget,
+				(unsigned long)psStatistic->runCount, (unsigned long)psStatistic->missCount,
+				(unsigned long)psStatistic->overrunCount, (unsigned long)psStatistic->maximumTime);
+	}
+}
+
+// Scheduler function structure
+const sSCHEDULER sScheduler =
+{
+	SchedulerInitialize,
+	SchedulerRegister,
+	SchedulerRelease,
+	SchedulerNext,
+	SchedulerRun,
+	SchedulerGetOverrun,
+	SchedulerGetStatistic,
+	SchedulerBenchmark,
+	SchedulerPrint,
+};
@@ -10,6 +10,8 @@
  ******************************************************************************/
 #include "software_timer.h"
 #include "gpio.h"
+#include "itm_trace.h"
+#include "log.h"
 
 /*******************************************************************************
  * PUBLIC VARIABLES
@@ -32,6 +34,7 @@ typedef struct
     SOFTWARE_TIMER_CALLBACK softwareTimerStartCallback[NUM_OF_SOFTWARE_TIMER];
     SOFTWARE_TIMER_CALLBACK softwareTimerCallback[NUM_OF_SOFTWARE_TIMER];
     SOFTWARE_TIMER_CALLBACK softwareTimerStopCallback[NUM_OF_SOFTWARE_TIMER];
+    void *arg[NUM_OF_SOFTWARE_TIMER];
 }
 sSOFTWARE_TIMER_PRO;
 static sSOFTWARE_TIMER_PRO sSoftwareTimerPro;
@@ -41,9 +44,11 @@ static sSOFTWARE_TIMER_PRO sSoftwareTimerPro;
  ******************************************************************************/
 static bool SoftwareTimerEnable(void);
 static bool SoftwareTimerDisable(void);
-static uint8_t SoftwareTimerInitialize(SOFTWARE_TIMER_CALLBACK softwareTimerStartCallback, SOFTWARE_TIMER_CALLBACK softwareTimerCallback, SOFTWARE_TIMER_CALLBACK softwareTimerStopCallback, eTIMER_TYPE eTimerType);
+static uint8_t SoftwareTimerInitialize(SOFTWARE_TIMER_CALLBACK softwareTimerStartCallback, SOFTWARE_TIMER_CALLBACK softwareTimerCallback, SOFTWARE_TIMER_CALLBACK softwareTimerStopCallback, eTIMER_TYPE eTimerType, void *arg);
 static void SoftwareTimerStart(uint8_t softwareTimerId, uint32_t countdown);
 static void SoftwareTimerStop(uint8_t softwareTimerId);
+static uint32_t SoftwareTimerGetCountdown(uint8_t softwareTimerId);
+static void SoftwareTimerPrint(void);
 
 /*******************************************************************************
  * @fn      SoftwareTimerEnable
@@ -89,9 +94,10 @@ static bool SoftwareTimerDisable(void)
  *			softwareTimerCallback
  *			softwareTimerStopCallback
  *          eTimerType
+ *          arg		User context passed to callbacks
  * @return  Software timer ID
  ******************************************************************************/
-static uint8_t SoftwareTimerInitialize(SOFTWARE_TIMER_CALLBACK softwareTimerStartCallback, SOFTWARE_TIMER_CALLBACK softwareTimerCallback, SOFTWARE_TIMER_CALLBACK softwareTimerStopCallback, eTIMER_TYPE eTimerType)
+static uint8_t SoftwareTimerInitialize(SOFTWARE_TIMER_CALLBACK softwareTimerStartCallback, SOFTWARE_TIMER_CALLBACK softwareTimerCallback, SOFTWARE_TIMER_CALLBACK softwareTimerStopCallback, eTIMER_TYPE eTimerType, void *arg)
 {
     if(sSoftwareTimerPro.usedTimer == NUM_OF_SOFTWARE_TIMER)
     {
@@ -105,6 +111,7 @@ static uint8_t SoftwareTimerInitialize(SOFTWARE_TIMER_CALLBACK softwareTimerStar
     sSoftwareTimerPro.softwareTimerStartCallback[sSoftwareTimerPro.usedTimer] = softwareTimerStartCallback;
     sSoftwareTimerPro.softwareTimerCallback[sSoftwareTimerPro.usedTimer] = softwareTimerCallback;
     sSoftwareTimerPro.softwareTimerStopCallback[sSoftwareTimerPro.usedTimer] = softwareTimerStopCallback;
+    sSoftwareTimerPro.arg[sSoftwareTimerPro.usedTimer] = arg;
     sSoftwareTimerPro.usedTimer++;
     return sSoftwareTimerPro.usedTimer - 1;
 }
@@ -122,7 +129,7 @@ static void SoftwareTimerStart(uint8_t softwareTimerId, uint32_t period)
 	{
 		if(sSoftwareTimerPro.softwareTimerStartCallback[softwareTimerId])
 		{
-			sSoftwareTimerPro.softwareTimerStartCallback[softwareTimerId](softwareTimerId);
+			sSoftwareTimerPro.softwareTimerStartCallback[softwareTimerId](softwareTimerId, sSoftwareTimerPro.arg[softwareTimerId]);
 		}
 		sSoftwareTimerPro.period[softwareTimerId] = period;
 		sSoftwareTimerPro.countdown[softwareTimerId] = period;
@@ -141,18 +148,50 @@ static void SoftwareTimerStop(uint8_t softwareTimerId)
     sSoftwareTimerPro.countdown[softwareTimerId] = 0;
 	if(sSoftwareTimerPro.softwareTimerStopCallback[softwareTimerId])
 	{
-		sSoftwareTimerPro.softwareTimerStopCallback[softwareTimerId](softwareTimerId);
+		sSoftwareTimerPro.softwareTimerStopCallback[softwareTimerId](softwareTimerId, sSoftwareTimerPro.arg[softwareTimerId]);
+	}
+}
+
+/*******************************************************************************
+ * @fn      SoftwareTimerGetCountdown
+ * @brief   Software timer remaining time
+ * @param   softwareTimerId
+ * @return  Remaining countdown, 0 when stopped
+ ******************************************************************************/
+static uint32_t SoftwareTimerGetCountdown(uint8_t softwareTimerId)
+{
+	return sSoftwareTimerPro.countdown[softwareTimerId];
+}
+
+/*******************************************************************************
+ * @fn      SoftwareTimerPrint
+ * @brief   Print type, period and countdown of every allocated timer
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void SoftwareTimerPrint(void)
+{
+	uint8_t i = 0;
+
+	sLog.Printf("Timer %d/%d used\n", sSoftwareTimerPro.usedTimer, NUM_OF_SOFTWARE_TIMER);
+	for(i = 0; i < sSoftwareTimerPro.usedTimer; i++)
+	{
+		sLog.Printf("%d: %-8s period %lu countdown %lu\n", i,
+				sSoftwareTimerPro.eTimerType[i] == TIMER_ONCE_TYPE ? "once" : "periodic",
+				(unsigned long)sSoftwareTimerPro.period[i], (unsigned long)sSoftwareTimerPro.countdown[i]);
 	}
 }
 
 // Software timer function structure
-sSOFTWARE_TIMER sSoftwareTimer =
+const sSOFTWARE_TIMER sSoftwareTimer =
 {
 	SoftwareTimerEnable,
 	SoftwareTimerDisable,
 	SoftwareTimerInitialize,
 	SoftwareTimerStart,
 	SoftwareTimerStop,
+	SoftwareTimerGetCountdown,
+	SoftwareTimerPrint,
 };
 
 /*******************************************************************************
@@ -185,10 +224,11 @@ void SoftwareTimerInterruptCallback(void)
             // Timeout
             if(sSoftwareTimerPro.countdown[i] == 0)
             {
+            	sItmTrace.Word(timerItmChannel, ITM_TRACE_TIMER(i, HAL_GetTick()));
                 // Callback
         		if(sSoftwareTimerPro.softwareTimerCallback[i])
         		{
-                	sSoftwareTimerPro.softwareTimerCallback[i](i);
+                	sSoftwareTimerPro.softwareTimerCallback[i](i, sSoftwareTimerPro.arg[i]);
         		}
                 // Periodic timer
                 if(sSoftwareTimerPro.eTimerType[i] == TIMER_PERIODIC_TYPE)
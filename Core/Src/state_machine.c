@@ -10,11 +10,69 @@
  ******************************************************************************/
 #include "state_machine.h"
 #include "software_timer.h"
+#include "flash_journal.h"
+#include "cycle_counter.h"
+#include "crc.h"
+#include "telemetry.h"
+#include "region.h"
+#include "flow_vm.h"
+#include "coroutine.h"
+#include "log.h"
+#include "itm_trace.h"
+#include "main_loop.h"
+#include "fault_capture.h"
 
 /*******************************************************************************
  * CONSTANTS
  ******************************************************************************/
 #define MINIMUM_COINS	5
+#define DISPENSE_PERIOD	1000
+#define LOG_MODULE		LOG_MODULE_STATE_MACHINE
+// Snapshot magic "SNAP"
+#define SNAPSHOT_MAGIC	0x50414E53
+// Coverage updates timed by "coverage bench"
+#define COVERAGE_BENCHMARK_EVENT	1000
+// Keeps loads and stores between the cycle counter reads of the benchmark
+#define COMPILER_BARRIER()	__asm volatile("" ::: "memory")
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Maintenance region state
+typedef enum
+{
+	inServiceMaintenanceState = 0,
+	serviceMaintenanceState,
+	totalMaintenanceState,
+}
+eMAINTENANCE_STATE;
+
+// Dispense region state
+typedef enum
+{
+	idleDispenseState = 0,
+	dispensingDispenseState,
+	pauseDispenseState,
+	totalDispenseState,
+}
+eDISPENSE_STATE;
+
+// Coin region state
+typedef enum
+{
+	acceptCoinState = 0,
+	enoughCoinState,
+	totalCoinState,
+}
+eCOIN_STATE;
+
+// Dispense coroutine signal
+typedef enum
+{
+	runDispenseSignal		= 0x01,
+	pauseDispenseSignal		= 0x02,
+}
+eDISPENSE_SIGNAL;
 
 /*******************************************************************************
  * LOCAL VARIBLES
@@ -26,195 +84,602 @@
 typedef struct
 {
 	eMACHINE_STATUS eCurrentMachineStatus;
+	uint8_t regionState[maximumRegion];
+	uint8_t flowState;				// Machine status kept by flow program
 	uint8_t totalCoin;
 	uint8_t dispensingTimerId;
+	uint32_t lifetimeCoin;
+	uint32_t lifetimeVend;
+	uint32_t heldCoin;				// Taken beyond uint8_t credit, credited as credit is used
 }
 sSTATE_MACHINE_PRO;
 static sSTATE_MACHINE_PRO sStateMachinePro;
 
+// State machine snapshot kept in RAM over watchdog and software reset
+typedef struct
+{
+	uint32_t magic;
+	sSTATE_MACHINE_PRO sStateMachinePro;
+	uint32_t dispensingCountdown;
+	uint32_t crc;
+}
+sSTATE_MACHINE_SNAPSHOT;
+static sSTATE_MACHINE_SNAPSHOT sSnapshot NOINIT;
+
+// Define coverage property structure
+typedef struct
+{
+	sSTATE_MACHINE_COVERAGE sCoverage;
+	uint32_t statusTick;			// HAL tick current status was entered
+}
+sCOVERAGE_PRO;
+static sCOVERAGE_PRO sCoveragePro;
+
+// Dispense coroutine locals, kept in its frame
+typedef struct
+{
+	uint32_t period;				// First delay, shorter after warm restart
+}
+sDISPENSE_LOCAL;
+static sCOROUTINE *psDispenseCoroutine;
+
 /*******************************************************************************
  * LOCAL FUNCTIONS
  ******************************************************************************/
-
-static void GoToInsertCoinMachineStatus(void);
-static void GoToEnoughCoinMachineStatus(void);
-static void GoToDispensingMachineStatus(void);
-static void GoToPauseDispenseMachineStatus(void);
-static void (*GoTo[])(void) =
+/*******************************************************************************
+ * @fn      SaveSnapshot
+ * @brief   Copy state and armed dispensing timer to .noinit snapshot
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void SaveSnapshot(void)
 {
-	GoToInsertCoinMachineStatus,
-	GoToEnoughCoinMachineStatus,
-	GoToDispensingMachineStatus,
-	GoToPauseDispenseMachineStatus,
-};
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	sSnapshot.magic = SNAPSHOT_MAGIC;
+	sSnapshot.sStateMachinePro = sStateMachinePro;
+	sSnapshot.dispensingCountdown = sSoftwareTimer.GetCountdown(FLOW_VM_ENABLE ? sStateMachinePro.dispensingTimerId :
+																				 psDispenseCoroutine->timerId);
+	sSnapshot.crc = sCrc.Calculate(&sSnapshot, offsetof(sSTATE_MACHINE_SNAPSHOT, crc) / sizeof(uint32_t));
+	__set_PRIMASK(primask);
+}
 
 /*******************************************************************************
- * @fn      GoToInsertCoinMachineStatus
- * @brief   Go to insert coin machine status
+ * @fn      SaveCredit
+ * @brief   Journal credit and audit counters to flash
  * @param   None
  * @return  None
  ******************************************************************************/
-static void GoToInsertCoinMachineStatus(void)
+static void SaveCredit(void)
 {
-	sStateMachinePro.eCurrentMachineStatus = acceptCoinMachineStatus;
-	sStateMachinePro.totalCoin = 0;
-	printf("Accept coin status setup completed\n");
-	printf("Please insert coin\n");
+	sFLASH_JOURNAL_RECORD sRecord = {0};
+
+	sRecord.lifetimeCoin = sStateMachinePro.lifetimeCoin;
+	sRecord.lifetimeVend = sStateMachinePro.lifetimeVend;
+	sRecord.totalCoin = sStateMachinePro.totalCoin;
+	sFlashJournal.Write(&sRecord);
+	SaveSnapshot();
 }
 
 /*******************************************************************************
- * @fn      GoToEnoughCoinMachineStatus
- * @brief   Go to enough coin machine status
- * @param   None
+ * @fn      RunDispense
+ * @brief   Let dispense coroutine use one coin per period
+ * @param   period	First period
  * @return  None
  ******************************************************************************/
-static void GoToEnoughCoinMachineStatus(void)
+static void RunDispense(uint32_t period)
 {
-	sStateMachinePro.eCurrentMachineStatus = enoughCoinMachineStatus;
-	printf("Enough coin status setup completed\n");
-	printf("Press button to dispense\n");
+	((sDISPENSE_LOCAL *)psDispenseCoroutine->local)->period = period;
+	sCoroutine.Signal(psDispenseCoroutine, runDispenseSignal);
 }
 
 /*******************************************************************************
- * @fn      GoToDispensingMachineStatus
- * @brief   Go to dispensing machine status
+ * @fn      PauseDispense
+ * @brief   Stop dispense coroutine before next coin is used
  * @param   None
  * @return  None
  ******************************************************************************/
-static void GoToDispensingMachineStatus(void)
+static void PauseDispense(void)
 {
-	sStateMachinePro.eCurrentMachineStatus = dispensingMachineStatus;
-	sSoftwareTimer.Start(sStateMachinePro.dispensingTimerId, 1000);
-	printf("Dispensing status setup completed\n");
-	printf("Press button to stop dispense\n");
+	sCoroutine.Signal(psDispenseCoroutine, pauseDispenseSignal);
 }
 
 /*******************************************************************************
- * @fn      GoToPauseDispenseMachineStatus
- * @brief   Go to pause dispense machine status
+ * @fn      InMaintenance
+ * @brief   Maintenance region guard for coin and dispense regions
  * @param   None
- * @return  None
+ * @return  true
+ *          false
  ******************************************************************************/
-static void GoToPauseDispenseMachineStatus(void)
+static bool InMaintenance(void)
 {
-	sStateMachinePro.eCurrentMachineStatus = pauseDispenseMachineStatus;
-	sSoftwareTimer.Stop(sStateMachinePro.dispensingTimerId);
-	printf("Pause Dispense status setup completed\n");
-	printf("Press button to continue dispense\n");
+	return sStateMachinePro.regionState[maintenanceRegion] == serviceMaintenanceState;
 }
 
-static void DispensingTimerCallback(uint8_t softwareTimerId);
+/*******************************************************************************
+ * REGION HANDLER FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      MaintenanceStart
+ * @brief   Maintenance start at in service state
+ * @param   state
+ *          parameter
+ * @return  Next state
+ ******************************************************************************/
+static uint8_t MaintenanceStart(uint8_t state, uint32_t parameter)
+{
+	LOG_INFO("Maintenance started, coin and button blocked\n");
+	return serviceMaintenanceState;
+}
 
 /*******************************************************************************
- * @fn      DispensingTimerCallback
- * @brief   Dispensing timer callback
- * @param   None
- * @return  None
+ * @fn      MaintenanceEnd
+ * @brief   Maintenance end at service state
+ * @param   state
+ *          parameter
+ * @return  Next state
+ ******************************************************************************/
+static uint8_t MaintenanceEnd(uint8_t state, uint32_t parameter)
+{
+	LOG_INFO("Maintenance ended\n");
+	return inServiceMaintenanceState;
+}
+
+/*******************************************************************************
+ * @fn      DispenseButtonPressedAtIdle
+ * @brief   Dispense button pressed while not dispensing
+ * @param   state
+ *          parameter
+ * @return  Next state
  ******************************************************************************/
-static void DispensingTimerCallback(uint8_t softwareTimerId)
+static uint8_t DispenseButtonPressedAtIdle(uint8_t state, uint32_t parameter)
 {
+	if(InMaintenance() || sStateMachinePro.regionState[coinRegion] != enoughCoinState)
+	{
+		LOG_WARNING("Cannot press button at this status\n");
+		return state;
+	}
+	LOG_INFO("Press button at enough coin machine status\n");
+	RunDispense(DISPENSE_PERIOD);
+	return dispensingDispenseState;
+}
+
+/*******************************************************************************
+ * @fn      DispenseButtonPressedAtDispensing
+ * @brief   Dispense button pressed at dispensing state
+ * @param   state
+ *          parameter
+ * @return  Next state
+ ******************************************************************************/
+static uint8_t DispenseButtonPressedAtDispensing(uint8_t state, uint32_t parameter)
+{
+	LOG_INFO("Press button at dispensing machine status\n");
+	PauseDispense();
+	return pauseDispenseState;
+}
+
+/*******************************************************************************
+ * @fn      DispenseButtonPressedAtPause
+ * @brief   Dispense button pressed at pause dispense state
+ * @param   state
+ *          parameter
+ * @return  Next state
+ ******************************************************************************/
+static uint8_t DispenseButtonPressedAtPause(uint8_t state, uint32_t parameter)
+{
+	if(InMaintenance())
+	{
+		LOG_WARNING("Cannot press button at this status\n");
+		return state;
+	}
+	LOG_INFO("Press button at pause dispense machine status\n");
+	RunDispense(DISPENSE_PERIOD);
+	return dispensingDispenseState;
+}
+
+/*******************************************************************************
+ * @fn      DispensingTimeoutAtDispensing
+ * @brief   One second dispensed, one coin used, posted by dispense
+ *          coroutine
+ * @param   state
+ *          parameter
+ * @return  Next state
+ ******************************************************************************/
+static uint8_t DispensingTimeoutAtDispensing(uint8_t state, uint32_t parameter)
+{
+	// No credit left to use, never wrap to 255 seconds
+	if(sStateMachinePro.totalCoin == 0)
+	{
+		return idleDispenseState;
+	}
 	sStateMachinePro.totalCoin--;
-	// Continue dispense
-	if(sStateMachinePro.totalCoin > 0)
+	// Held coin takes the freed credit, dispense runs on without a stop
+	if(sStateMachinePro.heldCoin > 0)
 	{
-		printf("Still remain %d second\n", sStateMachinePro.totalCoin);
-		sSoftwareTimer.Start(sStateMachinePro.dispensingTimerId, 1000);
+		sStateMachinePro.heldCoin--;
+		sStateMachinePro.totalCoin++;
 	}
+	if(sStateMachinePro.totalCoin == 0)
+	{
+		sStateMachinePro.lifetimeVend++;
+	}
+	SaveCredit();
 	// Dispense complete
-	else
+	if(sStateMachinePro.totalCoin == 0)
+	{
+		return idleDispenseState;
+	}
+	// Dispense coroutine continues with next coin
+	LOG_INFO("Still remain %d second\n", sStateMachinePro.totalCoin);
+	return dispensingDispenseState;
+}
+
+/*******************************************************************************
+ * @fn      DispensingTimeoutAtPause
+ * @brief   Second ran out together with pause, coin is used and dispense
+ *          stays paused
+ * @param   state
+ *          parameter
+ * @return  Next state
+ ******************************************************************************/
+static uint8_t DispensingTimeoutAtPause(uint8_t state, uint32_t parameter)
+{
+	return DispensingTimeoutAtDispensing(state, parameter) == idleDispenseState ? idleDispenseState : pauseDispenseState;
+}
+
+/*******************************************************************************
+ * @fn      MaintenanceStartAtDispensing
+ * @brief   Maintenance pauses dispense, button continues afterwards
+ * @param   state
+ *          parameter
+ * @return  Next state
+ ******************************************************************************/
+static uint8_t MaintenanceStartAtDispensing(uint8_t state, uint32_t parameter)
+{
+	PauseDispense();
+	return pauseDispenseState;
+}
+
+/*******************************************************************************
+ * @fn      CoinCredit
+ * @brief   Coin state follows credit, e.g. after dispensing used a coin
+ * @param   state
+ *          parameter
+ * @return  Next state
+ ******************************************************************************/
+static uint8_t CoinCredit(uint8_t state, uint32_t parameter)
+{
+	return sStateMachinePro.totalCoin >= MINIMUM_COINS ? enoughCoinState : acceptCoinState;
+}
+
+/*******************************************************************************
+ * @fn      InsertCoinAtCoin
+ * @brief   Insert coin, accepted while dispensing and in maintenance as well
+ * @param   state
+ *          parameter	Number of coins
+ * @return  Next state
+ ******************************************************************************/
+static uint8_t InsertCoinAtCoin(uint8_t state, uint32_t parameter)
+{
+	uint32_t held = 0;
+
+	// Acceptor has no inhibit line, a coin taken in service is still credit
+	if(InMaintenance())
 	{
-		(*GoTo[acceptCoinMachineStatus])();
+		LOG_WARNING("Coin inserted in maintenance, credited\n");
 	}
+	sStateMachinePro.lifetimeCoin += parameter;
+	// Credit is uint8_t, coins beyond UINT8_MAX are held instead of wrapping.
+	// They have been taken, so they are never dropped
+	if(parameter > (uint32_t)(UINT8_MAX - sStateMachinePro.totalCoin))
+	{
+		held = parameter - (UINT8_MAX - sStateMachinePro.totalCoin);
+		sStateMachinePro.heldCoin += held;
+		parameter -= held;
+		LOG_WARNING("Credit full, %lu coin held, %lu in total\n", (unsigned long)held,
+				(unsigned long)sStateMachinePro.heldCoin);
+	}
+	LOG_INFO("Insert coin at %s coin state\n", state == acceptCoinState ? "accept" : "enough");
+	sStateMachinePro.totalCoin += parameter;
+	SaveCredit();
+	LOG_INFO("Total coin = %d\n", sStateMachinePro.totalCoin);
+	return CoinCredit(state, parameter);
 }
 
-static void InsertCoinAtAcceptCoinMachineStatus(void);
-static void InsertCoinAtEnoughCoinMachineStatus(void);
-static void (*InsertCoinAction[])(void) =
+// Maintenance region handler table
+static const REGION_HANDLER MaintenanceRegionHandler[totalMaintenanceState][totalMachineEvent] =
 {
-	InsertCoinAtAcceptCoinMachineStatus,
-	InsertCoinAtEnoughCoinMachineStatus,
+	[inServiceMaintenanceState] = {[maintenanceStartMachineEvent] = MaintenanceStart},
+	[serviceMaintenanceState] = {[maintenanceEndMachineEvent] = MaintenanceEnd},
+};
+
+// Dispense region handler table
+static const REGION_HANDLER DispenseRegionHandler[totalDispenseState][totalMachineEvent] =
+{
+	[idleDispenseState] =
+	{
+		[dispenseButtonMachineEvent] = DispenseButtonPressedAtIdle,
+	},
+	[dispensingDispenseState] =
+	{
+		[dispenseButtonMachineEvent] = DispenseButtonPressedAtDispensing,
+		[dispensingTimerMachineEvent] = DispensingTimeoutAtDispensing,
+		[maintenanceStartMachineEvent] = MaintenanceStartAtDispensing,
+	},
+	[pauseDispenseState] =
+	{
+		[dispenseButtonMachineEvent] = DispenseButtonPressedAtPause,
+		[dispensingTimerMachineEvent] = DispensingTimeoutAtPause,
+	},
+};
+
+// Coin region handler table
+static const REGION_HANDLER CoinRegionHandler[totalCoinState][totalMachineEvent] =
+{
+	[acceptCoinState] =
+	{
+		[startMachineEvent] = CoinCredit,
+		[insertCoinMachineEvent] = InsertCoinAtCoin,
+		[dispensingTimerMachineEvent] = CoinCredit,
+	},
+	[enoughCoinState] =
+	{
+		[insertCoinMachineEvent] = InsertCoinAtCoin,
+		[dispensingTimerMachineEvent] = CoinCredit,
+	},
+};
+
+// Regions in dispatch order, dispense uses credit before coin region looks at it
+static const sREGION sRegion[maximumRegion] =
+{
+	[maintenanceRegion] = {"maintenance", totalMaintenanceState, &MaintenanceRegionHandler[0][0]},
+	[dispenseRegion] = {"dispense", totalDispenseState, &DispenseRegionHandler[0][0]},
+	[coinRegion] = {"coin", totalCoinState, &CoinRegionHandler[0][0]},
+};
+
+static sREGION_SET sRegionSet =
+{
+	sRegion,
+	sStateMachinePro.regionState,
+	maximumRegion,
+	totalMachineEvent,
+	{0},
 };
 
 /*******************************************************************************
- * @fn      InsertCoinAtAcceptCoinMachineStatus
- * @brief   Insert coin at accept coin machine status
+ * @fn      ValidSnapshot
+ * @brief   Snapshot survived reset intact
+ * @param   None
+ * @return  true
+ *          false
+ ******************************************************************************/
+static bool ValidSnapshot(void)
+{
+	sREGION_SET sSnapshotRegionSet = sRegionSet;
+
+	sSnapshotRegionSet.state = sSnapshot.sStateMachinePro.regionState;
+	return sSnapshot.magic == SNAPSHOT_MAGIC &&
+		   sSnapshot.crc == sCrc.Calculate(&sSnapshot, offsetof(sSTATE_MACHINE_SNAPSHOT, crc) / sizeof(uint32_t)) &&
+		   sSnapshot.sStateMachinePro.eCurrentMachineStatus < totalMachineStatus &&
+		   sSnapshot.sStateMachinePro.flowState < totalMachineStatus &&
+		   sRegionEngine.Valid(&sSnapshotRegionSet);
+}
+
+static void EnterInsertCoinMachineStatus(void);
+static void EnterEnoughCoinMachineStatus(void);
+static void EnterDispensingMachineStatus(void);
+static void EnterPauseDispenseMachineStatus(void);
+static void (*const Enter[])(void) =
+{
+	EnterInsertCoinMachineStatus,
+	EnterEnoughCoinMachineStatus,
+	EnterDispensingMachineStatus,
+	EnterPauseDispenseMachineStatus,
+};
+
+/*******************************************************************************
+ * @fn      EnterInsertCoinMachineStatus
+ * @brief   Enter insert coin machine status
  * @param   None
  * @return  None
  ******************************************************************************/
-static void InsertCoinAtAcceptCoinMachineStatus(void)
+static void EnterInsertCoinMachineStatus(void)
 {
-	printf("Insert coin at accept coin machine status\n");
-	sStateMachinePro.totalCoin++;
-	printf("Total coin = %d\n", sStateMachinePro.totalCoin);
-	if(sStateMachinePro.totalCoin >= MINIMUM_COINS)
-	{
-		(*GoTo[enoughCoinMachineStatus])();
-	}
+	LOG_DEBUG("Accept coin status setup completed\n");
+	LOG_DEBUG("Please insert coin\n");
 }
 
 /*******************************************************************************
- * @fn      InsertCoinAtEnoughCoinMachineStatus
- * @brief   Insert coin at enough coin machine status
+ * @fn      EnterEnoughCoinMachineStatus
+ * @brief   Enter enough coin machine status
  * @param   None
  * @return  None
  ******************************************************************************/
-static void InsertCoinAtEnoughCoinMachineStatus(void)
+static void EnterEnoughCoinMachineStatus(void)
 {
-	printf("Insert coin at enough coin machine status\n");
-	sStateMachinePro.totalCoin++;
-	printf("Total coin = %d\n", sStateMachinePro.totalCoin);
+	LOG_DEBUG("Enough coin status setup completed\n");
+	LOG_DEBUG("Press button to dispense\n");
 }
 
-static void DispenseButtonPressedAtEnoughCoinMachineStatus(void);
-static void DispenseButtonPressedAtDispensingMachineStatus(void);
-static void DispenseButtonPressedAtPauseDispenseMachineStatus(void);
-static void (*DispenseButtonPressedAction[])(void) =
+/*******************************************************************************
+ * @fn      EnterDispensingMachineStatus
+ * @brief   Enter dispensing machine status
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void EnterDispensingMachineStatus(void)
 {
-	NULL,
-	DispenseButtonPressedAtEnoughCoinMachineStatus,
-	DispenseButtonPressedAtDispensingMachineStatus,
-	DispenseButtonPressedAtPauseDispenseMachineStatus
-};
+	LOG_DEBUG("Dispensing status setup completed\n");
+	LOG_DEBUG("Press button to stop dispense\n");
+}
 
 /*******************************************************************************
- * @fn      DispenseButtonPressedAtEnoughCoinMachineStatus
- * @brief   Dispense button pressed at enough coin machine status
+ * @fn      EnterPauseDispenseMachineStatus
+ * @brief   Enter pause dispense machine status
  * @param   None
  * @return  None
  ******************************************************************************/
-static void DispenseButtonPressedAtEnoughCoinMachineStatus(void)
+static void EnterPauseDispenseMachineStatus(void)
 {
-	printf("Press button at enough coin machine status\n");
-	(*GoTo[dispensingMachineStatus])();
+	LOG_DEBUG("Pause Dispense status setup completed\n");
+	LOG_DEBUG("Press button to continue dispense\n");
 }
 
 /*******************************************************************************
- * @fn      DispenseButtonPressedAtDispensingMachineStatus
- * @brief   Dispense button pressed at dispensing machine status
+ * @fn      UpdateStatus
+ * @brief   Derive machine status from dispense and coin regions, report
+ *          a change and save snapshot
+ * @param   eMachineEvent	Event that changed the regions
+ * @return  None
+ ******************************************************************************/
+static void UpdateStatus(eMACHINE_EVENT eMachineEvent)
+{
+	eMACHINE_STATUS eMachineStatus = acceptCoinMachineStatus;
+	uint32_t now = 0;
+
+	switch(sStateMachinePro.regionState[dispenseRegion])
+	{
+		case dispensingDispenseState:
+			eMachineStatus = dispensingMachineStatus;
+			break;
+		case pauseDispenseState:
+			eMachineStatus = pauseDispenseMachineStatus;
+			break;
+		default:
+			eMachineStatus = sStateMachinePro.regionState[coinRegion] == enoughCoinState ?
+							 enoughCoinMachineStatus : acceptCoinMachineStatus;
+			break;
+	}
+	if(FLOW_VM_ENABLE)
+	{
+		eMachineStatus = (eMACHINE_STATUS)sStateMachinePro.flowState;
+	}
+
+	if(eMachineStatus != sStateMachinePro.eCurrentMachineStatus)
+	{
+		now = HAL_GetTick();
+		sCoveragePro.sCoverage.residency[sStateMachinePro.eCurrentMachineStatus] += now - sCoveragePro.statusTick;
+		sCoveragePro.statusTick = now;
+		sCoveragePro.sCoverage.entryCount[eMachineStatus]++;
+		sTelemetry.Transition(sStateMachinePro.eCurrentMachineStatus, eMachineStatus, eMachineEvent);
+		sItmTrace.Word(transitionItmChannel,
+					   ITM_TRACE_TRANSITION(sStateMachinePro.eCurrentMachineStatus, eMachineStatus, eMachineEvent));
+		sStateMachinePro.eCurrentMachineStatus = eMachineStatus;
+		(*Enter[eMachineStatus])();
+	}
+	SaveSnapshot();
+}
+
+/*******************************************************************************
+ * @fn      Dispatch
+ * @brief   Give event to all regions or flow program, main loop context only
+ * @param   eMachineEvent
+ *          parameter
+ * @return  None
+ ******************************************************************************/
+static void Dispatch(eMACHINE_EVENT eMachineEvent, uint32_t parameter)
+{
+	sCoveragePro.sCoverage.eventCount[sStateMachinePro.eCurrentMachineStatus][eMachineEvent]++;
+	if(FLOW_VM_ENABLE)
+	{
+		sFlowVm.Run(eMachineEvent, parameter);
+	}
+	else
+	{
+		sRegionEngine.Dispatch(&sRegionSet, eMachineEvent, parameter);
+	}
+	UpdateStatus(eMachineEvent);
+}
+
+/*******************************************************************************
+ * @fn      DispenseCoroutine
+ * @brief   Dispense sequence, one coin per period until credit is used up
+ *          or dispense is paused
+ * @param   psCoroutine
+ * @return  None
+ ******************************************************************************/
+static void DispenseCoroutine(sCOROUTINE *psCoroutine)
+{
+	sDISPENSE_LOCAL *psLocal = psCoroutine->local;
+
+	COROUTINE_BEGIN(psCoroutine);
+	for(;;)
+	{
+		COROUTINE_WAIT(psCoroutine, runDispenseSignal);
+		do
+		{
+			COROUTINE_DELAY(psCoroutine, psLocal->period, pauseDispenseSignal);
+			// Second is dispensed once delay ran out, charged even when pause
+			// arrived with it
+			if((psCoroutine->received & COROUTINE_TIMEOUT_SIGNAL) != 0)
+			{
+				psLocal->period = DISPENSE_PERIOD;
+				Dispatch(dispensingTimerMachineEvent, 0);
+			}
+			if((psCoroutine->received & pauseDispenseSignal) != 0)
+			{
+				break;
+			}
+		}
+		while(sStateMachinePro.eCurrentMachineStatus == dispensingMachineStatus);
+	}
+	COROUTINE_END(psCoroutine);
+}
+
+static void DispensingTimerCallback(uint8_t softwareTimerId, void *arg);
+
+/*******************************************************************************
+ * @fn      DispensingTimerCallback
+ * @brief   Dispensing timer callback of flow program, runs in main loop
  * @param   None
  * @return  None
  ******************************************************************************/
-static void DispenseButtonPressedAtDispensingMachineStatus(void)
+static void DispensingTimerCallback(uint8_t softwareTimerId, void *arg)
 {
-	printf("Press button at dispensing machine status\n");
-	(*GoTo[pauseDispenseMachineStatus])();
+	sEventFlag.Set(dispensingTimerEventFlag);
 }
 
 /*******************************************************************************
- * @fn      DispenseButtonPressedAtPauseDispenseMachineStatus
- * @brief   Dispense button pressed at pause dispense machine status
+ * @fn      StartFlowVm
+ * @brief   Load flow program on machine data, dispensing timer is created
  * @param   None
  * @return  None
  ******************************************************************************/
-static void DispenseButtonPressedAtPauseDispenseMachineStatus(void)
+static void StartFlowVm(void)
 {
-	printf("Press button at pause dispense machine status\n");
-	(*GoTo[dispensingMachineStatus])();
+	const sFLOW_VM_CONTEXT sFlowContext =
+	{
+		&sStateMachinePro.flowState,
+		&sStateMachinePro.totalCoin,
+		&sStateMachinePro.lifetimeCoin,
+		&sStateMachinePro.lifetimeVend,
+		&sStateMachinePro.heldCoin,
+		sStateMachinePro.dispensingTimerId,
+		SaveCredit,
+	};
+
+	if(!FLOW_VM_ENABLE)
+	{
+		return;
+	}
+	sFlowVm.Initialize(&sFlowContext);
 }
 
 static void Initialize(void);
 static void InsertCoin(void);
+static void InsertCoins(uint32_t numOfCoin);
 static void DispenseButtonPressed(void);
+static void DispensingTimeout(void);
+static void Maintenance(bool start);
+static eMACHINE_STATUS GetStatus(void);
+static uint8_t GetTotalCoin(void);
+static void GetCounter(sSTATE_MACHINE_COUNTER *psCounter);
+static void Print(void);
+static void GetCoverage(sSTATE_MACHINE_COVERAGE *psCoverage);
+static void ResetCoverage(void);
+static void PrintCoverage(void);
+static void BenchmarkCoverage(void);
 
 /*******************************************************************************
  * @fn      Initialize
@@ -224,27 +689,89 @@ static void DispenseButtonPressed(void);
  ******************************************************************************/
 static void Initialize(void)
 {
-	(*GoTo[acceptCoinMachineStatus])();
-	sStateMachinePro.dispensingTimerId = sSoftwareTimer.Initialize(NULL, DispensingTimerCallback, NULL, TIMER_ONCE_TYPE);
+	uint32_t startCycle = 0;
+	uint32_t period = 0;
+	sFLASH_JOURNAL_RECORD sRecord;
+	bool restore = false;
+
+	sCycleCounter.Enable();
+	startCycle = CYCLE_COUNTER_READ();
+	sCoveragePro.statusTick = HAL_GetTick();
+
+	// Snapshot may hold the state that faulted, cold start from journal
+	// breaks a reset loop
+	if(sFaultCapture.ResetByException() && ValidSnapshot())
+	{
+		sSnapshot.magic = 0;
+		LOG_WARNING("Snapshot dropped after fault reset\n");
+	}
+	// Warm restart, resume saved state and armed dispensing timer. Journal is
+	// not mounted, its first write finds the newest page
+	if(ValidSnapshot())
+	{
+		sStateMachinePro = sSnapshot.sStateMachinePro;
+		sStateMachinePro.dispensingTimerId = sSoftwareTimer.Initialize(NULL, DispensingTimerCallback, NULL, TIMER_ONCE_TYPE, NULL);
+		psDispenseCoroutine = sCoroutine.Create(DispenseCoroutine, sizeof(sDISPENSE_LOCAL));
+		StartFlowVm();
+		if(sStateMachinePro.eCurrentMachineStatus == dispensingMachineStatus)
+		{
+			period = sSnapshot.dispensingCountdown > 0 ? sSnapshot.dispensingCountdown : DISPENSE_PERIOD;
+			if(FLOW_VM_ENABLE)
+			{
+				sSoftwareTimer.Start(sStateMachinePro.dispensingTimerId, period);
+			}
+			else
+			{
+				RunDispense(period);
+			}
+		}
+		SaveSnapshot();
+		LOG_INFO("Warm restart at status %d, total coin = %d, ready %lu ms after reset (%lu cycles)\n",
+				sStateMachinePro.eCurrentMachineStatus, sStateMachinePro.totalCoin,
+				(unsigned long)HAL_GetTick(), (unsigned long)(CYCLE_COUNTER_READ() - startCycle));
+		return;
+	}
+
+	restore = sFlashJournal.Mount(&sRecord);
+	sStateMachinePro.dispensingTimerId = sSoftwareTimer.Initialize(NULL, DispensingTimerCallback, NULL, TIMER_ONCE_TYPE, NULL);
+	psDispenseCoroutine = sCoroutine.Create(DispenseCoroutine, sizeof(sDISPENSE_LOCAL));
+	StartFlowVm();
+	(*Enter[acceptCoinMachineStatus])();
+	// Credit of a dispense cut by reset is kept, customer continues by button
+	if(restore)
+	{
+		sStateMachinePro.lifetimeCoin = sRecord.lifetimeCoin;
+		sStateMachinePro.lifetimeVend = sRecord.lifetimeVend;
+		sStateMachinePro.totalCoin = sRecord.totalCoin;
+		LOG_INFO("Restore total coin = %d, lifetime coin = %lu\n", sStateMachinePro.totalCoin,
+				(unsigned long)sStateMachinePro.lifetimeCoin);
+	}
+	// Coin state follows restored credit
+	Dispatch(startMachineEvent, 0);
+	LOG_INFO("Cold start ready %lu ms after reset (%lu cycles)\n", (unsigned long)HAL_GetTick(),
+			(unsigned long)(CYCLE_COUNTER_READ() - startCycle));
 }
 
 /*******************************************************************************
  * @fn      InsertCoin
  * @brief   Insert coin
- * @param   pulseValue
+ * @param   None
  * @return  None
  ******************************************************************************/
 static void InsertCoin(void)
 {
-	if((sizeof(InsertCoinAction) / 4) > sStateMachinePro.eCurrentMachineStatus &&
-		InsertCoinAction[sStateMachinePro.eCurrentMachineStatus] != NULL)
-	{
-		(*InsertCoinAction[sStateMachinePro.eCurrentMachineStatus])();
-	}
-	else
-	{
-		printf("Cannot insert coin at this status\n");
-	}
+	InsertCoins(1);
+}
+
+/*******************************************************************************
+ * @fn      InsertCoins
+ * @brief   Insert several coins at once, e.g. a counted pulse train
+ * @param   numOfCoin	Coins beyond the uint8_t credit are held
+ * @return  None
+ ******************************************************************************/
+static void InsertCoins(uint32_t numOfCoin)
+{
+	Dispatch(insertCoinMachineEvent, numOfCoin);
 }
 
 /*******************************************************************************
@@ -255,21 +782,195 @@ static void InsertCoin(void)
  ******************************************************************************/
 static void DispenseButtonPressed(void)
 {
-	if((sizeof(DispenseButtonPressedAction) / 4) > sStateMachinePro.eCurrentMachineStatus &&
-		DispenseButtonPressedAction[sStateMachinePro.eCurrentMachineStatus] != NULL)
+	Dispatch(dispenseButtonMachineEvent, 0);
+}
+
+/*******************************************************************************
+ * @fn      DispensingTimeout
+ * @brief   Dispensing timer expired
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void DispensingTimeout(void)
+{
+	Dispatch(dispensingTimerMachineEvent, 0);
+}
+
+/*******************************************************************************
+ * @fn      Maintenance
+ * @brief   Start or end maintenance
+ * @param   start
+ * @return  None
+ ******************************************************************************/
+static void Maintenance(bool start)
+{
+	Dispatch(start ? maintenanceStartMachineEvent : maintenanceEndMachineEvent, 0);
+}
+
+/*******************************************************************************
+ * @fn      GetStatus
+ * @brief   Get current machine status
+ * @param   None
+ * @return  Machine status
+ ******************************************************************************/
+static eMACHINE_STATUS GetStatus(void)
+{
+	return sStateMachinePro.eCurrentMachineStatus;
+}
+
+/*******************************************************************************
+ * @fn      GetTotalCoin
+ * @brief   Get customer credit
+ * @param   None
+ * @return  Total coin
+ ******************************************************************************/
+static uint8_t GetTotalCoin(void)
+{
+	return sStateMachinePro.totalCoin;
+}
+
+/*******************************************************************************
+ * @fn      GetCounter
+ * @brief   Get credit and audit counters
+ * @param   psCounter
+ * @return  None
+ ******************************************************************************/
+static void GetCounter(sSTATE_MACHINE_COUNTER *psCounter)
+{
+	psCounter->totalCoin = sStateMachinePro.totalCoin;
+	psCounter->lifetimeCoin = sStateMachinePro.lifetimeCoin;
+	psCounter->lifetimeVend = sStateMachinePro.lifetimeVend;
+	psCounter->heldCoin = sStateMachinePro.heldCoin;
+}
+
+/*******************************************************************************
+ * @fn      Print
+ * @brief   Print region states or flow program and dispatch cost
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void Print(void)
+{
+	if(FLOW_VM_ENABLE)
 	{
-		(*DispenseButtonPressedAction[sStateMachinePro.eCurrentMachineStatus])();
+		sFlowVm.Print();
+		return;
 	}
-	else
+	sRegionEngine.Print(&sRegionSet);
+}
+
+/*******************************************************************************
+ * @fn      GetCoverage
+ * @brief   Get coverage, residency includes time in current status
+ * @param   psCoverage
+ * @return  None
+ ******************************************************************************/
+static void GetCoverage(sSTATE_MACHINE_COVERAGE *psCoverage)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	*psCoverage = sCoveragePro.sCoverage;
+	psCoverage->residency[sStateMachinePro.eCurrentMachineStatus] += HAL_GetTick() - sCoveragePro.statusTick;
+	__set_PRIMASK(primask);
+}
+
+/*******************************************************************************
+ * @fn      ResetCoverage
+ * @brief   Clear counters and residency in one step
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void ResetCoverage(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	memset(&sCoveragePro.sCoverage, 0, sizeof(sCoveragePro.sCoverage));
+	sCoveragePro.statusTick = HAL_GetTick();
+	__set_PRIMASK(primask);
+}
+
+/*******************************************************************************
+ * @fn      PrintCoverage
+ * @brief   Print event count of every (status, event), entries and residency
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void PrintCoverage(void)
+{
+	sSTATE_MACHINE_COVERAGE sCoverage;
+	uint8_t i = 0;
+	uint8_t j = 0;
+
+	GetCoverage(&sCoverage);
+	sLog.Printf("Status  entries  residency ms  events start/coin/button/timer/mstart/mend\n");
+	for(i = 0; i < totalMachineStatus; i++)
+	{
+		sLog.Printf("%d %10lu %13lu ", i, (unsigned long)sCoverage.entryCount[i], (unsigned long)sCoverage.residency[i]);
+		for(j = 0; j < totalMachineEvent; j++)
+		{
+			sLog.Printf(" %lu", (unsigned long)sCoverage.eventCount[i][j]);
+		}
+		sLog.Printf("\n");
+	}
+}
+
+/*******************************************************************************
+ * @fn      BenchmarkCoverage
+ * @brief   Time the coverage increment of Dispatch alone, least and most
+ *          cycles less the cost of a counter read pair. Counters are put
+ *          back afterwards, main loop context only
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void BenchmarkCoverage(void)
+{
+	sSTATE_MACHINE_COVERAGE sCoverage = sCoveragePro.sCoverage;
+	uint32_t readCycle = UINT32_MAX;
+	uint32_t minimumCycle = UINT32_MAX;
+	uint32_t maximumCycle = 0;
+	uint32_t startCycle = 0;
+	uint32_t cycle = 0;
+	uint32_t i = 0;
+
+	for(i = 0; i < COVERAGE_BENCHMARK_EVENT; i++)
+	{
+		startCycle = CYCLE_COUNTER_READ();
+		COMPILER_BARRIER();
+		cycle = CYCLE_COUNTER_READ() - startCycle;
+		readCycle = cycle < readCycle ? cycle : readCycle;
+	}
+	for(i = 0; i < COVERAGE_BENCHMARK_EVENT; i++)
 	{
-		printf("Cannot press button at this status\n");
+		startCycle = CYCLE_COUNTER_READ();
+		COMPILER_BARRIER();
+		sCoveragePro.sCoverage.eventCount[sStateMachinePro.eCurrentMachineStatus][i % totalMachineEvent]++;
+		COMPILER_BARRIER();
+		cycle = CYCLE_COUNTER_READ() - startCycle - readCycle;
+		minimumCycle = cycle < minimumCycle ? cycle : minimumCycle;
+		maximumCycle = cycle > maximumCycle ? cycle : maximumCycle;
 	}
+	sCoveragePro.sCoverage = sCoverage;
+	sLog.Printf("Coverage update %lu cycles (max %lu), counter read pair %lu cycles\n",
+			(unsigned long)minimumCycle, (unsigned long)maximumCycle, (unsigned long)readCycle);
 }
 
 // State machine
-sSTATE_MACHINE sStateMachine =
+const sSTATE_MACHINE sStateMachine =
 {
 	Initialize,
     InsertCoin,
+    InsertCoins,
     DispenseButtonPressed,
+    DispensingTimeout,
+    Maintenance,
+    GetStatus,
+    GetTotalCoin,
+    GetCounter,
+    Print,
+    GetCoverage,
+    ResetCoverage,
+    PrintCoverage,
+    BenchmarkCoverage,
 };
@@ -24,10 +24,11 @@
 /* Includes */
 #include <errno.h>
 #include <stdio.h>
+#include <stdint.h>
+#include "memory_protection.h"
 
 /* Variables */
 extern int errno;
-register char * stack_ptr asm("sp");
 
 /* Functions */
 
@@ -45,7 +46,8 @@ caddr_t _sbrk(int incr)
 		heap_end = &end;
 
 	prev_heap_end = heap_end;
-	if (heap_end + incr > stack_ptr)
+	/* Heap stops short of stack in use, MPU guard follows heap end */
+	if (!sMemoryProtection.HeapGrow((uint32_t)(heap_end + incr)))
 	{
 		errno = ENOMEM;
 		return (caddr_t) -1;
@@ -0,0 +1,214 @@
+/*******************************************************************************
+ * Filename:			telemetry.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    COBS framed binary telemetry function
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "telemetry.h"
+#include "software_timer.h"
+#include "fast_interrupt.h"
+#include "clock_governor.h"
+#include "console.h"
+#include "main_loop.h"
+#include "scheduler.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Largest record plus check byte, COBS overhead and delimiter
+#define TELEMETRY_FRAME_SIZE	(sizeof(sTELEMETRY_COVERAGE) + 3)
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define telemetry property structure
+typedef struct
+{
+	uint8_t timerId;
+	volatile bool streaming;
+}
+sTELEMETRY_PRO;
+static sTELEMETRY_PRO sTelemetryPro;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void TelemetryInitialize(void);
+static void TelemetryStream(bool enable);
+static void TelemetryTransition(eMACHINE_STATUS eFrom, eMACHINE_STATUS eTo, eMACHINE_EVENT eEvent);
+static void TelemetrySnapshot(void);
+
+/*******************************************************************************
+ * @fn      TelemetryTimerCallback
+ * @brief   Snapshot period elapsed
+ * @param   softwareTimerId
+ *          arg
+ * @return  None
+ ******************************************************************************/
+static void TelemetryTimerCallback(uint8_t softwareTimerId, void *arg)
+{
+	sEventFlag.Set(telemetryEventFlag);
+}
+
+/*******************************************************************************
+ * @fn      TelemetrySend
+ * @brief   COBS encode record and its check byte, queue frame in one write
+ *          so frames from interrupt and main loop never interleave
+ * @param   record
+ *          length		Record length, less than 254
+ * @return  None
+ ******************************************************************************/
+static void TelemetrySend(const void *record, uint8_t length)
+{
+	const uint8_t *data = record;
+	uint8_t frame[TELEMETRY_FRAME_SIZE];
+	uint8_t codeIndex = 0;
+	uint8_t code = 1;
+	uint8_t index = 1;
+	uint8_t check = 0;
+	uint8_t value = 0;
+	uint8_t i = 0;
+
+	if(!sTelemetryPro.streaming)
+	{
+		return;
+	}
+
+	for(i = 0; i <= length; i++)
+	{
+		if(i < length)
+		{
+			value = data[i];
+			check += value;
+		}
+		else
+		{
+			value = ~check;
+		}
+		if(value == 0)
+		{
+			frame[codeIndex] = code;
+			codeIndex = index++;
+			code = 1;
+		}
+		else
+		{
+			frame[index++] = value;
+			code++;
+		}
+	}
+	frame[codeIndex] = code;
+	frame[index++] = 0;
+	sConsole.Write((const char *)frame, index);
+}
+
+/*******************************************************************************
+ * @fn      TelemetryInitialize
+ * @brief   Start snapshot period, stream stays off until enabled
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void TelemetryInitialize(void)
+{
+	static const sSCHEDULER_TASK sTelemetryTask = {"telemetry", TelemetrySnapshot, 200, 2000};
+
+	if(!TELEMETRY_ENABLE)
+	{
+		return;
+	}
+	sScheduler.Register(telemetryEventFlag, &sTelemetryTask);
+	sTelemetryPro.timerId = sSoftwareTimer.Initialize(NULL, TelemetryTimerCallback, NULL, TIMER_PERIODIC_TYPE, NULL);
+	sSoftwareTimer.Start(sTelemetryPro.timerId, TELEMETRY_PERIOD);
+}
+
+/*******************************************************************************
+ * @fn      TelemetryStream
+ * @brief   Start or stop frames on the console
+ * @param   enable
+ * @return  None
+ ******************************************************************************/
+static void TelemetryStream(bool enable)
+{
+	sTelemetryPro.streaming = TELEMETRY_ENABLE && enable;
+}
+
+/*******************************************************************************
+ * @fn      TelemetryTransition
+ * @brief   Send state transition record, safe from interrupt
+ * @param   eFrom
+ *          eTo
+ *          eEvent
+ * @return  None
+ ******************************************************************************/
+static void TelemetryTransition(eMACHINE_STATUS eFrom, eMACHINE_STATUS eTo, eMACHINE_EVENT eEvent)
+{
+	sTELEMETRY_TRANSITION sRecord;
+
+	sRecord.type = transitionTelemetryRecord;
+	sRecord.from = eFrom;
+	sRecord.to = eTo;
+	sRecord.event = eEvent;
+	sRecord.timestamp = HAL_GetTick();
+	TelemetrySend(&sRecord, sizeof(sRecord));
+}
+
+/*******************************************************************************
+ * @fn      TelemetrySnapshot
+ * @brief   Send counter, timer and coverage records
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void TelemetrySnapshot(void)
+{
+	sTELEMETRY_COUNTER sCounter = {0};
+	sTELEMETRY_TIMER sTimer = {0};
+	sTELEMETRY_COVERAGE sCoverage = {0};
+	sSTATE_MACHINE_COVERAGE sMachineCoverage;
+	sSTATE_MACHINE_COUNTER sMachineCounter;
+	sCONSOLE_STATISTIC sConsoleStatistic;
+
+	if(!sTelemetryPro.streaming)
+	{
+		return;
+	}
+
+	sStateMachine.GetCounter(&sMachineCounter);
+	sConsole.GetStatistic(&sConsoleStatistic);
+	sCounter.type = counterTelemetryRecord;
+	sCounter.status = sStateMachine.GetStatus();
+	sCounter.totalCoin = sMachineCounter.totalCoin;
+	sCounter.clockLevel = sClockGovernor.GetLevel();
+	sCounter.timestamp = HAL_GetTick();
+	sCounter.lifetimeCoin = sMachineCounter.lifetimeCoin;
+	sCounter.lifetimeVend = sMachineCounter.lifetimeVend;
+	sCounter.txDrop = sConsoleStatistic.txDrop;
+	TelemetrySend(&sCounter, sizeof(sCounter));
+
+	sTimer.type = timerTelemetryRecord;
+	sTimer.timestamp = sCounter.timestamp;
+	sTimer.count = sFastInterruptLatency[timerFastInterrupt].count;
+	sTimer.last = sFastInterruptLatency[timerFastInterrupt].last;
+	sTimer.minimum = sFastInterruptLatency[timerFastInterrupt].minimum;
+	sTimer.maximum = sFastInterruptLatency[timerFastInterrupt].maximum;
+	TelemetrySend(&sTimer, sizeof(sTimer));
+
+	sStateMachine.GetCoverage(&sMachineCoverage);
+	sCoverage.type = coverageTelemetryRecord;
+	sCoverage.timestamp = sCounter.timestamp;
+	memcpy(sCoverage.residency, sMachineCoverage.residency, sizeof(sCoverage.residency));
+	memcpy(sCoverage.eventCount, sMachineCoverage.eventCount, sizeof(sCoverage.eventCount));
+	TelemetrySend(&sCoverage, sizeof(sCoverage));
+}
+
+// Telemetry function structure
+const sTELEMETRY sTelemetry =
+{
+	TelemetryInitialize,
+	TelemetryStream,
+	TelemetryTransition,
+	TelemetrySnapshot,
+};
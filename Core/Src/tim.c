@@ -22,6 +22,7 @@
 
 /* USER CODE BEGIN 0 */
 #include "software_timer.h"
+#include "fast_interrupt.h"
 
 /* USER CODE END 0 */
 
@@ -94,6 +95,7 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
 	if(htim->Instance == TIM6)
 	{
+		FastInterruptMark(timerFastInterrupt);
 		SoftwareTimerInterruptCallback();
 	}
 }
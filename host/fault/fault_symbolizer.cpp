@@ -0,0 +1,300 @@
+/*******************************************************************************
+ * Filename:			fault_symbolizer.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Backtrace of a fault record dump with the firmware
+ *						ELF. Function symbols of the ELF name pc, lr and the
+ *						return addresses found in the dumped stack
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "fault_symbolizer.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <elf.h>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace fault
+{
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// BL and BLX immediate: 11110 then 11x1x / 11x0x, BLX register: 010001111
+static constexpr uint16_t blFirstMask = 0xF800;
+static constexpr uint16_t blFirst = 0xF000;
+static constexpr uint16_t blSecondMask = 0xC000;
+static constexpr uint16_t blSecond = 0xC000;
+static constexpr uint16_t blxRegisterMask = 0xFF87;
+static constexpr uint16_t blxRegister = 0x4780;
+
+/*******************************************************************************
+ * @fn      Elf::Load
+ * @brief   Read function symbols and code sections
+ * @param   path
+ * @return  false: see GetError
+ ******************************************************************************/
+bool Elf::Load(const std::string &path)
+{
+	std::ifstream input(path, std::ios::binary);
+	const Elf32_Ehdr *header = nullptr;
+	const Elf32_Shdr *section = nullptr;
+
+	file.clear();
+	symbol.clear();
+	code.clear();
+	if(!input)
+	{
+		error = path + ": can not open";
+		return false;
+	}
+	file.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	header = reinterpret_cast<const Elf32_Ehdr *>(file.data());
+	if(file.size() < sizeof(Elf32_Ehdr) || memcmp(header->e_ident, ELFMAG, SELFMAG) != 0 ||
+	   header->e_ident[EI_CLASS] != ELFCLASS32 || header->e_ident[EI_DATA] != ELFDATA2LSB)
+	{
+		error = path + ": not a 32-bit little endian ELF";
+		return false;
+	}
+	if(header->e_shoff + (size_t)header->e_shnum * sizeof(Elf32_Shdr) > file.size() ||
+	   header->e_shentsize != sizeof(Elf32_Shdr))
+	{
+		error = path + ": section table out of file";
+		return false;
+	}
+	arm = header->e_machine == EM_ARM;
+	section = reinterpret_cast<const Elf32_Shdr *>(file.data() + header->e_shoff);
+
+	for(size_t i = 0; i < header->e_shnum; i++)
+	{
+		if(section[i].sh_type == SHT_PROGBITS && (section[i].sh_flags & SHF_EXECINSTR) != 0 &&
+		   section[i].sh_offset + section[i].sh_size <= file.size())
+		{
+			code.push_back({section[i].sh_addr, section[i].sh_size, section[i].sh_offset});
+		}
+		if(section[i].sh_type != SHT_SYMTAB || section[i].sh_link >= header->e_shnum ||
+		   section[i].sh_offset + section[i].sh_size > file.size())
+		{
+			continue;
+		}
+		const Elf32_Shdr &name = section[section[i].sh_link];
+		const Elf32_Sym *entry = reinterpret_cast<const Elf32_Sym *>(file.data() + section[i].sh_offset);
+		for(size_t j = 0; j < section[i].sh_size / sizeof(Elf32_Sym); j++)
+		{
+			if(ELF32_ST_TYPE(entry[j].st_info) != STT_FUNC || entry[j].st_size == 0 ||
+			   entry[j].st_name >= name.sh_size || name.sh_offset + name.sh_size > file.size())
+			{
+				continue;
+			}
+			// Thumb function symbols have bit 0 set
+			symbol.push_back({entry[j].st_value & ~(uint32_t)0x01, entry[j].st_size,
+							  reinterpret_cast<const char *>(file.data() + name.sh_offset + entry[j].st_name)});
+		}
+	}
+	if(symbol.empty())
+	{
+		error = path + ": no function symbols, stripped?";
+		return false;
+	}
+	std::sort(symbol.begin(), symbol.end(), [](const Symbol &a, const Symbol &b) { return a.address < b.address; });
+	return true;
+}
+
+/*******************************************************************************
+ * @fn      Elf::Function
+ * @brief   Function containing address
+ * @param   address
+ *          offset		Offset into function
+ * @return  Name, nullptr outside all functions
+ ******************************************************************************/
+const std::string *Elf::Function(uint32_t address, uint32_t *offset) const
+{
+	auto next = std::upper_bound(symbol.begin(), symbol.end(), address,
+								 [](uint32_t value, const Symbol &entry) { return value < entry.address; });
+
+	if(next == symbol.begin())
+	{
+		return nullptr;
+	}
+	--next;
+	if(address - next->address >= next->size)
+	{
+		return nullptr;
+	}
+	*offset = address - next->address;
+	return &next->name;
+}
+
+/*******************************************************************************
+ * @fn      Elf::Halfword
+ * @brief   Halfword of code at address
+ * @param   address
+ *          value
+ * @return  false: not in a code section
+ ******************************************************************************/
+bool Elf::Halfword(uint32_t address, uint16_t *value) const
+{
+	for(const auto &entry : code)
+	{
+		if(address >= entry.address && address - entry.address + sizeof(uint16_t) <= entry.size)
+		{
+			memcpy(value, file.data() + entry.offset + (address - entry.address), sizeof(uint16_t));
+			return true;
+		}
+	}
+	return false;
+}
+
+/*******************************************************************************
+ * @fn      Elf::ReturnAddress
+ * @brief   Address a call returns to. Other ELFs than ARM only need the
+ *          address inside a function
+ * @param   address
+ * @return  true
+ *          false
+ ******************************************************************************/
+bool Elf::ReturnAddress(uint32_t address) const
+{
+	uint32_t offset = 0;
+	uint16_t first = 0;
+	uint16_t second = 0;
+
+	if(!arm)
+	{
+		return Function(address, &offset) != nullptr;
+	}
+	// Thumb state bit set, call instruction before it in a function
+	if((address & 0x01) == 0)
+	{
+		return false;
+	}
+	address &= ~(uint32_t)0x01;
+	if(Function(address - 2, &offset) == nullptr)
+	{
+		return false;
+	}
+	if(Halfword(address - 2, &second) && (second & blxRegisterMask) == blxRegister)
+	{
+		return true;
+	}
+	return Halfword(address - 4, &first) && Halfword(address - 2, &second) &&
+		   (first & blFirstMask) == blFirst && (second & blSecondMask) == blSecond;
+}
+
+/*******************************************************************************
+ * @fn      ParseDump
+ * @brief   Take pc, lr, sp and stack lines. A later pc line starts a new
+ *          record, the last one in the text counts
+ * @param   text
+ * @return  Dump
+ ******************************************************************************/
+Dump ParseDump(const std::string &text)
+{
+	std::istringstream input(text);
+	std::string line;
+	Dump dump;
+	size_t at = 0;
+	uint32_t pc = 0;
+	uint32_t lr = 0;
+	uint32_t xpsr = 0;
+	uint32_t sp = 0;
+	uint32_t address = 0;
+	uint32_t value = 0;
+	int length = 0;
+	int used = 0;
+
+	while(std::getline(input, line))
+	{
+		length = 0;
+		if((at = line.find("pc 0x")) != std::string::npos &&
+		   sscanf(line.c_str() + at, "pc 0x%" SCNx32 " lr 0x%" SCNx32 " xpsr 0x%" SCNx32 " sp 0x%" SCNx32,
+				  &pc, &lr, &xpsr, &sp) == 4)
+		{
+			dump = Dump();
+			dump.pc = pc;
+			dump.lr = lr;
+			dump.sp = sp;
+			dump.valid = true;
+			continue;
+		}
+		if(!dump.valid || (at = line.find("stack 0x")) == std::string::npos ||
+		   sscanf(line.c_str() + at, "stack 0x%" SCNx32 ":%n", &address, &length) != 1 || length == 0)
+		{
+			continue;
+		}
+		if(dump.stack.empty())
+		{
+			dump.stackAddress = address;
+		}
+		// Lines follow each other, a gap ends the stack
+		if(address != dump.stackAddress + dump.stack.size() * sizeof(uint32_t))
+		{
+			continue;
+		}
+		const char *word = line.c_str() + at + length;
+		while(sscanf(word, " 0x%" SCNx32 "%n", &value, &used) == 1)
+		{
+			dump.stack.push_back(value);
+			word += used;
+		}
+	}
+	return dump;
+}
+
+/*******************************************************************************
+ * @fn      Backtrace
+ * @brief   pc, lr and stacked return addresses with their function
+ * @param   elf
+ *          dump
+ * @return  Frames, innermost first
+ ******************************************************************************/
+std::vector<Frame> Backtrace(const Elf &elf, const Dump &dump)
+{
+	std::vector<Frame> frame;
+	auto Add = [&](uint32_t address, const std::string &source)
+	{
+		Frame entry = {address, source, "", 0};
+		const std::string *function = nullptr;
+
+		if(!frame.empty() && frame.back().address == address)
+		{
+			return;
+		}
+		// Return address points behind the call, name the call instead
+		function = elf.Function(source == "pc" ? address : (address & ~(uint32_t)0x01) - 2, &entry.offset);
+		if(function != nullptr)
+		{
+			entry.function = *function;
+			entry.offset += source == "pc" ? 0 : 2;
+		}
+		frame.push_back(entry);
+	};
+
+	if(!dump.valid)
+	{
+		return frame;
+	}
+	Add(dump.pc, "pc");
+	if(elf.ReturnAddress(dump.lr))
+	{
+		Add(dump.lr, "lr");
+	}
+	for(size_t i = 0; i < dump.stack.size(); i++)
+	{
+		if(elf.ReturnAddress(dump.stack[i]))
+		{
+			char source[24];
+			snprintf(source, sizeof(source), "sp+0x%zX", dump.stackAddress + i * sizeof(uint32_t) - dump.sp);
+			Add(dump.stack[i], source);
+		}
+	}
+	return frame;
+}
+
+} // namespace fault
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * Filename:			fault_symbolizer.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Backtrace of a fault record dump with the firmware
+ *						ELF. Function symbols of the ELF name pc, lr and the
+ *						return addresses found in the dumped stack
+*******************************************************************************/
+
+#ifndef _FAULT_SYMBOLIZER_H_
+#define _FAULT_SYMBOLIZER_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fault
+{
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Fault record as printed by FaultCapturePrint
+struct Dump
+{
+	uint32_t pc = 0;
+	uint32_t lr = 0;
+	uint32_t sp = 0;
+	uint32_t stackAddress = 0;			// Address of stack[0]
+	std::vector<uint32_t> stack;
+	bool valid = false;					// pc line found
+};
+
+// One backtrace line
+struct Frame
+{
+	uint32_t address;
+	std::string source;					// "pc", "lr" or "sp+offset"
+	std::string function;				// Empty outside known functions
+	uint32_t offset;
+};
+
+/*******************************************************************************
+ * CLASS
+ ******************************************************************************/
+// Function symbols and code of a 32-bit little endian ELF
+class Elf
+{
+public:
+	// false: file missing or not ELF32, error tells why
+	bool Load(const std::string &path);
+	const std::string &GetError() const { return error; }
+
+	// Function containing address, nullptr outside all functions
+	const std::string *Function(uint32_t address, uint32_t *offset) const;
+	// Halfword of loaded code at address. false: not in code
+	bool Halfword(uint32_t address, uint16_t *value) const;
+	// Thumb return address: odd, in a function and after BL, BLX imm or
+	// BLX register
+	bool ReturnAddress(uint32_t address) const;
+
+private:
+	struct Symbol
+	{
+		uint32_t address;
+		uint32_t size;
+		std::string name;
+	};
+	struct Code
+	{
+		uint32_t address;
+		uint32_t size;
+		size_t offset;					// In file
+	};
+
+	std::vector<uint8_t> file;
+	std::vector<Symbol> symbol;			// Sorted by address
+	std::vector<Code> code;
+	bool arm = false;
+	std::string error;
+};
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+// Fault record out of console text, other lines are skipped
+Dump ParseDump(const std::string &text);
+// pc, lr when it is a return address, then return addresses on the stack
+// from the stack pointer up, repeats of the line before dropped
+std::vector<Frame> Backtrace(const Elf &elf, const Dump &dump);
+
+} // namespace fault
+
+#endif /* _FAULT_SYMBOLIZER_H_ */
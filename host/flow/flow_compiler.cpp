@@ -0,0 +1,489 @@
+/*******************************************************************************
+ * Filename:			flow_compiler.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Compiler of flow source to a flow VM program image
+ *						for the FLOW page, written out as binary or Intel HEX
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "flow_compiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+namespace flow
+{
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Code bytes the firmware validation bitmap covers
+static constexpr size_t maximumCode = 2048;
+static constexpr size_t hexRecord = 16;
+
+// Source names of machine status, event and message
+static const std::map<std::string, uint8_t> statusName =
+{
+	{"accept", acceptCoinMachineStatus},
+	{"enough", enoughCoinMachineStatus},
+	{"dispensing", dispensingMachineStatus},
+	{"pause", pauseDispenseMachineStatus},
+};
+static const std::map<std::string, uint8_t> eventName =
+{
+	{"start", startMachineEvent},
+	{"coin", insertCoinMachineEvent},
+	{"button", dispenseButtonMachineEvent},
+	{"timer", dispensingTimerMachineEvent},
+	{"maintenance_start", maintenanceStartMachineEvent},
+	{"maintenance_end", maintenanceEndMachineEvent},
+};
+static const std::map<std::string, uint8_t> messageName =
+{
+	{"button_refused", buttonRefusedFlowMessage},
+	{"button_enough", buttonEnoughFlowMessage},
+	{"button_dispensing", buttonDispensingFlowMessage},
+	{"button_pause", buttonPauseFlowMessage},
+	{"coin_refused", coinRefusedFlowMessage},
+};
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Instruction of a source line, operands still names
+struct Statement
+{
+	size_t line;
+	size_t offset;							// In code
+	eFLOW_OP op;
+	std::vector<std::string> operand;		// Value, status, message or label
+};
+
+/*******************************************************************************
+ * @fn      Fail
+ * @brief   Error text of a source line
+ * @param   error
+ *          line
+ *          reason
+ * @return  false
+ ******************************************************************************/
+static bool Fail(std::string *error, size_t line, const std::string &reason)
+{
+	*error = "line " + std::to_string(line) + ": " + reason;
+	return false;
+}
+
+/*******************************************************************************
+ * @fn      Lookup
+ * @brief   Value of a name in table
+ * @param   table
+ *          name
+ *          value
+ * @return  false: unknown name
+ ******************************************************************************/
+static bool Lookup(const std::map<std::string, uint8_t> &table, const std::string &name, uint8_t *value)
+{
+	auto entry = table.find(name);
+
+	if(entry == table.end())
+	{
+		return false;
+	}
+	*value = entry->second;
+	return true;
+}
+
+/*******************************************************************************
+ * @fn      Parse
+ * @brief   Instruction of a token list, operands kept as text
+ * @param   token
+ *          statement
+ * @return  false: no instruction of this form
+ ******************************************************************************/
+static bool Parse(const std::vector<std::string> &token, Statement *statement)
+{
+	const std::string &name = token[0];
+	const size_t count = token.size();
+
+	if((name == "end" || name == "save") && count == 1)
+	{
+		statement->op = name == "end" ? endFlowOp : saveFlowOp;
+	}
+	else if(name == "load" && count == 2)
+	{
+		statement->op = token[1] == "credit" ? loadCreditFlowOp :
+						token[1] == "parameter" ? loadParameterFlowOp : loadImmediateFlowOp;
+		if(statement->op == loadImmediateFlowOp)
+		{
+			statement->operand = {token[1]};
+		}
+	}
+	else if((name == "add" || name == "use") && count == 2 && token[1] == "credit")
+	{
+		statement->op = name == "add" ? addCreditFlowOp : useCreditFlowOp;
+	}
+	else if(name == "jump" && count == 2)
+	{
+		statement->op = jumpFlowOp;
+		statement->operand = {token[1]};
+	}
+	else if(name == "jump" && count == 4 && (token[1] == "less" || token[1] == "equal"))
+	{
+		statement->op = token[1] == "less" ? jumpLessFlowOp : jumpEqualFlowOp;
+		statement->operand = {token[2], token[3]};
+	}
+	else if(name == "timer" && count == 3 && token[1] == "start")
+	{
+		statement->op = timerStartFlowOp;
+		statement->operand = {token[2]};
+	}
+	else if(name == "timer" && count == 2 && token[1] == "stop")
+	{
+		statement->op = timerStopFlowOp;
+	}
+	else if(name == "goto" && count == 2)
+	{
+		statement->op = gotoFlowOp;
+		statement->operand = {token[1]};
+	}
+	else if(name == "print" && count == 2)
+	{
+		statement->op = token[1] == "credit" ? printCreditFlowOp :
+						token[1] == "remain" ? printRemainFlowOp : printFlowOp;
+		if(statement->op == printFlowOp)
+		{
+			statement->operand = {token[1]};
+		}
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+/*******************************************************************************
+ * @fn      Length
+ * @brief   Instruction length including operands, as FlowOpLength
+ * @param   op
+ * @return  Bytes
+ ******************************************************************************/
+static size_t Length(eFLOW_OP op)
+{
+	switch(op)
+	{
+		case loadImmediateFlowOp:
+		case timerStartFlowOp:
+			return 3;
+		case jumpFlowOp:
+		case gotoFlowOp:
+		case printFlowOp:
+			return 2;
+		case jumpLessFlowOp:
+		case jumpEqualFlowOp:
+			return 4;
+		default:
+			return 1;
+	}
+}
+
+/*******************************************************************************
+ * @fn      Crc32
+ * @brief   CRC-32 (0x04C11DB7, initial 0xFFFFFFFF), word bits MSB first
+ * @param   data		Little endian words
+ *          numOfWord
+ * @return  CRC
+ ******************************************************************************/
+uint32_t Crc32(const void *data, size_t numOfWord)
+{
+	const uint8_t *byte = static_cast<const uint8_t *>(data);
+	uint32_t crc = 0xFFFFFFFF;
+	uint32_t word = 0;
+
+	for(size_t i = 0; i < numOfWord; i++)
+	{
+		memcpy(&word, byte + i * sizeof(word), sizeof(word));
+		crc ^= word;
+		for(uint8_t j = 0; j < 32; j++)
+		{
+			crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+/*******************************************************************************
+ * @fn      Compile
+ * @brief   Two passes, the first places labels, the second emits code with
+ *          names resolved
+ * @param   source
+ *          program
+ *          error
+ * @return  false: see error
+ ******************************************************************************/
+bool Compile(const std::string &source, Program *program, std::string *error)
+{
+	std::istringstream input(source);
+	std::map<std::string, uint32_t> constant;
+	std::map<std::string, size_t> label;
+	std::vector<Statement> statement;
+	std::vector<std::vector<std::string>> binding;
+	std::vector<size_t> bindingLine;
+	std::vector<uint8_t> code;
+	sFLOW_VM_HEADER sHeader = {};
+	std::string text;
+	size_t line = 0;
+	size_t offset = 0;
+
+	// Operand value, a number or a constant
+	auto Value = [&](const std::string &name, size_t at, uint32_t *value)
+	{
+		char *end = nullptr;
+		unsigned long number = strtoul(name.c_str(), &end, 0);
+
+		if(constant.count(name) != 0)
+		{
+			*value = constant[name];
+			return true;
+		}
+		if(name.empty() || *end != '\0' || name[0] == '-' || number > UINT16_MAX)
+		{
+			return Fail(error, at, "\"" + name + "\" is no constant or number 0 to 65535");
+		}
+		*value = (uint32_t)number;
+		return true;
+	};
+
+	while(std::getline(input, text))
+	{
+		std::vector<std::string> token;
+		std::string word;
+
+		line++;
+		text = text.substr(0, text.find('#'));
+		std::istringstream words(text);
+		while(words >> word)
+		{
+			token.push_back(word);
+		}
+		if(token.empty())
+		{
+			continue;
+		}
+		if(token[0].back() == ':')
+		{
+			const std::string name = token[0].substr(0, token[0].size() - 1);
+
+			if(name.empty() || label.count(name) != 0)
+			{
+				return Fail(error, line, "label \"" + name + "\" empty or defined twice");
+			}
+			label[name] = offset;
+			token.erase(token.begin());
+			if(token.empty())
+			{
+				continue;
+			}
+		}
+		if(token[0] == "const")
+		{
+			uint32_t value = 0;
+
+			if(token.size() != 3 || constant.count(token[1]) != 0)
+			{
+				return Fail(error, line, "const <name> <value>, name defined once");
+			}
+			if(!Value(token[2], line, &value))
+			{
+				return false;
+			}
+			constant[token[1]] = value;
+			continue;
+		}
+		if(token[0] == "on")
+		{
+			if(token.size() != 4)
+			{
+				return Fail(error, line, "on <status> <event> <label>");
+			}
+			binding.push_back(token);
+			bindingLine.push_back(line);
+			continue;
+		}
+
+		Statement entry = {line, offset, endFlowOp, {}};
+		if(!Parse(token, &entry))
+		{
+			return Fail(error, line, "unknown instruction \"" + text + "\"");
+		}
+		offset += Length(entry.op);
+		statement.push_back(entry);
+	}
+
+	if(statement.empty() || statement.back().op != endFlowOp)
+	{
+		return Fail(error, line, "last instruction must be end");
+	}
+	if(offset > maximumCode || offset > pageSize - sizeof(sFLOW_VM_HEADER))
+	{
+		return Fail(error, line, std::to_string(offset) + " code bytes, FLOW page holds " +
+					std::to_string(std::min(maximumCode, pageSize - sizeof(sFLOW_VM_HEADER))));
+	}
+
+	for(const auto &entry : statement)
+	{
+		const size_t next = entry.offset + Length(entry.op);
+		uint32_t value = 0;
+		uint8_t name = 0;
+
+		code.push_back(entry.op);
+		switch(entry.op)
+		{
+			case loadImmediateFlowOp:
+			case timerStartFlowOp:
+			case jumpLessFlowOp:
+			case jumpEqualFlowOp:
+				if(!Value(entry.operand[0], entry.line, &value))
+				{
+					return false;
+				}
+				code.push_back(value & 0xFF);
+				code.push_back((value >> 8) & 0xFF);
+				if(entry.op == loadImmediateFlowOp || entry.op == timerStartFlowOp)
+				{
+					break;
+				}
+				// fall through
+			case jumpFlowOp:
+			{
+				const std::string &target = entry.operand.back();
+
+				if(label.count(target) == 0)
+				{
+					return Fail(error, entry.line, "label \"" + target + "\" not defined");
+				}
+				if(label[target] < next || label[target] - next > UINT8_MAX || label[target] >= offset)
+				{
+					return Fail(error, entry.line, "jump to \"" + target + "\" not forward within 255 bytes");
+				}
+				code.push_back(label[target] - next);
+				break;
+			}
+			case gotoFlowOp:
+				if(!Lookup(statusName, entry.operand[0], &name))
+				{
+					return Fail(error, entry.line, "unknown status \"" + entry.operand[0] + "\"");
+				}
+				code.push_back(name);
+				break;
+			case printFlowOp:
+				if(!Lookup(messageName, entry.operand[0], &name))
+				{
+					return Fail(error, entry.line, "unknown message \"" + entry.operand[0] + "\"");
+				}
+				code.push_back(name);
+				break;
+			default:
+				break;
+		}
+	}
+
+	sHeader.magic = FLOW_VM_MAGIC;
+	sHeader.version = FLOW_VM_VERSION;
+	sHeader.codeLength = (uint16_t)code.size();
+	for(auto &row : sHeader.handler)
+	{
+		for(auto &entry : row)
+		{
+			entry = FLOW_VM_NO_HANDLER;
+		}
+	}
+	for(size_t i = 0; i < binding.size(); i++)
+	{
+		uint8_t status = 0;
+		uint8_t event = 0;
+
+		if(!Lookup(statusName, binding[i][1], &status) || !Lookup(eventName, binding[i][2], &event))
+		{
+			return Fail(error, bindingLine[i], "unknown status \"" + binding[i][1] + "\" or event \"" +
+						binding[i][2] + "\"");
+		}
+		if(label.count(binding[i][3]) == 0 || label[binding[i][3]] >= code.size())
+		{
+			return Fail(error, bindingLine[i], "label \"" + binding[i][3] + "\" not defined");
+		}
+		if(sHeader.handler[status][event] != FLOW_VM_NO_HANDLER)
+		{
+			return Fail(error, bindingLine[i], "handler of " + binding[i][1] + " " + binding[i][2] + " defined twice");
+		}
+		sHeader.handler[status][event] = (uint16_t)label[binding[i][3]];
+	}
+
+	// Word padding is in the CRC, double word padding lets flash program it
+	program->image.assign(reinterpret_cast<const uint8_t *>(&sHeader),
+						  reinterpret_cast<const uint8_t *>(&sHeader) + sizeof(sHeader));
+	program->image.insert(program->image.end(), code.begin(), code.end());
+	program->image.resize((program->image.size() + 7) & ~(size_t)7, 0xFF);
+	program->codeLength = code.size();
+	program->crc = Crc32(program->image.data() + offsetof(sFLOW_VM_HEADER, version),
+						 (sizeof(sHeader) - offsetof(sFLOW_VM_HEADER, version) + code.size() + 3) / 4);
+	memcpy(program->image.data() + offsetof(sFLOW_VM_HEADER, crc), &program->crc, sizeof(program->crc));
+	return true;
+}
+
+/*******************************************************************************
+ * @fn      IntelHex
+ * @brief   Extended linear address record, data records, end of file
+ * @param   image
+ *          address
+ * @return  Text, one record per line
+ ******************************************************************************/
+std::string IntelHex(const std::vector<uint8_t> &image, uint32_t address)
+{
+	std::string text;
+	uint32_t upper = UINT32_MAX;
+	char field[16];
+
+	auto Record = [&](uint8_t type, uint16_t at, const uint8_t *data, size_t length)
+	{
+		uint8_t sum = length + (at >> 8) + at + type;
+
+		snprintf(field, sizeof(field), ":%02X%04X%02X", (unsigned)length, (unsigned)at, type);
+		text += field;
+		for(size_t i = 0; i < length; i++)
+		{
+			snprintf(field, sizeof(field), "%02X", data[i]);
+			text += field;
+			sum += data[i];
+		}
+		snprintf(field, sizeof(field), "%02X\n", (uint8_t)-sum);
+		text += field;
+	};
+
+	for(size_t i = 0; i < image.size(); i += hexRecord)
+	{
+		const uint32_t at = address + i;
+		// Record does not cross a 64 KB boundary
+		const size_t length = std::min({hexRecord, image.size() - i, (size_t)(0x10000 - (at & 0xFFFF))});
+
+		if((at >> 16) != upper)
+		{
+			const uint8_t base[] = {(uint8_t)(at >> 24), (uint8_t)(at >> 16)};
+
+			upper = at >> 16;
+			Record(0x04, 0, base, sizeof(base));
+		}
+		Record(0x00, at & 0xFFFF, image.data() + i, length);
+		i -= hexRecord - length;
+	}
+	Record(0x01, 0, nullptr, 0);
+	return text;
+}
+
+} // namespace flow
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * Filename:			flow_compiler.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Compiler of flow source to a flow VM program image
+ *						for the FLOW page, written out as binary or Intel HEX
+*******************************************************************************/
+
+#ifndef _FLOW_COMPILER_H_
+#define _FLOW_COMPILER_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "flow_vm.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace flow
+{
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// FLOW region of the linker scripts
+static constexpr uint32_t programAddress = 0x080F7800;
+static constexpr size_t pageSize = 0x800;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Program image, header then code padded to a double word with 0xFF
+struct Program
+{
+	std::vector<uint8_t> image;
+	size_t codeLength = 0;
+	uint32_t crc = 0;
+};
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+// Flow source, one statement per line, # starts a comment:
+//   const <name> <value>			named value for operands
+//   on <status> <event> <label>	handler of event at status
+//   <label>:						names the next instruction
+//   end | save
+//   load credit | load parameter | load <value>
+//   add credit | use credit
+//   jump <label> | jump less <value> <label> | jump equal <value> <label>
+//   timer start <value> | timer stop
+//   goto <status>
+//   print credit | print remain | print <message>
+// status: accept enough dispensing pause
+// event: start coin button timer maintenance_start maintenance_end
+// message: button_refused button_enough button_dispensing button_pause
+//          coin_refused
+// Jumps are forward only, within 255 bytes. Checks match FlowVmValidate so
+// the firmware takes every program compiled here.
+// false: error is "line <n>: <reason>"
+bool Compile(const std::string &source, Program *program, std::string *error);
+// CRC-32 of the CRC unit at reset configuration
+uint32_t Crc32(const void *data, size_t numOfWord);
+// Intel HEX of image at address, 16 data bytes per record
+std::string IntelHex(const std::vector<uint8_t> &image, uint32_t address);
+
+} // namespace flow
+
+#endif /* _FLOW_COMPILER_H_ */
@@ -0,0 +1,171 @@
+/*******************************************************************************
+ * Filename:			itm_demux.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Host demultiplexer of a captured SWO byte stream into
+ *						ITM stimulus port writes, with decoders of the
+ *						ITM_TRACE_* word layouts of itm_trace.h
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "itm_demux.h"
+
+namespace itm
+{
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Synchronization is at least 47 zero bits then a one: 5 zero bytes, 0x80
+static constexpr uint8_t syncZero = 5;
+static constexpr uint8_t syncEnd = 0x80;
+static constexpr uint8_t overflowHeader = 0x70;
+static constexpr uint8_t globalTimestamp1 = 0x94;
+static constexpr uint8_t globalTimestamp2 = 0xB4;
+static constexpr uint8_t continuation = 0x80;
+
+/*******************************************************************************
+ * @fn      Demux::Feed
+ * @brief   Headers by ARMv7-M ITM packet protocol. Source packets of
+ *          software go to the handler, other packets are counted
+ * @param   data
+ *          length
+ * @return  None
+ ******************************************************************************/
+void Demux::Feed(const uint8_t *data, size_t length)
+{
+	statistic.byteCount += length;
+	for(size_t i = 0; i < length; i++)
+	{
+		const uint8_t byte = data[i];
+
+		switch(state)
+		{
+			case State::source:
+				packet.value |= (uint32_t)byte << (8 * received);
+				if(++received < packet.size)
+				{
+					break;
+				}
+				state = State::header;
+				if(hardware)
+				{
+					statistic.hardwareCount++;
+					break;
+				}
+				statistic.portPacket[packet.port]++;
+				statistic.portByte[packet.port] += packet.size;
+				onPacket(packet);
+				break;
+
+			case State::continuation:
+				if((byte & continuation) == 0)
+				{
+					state = State::header;
+				}
+				break;
+
+			case State::header:
+				if(byte == 0x00)
+				{
+					zeroCount = zeroCount < syncZero ? zeroCount + 1 : zeroCount;
+					break;
+				}
+				if(byte == syncEnd && zeroCount == syncZero)
+				{
+					statistic.syncCount++;
+					zeroCount = 0;
+					break;
+				}
+				zeroCount = 0;
+				if(byte == overflowHeader)
+				{
+					statistic.overflowCount++;
+				}
+				else if((byte & 0x03) != 0)
+				{
+					// Port 31-27, hardware 2, size 1-0
+					packet = {(uint8_t)(byte >> 3), (uint8_t)(1 << ((byte & 0x03) - 1)), 0};
+					hardware = (byte & 0x04) != 0;
+					received = 0;
+					state = State::source;
+				}
+				else if((byte & 0x0F) == 0 && ((byte & 0xC0) == 0xC0 || (byte & 0x80) == 0))
+				{
+					// Local timestamp, format 1 has payload, format 2 none
+					statistic.timestampCount++;
+					state = (byte & 0xC0) == 0xC0 ? State::continuation : State::header;
+				}
+				else if(byte == globalTimestamp1 || byte == globalTimestamp2)
+				{
+					statistic.timestampCount++;
+					state = State::continuation;
+				}
+				else if((byte & 0x0B) == 0x08)
+				{
+					// Extension, payload while bit 7 set
+					state = (byte & continuation) != 0 ? State::continuation : State::header;
+				}
+				else
+				{
+					statistic.errorCount++;
+				}
+				break;
+		}
+	}
+}
+
+/*******************************************************************************
+ * @fn      Profiler::Add
+ * @brief   Pair end word with the start word of its task
+ * @param   profile
+ *          cycle
+ * @return  true: cycle is run time
+ ******************************************************************************/
+bool Profiler::Add(const Profile &profile, uint32_t *cycle)
+{
+	if(!profile.end)
+	{
+		startCycle[profile.id] = profile.cycle;
+		started[profile.id] = true;
+		return false;
+	}
+	if(!started[profile.id])
+	{
+		return false;
+	}
+	started[profile.id] = false;
+	*cycle = (profile.cycle - startCycle[profile.id]) & 0x00FFFFFF;
+	return true;
+}
+
+/*******************************************************************************
+ * @fn      DecodeTransition
+ * @brief   Event 31-16, from 15-8, to 7-0
+ ******************************************************************************/
+Transition DecodeTransition(uint32_t word)
+{
+	return {(uint8_t)(word >> 8), (uint8_t)word, (uint16_t)(word >> 16)};
+}
+
+/*******************************************************************************
+ * @fn      DecodeTimer
+ * @brief   Timer ID 31-24, HAL tick 23-0
+ ******************************************************************************/
+Timer DecodeTimer(uint32_t word)
+{
+	return {(uint8_t)(word >> 24), word & 0x00FFFFFF};
+}
+
+/*******************************************************************************
+ * @fn      DecodeProfile
+ * @brief   End 31, task ID 30-24, cycle counter 23-0
+ ******************************************************************************/
+Profile DecodeProfile(uint32_t word)
+{
+	return {(uint8_t)((word >> 24) & 0x7F), (word >> 31) != 0, word & 0x00FFFFFF};
+}
+
+} // namespace itm
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * Filename:			itm_demux.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Host demultiplexer of a captured SWO byte stream into
+ *						ITM stimulus port writes, with decoders of the
+ *						ITM_TRACE_* word layouts of itm_trace.h
+*******************************************************************************/
+
+#ifndef _ITM_DEMUX_H_
+#define _ITM_DEMUX_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "itm_trace.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace itm
+{
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+static constexpr uint8_t numOfPort = 32;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Stimulus port write, value holds size bytes, first byte lowest
+struct Packet
+{
+	uint8_t port;
+	uint8_t size;					// 1, 2 or 4
+	uint32_t value;
+};
+
+// Demultiplexer statistic
+struct Statistic
+{
+	uint64_t byteCount;				// Bytes fed
+	uint64_t portPacket[numOfPort];	// Stimulus port writes
+	uint64_t portByte[numOfPort];	// Payload bytes of port writes
+	uint64_t syncCount;
+	uint64_t overflowCount;			// ITM FIFO overflow, writes were lost
+	uint64_t timestampCount;		// Local and global timestamps skipped
+	uint64_t hardwareCount;			// DWT packets skipped
+	uint64_t errorCount;			// Reserved headers skipped
+};
+
+// ITM_TRACE_TRANSITION
+struct Transition
+{
+	uint8_t from;					// eMACHINE_STATUS
+	uint8_t to;
+	uint16_t event;					// eMACHINE_EVENT
+};
+
+// ITM_TRACE_TIMER
+struct Timer
+{
+	uint8_t id;
+	uint32_t tick;					// HAL tick, 24 bits
+};
+
+// ITM_TRACE_PROFILE
+struct Profile
+{
+	uint8_t id;						// Scheduler task ID
+	bool end;
+	uint32_t cycle;					// Cycle counter, 24 bits
+};
+
+/*******************************************************************************
+ * CLASS
+ ******************************************************************************/
+// Stream decoder of ITM packets. Any split of the stream gives the same
+// packets, bytes before the first header or after an error are skipped
+class Demux
+{
+public:
+	using PacketHandler = std::function<void(const Packet &packet)>;
+
+	explicit Demux(PacketHandler onPacket) : onPacket(onPacket) {}
+
+	void Feed(const uint8_t *data, size_t length);
+	const Statistic &GetStatistic() const { return statistic; }
+
+private:
+	enum class State
+	{
+		header,
+		source,						// Payload of a source packet
+		continuation,				// Payload bytes while bit 7 is set
+	};
+
+	PacketHandler onPacket;
+	Statistic statistic = {};
+	State state = State::header;
+	Packet packet = {};
+	bool hardware = false;
+	uint8_t received = 0;
+	uint8_t zeroCount = 0;
+};
+
+// Task run time from start and end words of the profile port
+class Profiler
+{
+public:
+	// true at end word after a start word of the same task, cycle holds
+	// run time modulo 2^24
+	bool Add(const Profile &profile, uint32_t *cycle);
+
+private:
+	uint32_t startCycle[0x80] = {};
+	bool started[0x80] = {};
+};
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+Transition DecodeTransition(uint32_t word);
+Timer DecodeTimer(uint32_t word);
+Profile DecodeProfile(uint32_t word);
+
+} // namespace itm
+
+#endif /* _ITM_DEMUX_H_ */
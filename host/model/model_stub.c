@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * Filename:			model_stub.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Modules the state model links but does not check. No
+ *						flash, telemetry or trace, every model copy has its
+ *						own core state
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "flash_journal.h"
+#include "cycle_counter.h"
+#include "crc.h"
+#include "telemetry.h"
+#include "flow_vm.h"
+#include "itm_trace.h"
+#include "log.h"
+#include "fault_capture.h"
+#include "scheduler.h"
+#include "software_timer.h"
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+uint32_t hostPrimask;
+void (*hostIdleHook)(void);
+uint32_t (*hostCycleHook)(void);
+DWT_Type hostDWT;
+TIM_HandleTypeDef htim6;
+uint8_t logLevel;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      StubNone
+ * @brief   Call without effect
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+static void StubNone(void)
+{
+}
+
+/*******************************************************************************
+ * @fn      StubMount
+ * @brief   Empty journal, machine starts cold without credit
+ * @param   psRecord
+ * @return  false
+ ******************************************************************************/
+static bool StubMount(sFLASH_JOURNAL_RECORD *psRecord)
+{
+	return false;
+}
+
+/*******************************************************************************
+ * @fn      StubWrite
+ * @brief   Journal record is dropped
+ * @param   psRecord
+ * @return  None
+ ******************************************************************************/
+static void StubWrite(const sFLASH_JOURNAL_RECORD *psRecord)
+{
+}
+
+/*******************************************************************************
+ * @fn      StubCalculate
+ * @brief   Snapshot CRC, snapshot is never restored in the model
+ * @param   data
+ *          numOfWord
+ * @return  0
+ ******************************************************************************/
+static uint32_t StubCalculate(const void *data, uint32_t numOfWord)
+{
+	return 0;
+}
+
+/*******************************************************************************
+ * @fn      StubTransition
+ * @brief   Transition telemetry is dropped
+ * @param   eFrom
+ *          eTo
+ *          eEvent
+ * @return  None
+ ******************************************************************************/
+static void StubTransition(eMACHINE_STATUS eFrom, eMACHINE_STATUS eTo, eMACHINE_EVENT eEvent)
+{
+}
+
+/*******************************************************************************
+ * @fn      StubWord
+ * @brief   Trace word is dropped
+ * @param   eItmChannel
+ *          value
+ * @return  None
+ ******************************************************************************/
+static void StubWord(eITM_CHANNEL eItmChannel, uint32_t value)
+{
+}
+
+/*******************************************************************************
+ * @fn      StubPrintf
+ * @brief   Log is dropped, logLevel 0 keeps it from being called
+ * @param   format
+ * @return  None
+ ******************************************************************************/
+static void StubPrintf(const char *format, ...)
+{
+}
+
+/*******************************************************************************
+ * @fn      StubResetByException
+ * @brief   Every model start is a power on
+ * @param   None
+ * @return  false
+ ******************************************************************************/
+static bool StubResetByException(void)
+{
+	return false;
+}
+
+/*******************************************************************************
+ * @fn      StubRegister
+ * @brief   Model runs the coroutine task itself
+ * @param   taskId
+ *          psTask
+ * @return  None
+ ******************************************************************************/
+static void StubRegister(uint8_t taskId, const sSCHEDULER_TASK *psTask)
+{
+}
+
+/*******************************************************************************
+ * HAL FUNCTIONS
+ ******************************************************************************/
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim)
+{
+	return HAL_OK;
+}
+
+// Flow program is off, FLOW_VM_ENABLE
+const sFLOW_VM sFlowVm = {0};
+
+const sFLASH_JOURNAL sFlashJournal =
+{
+	.Mount = StubMount,
+	.Write = StubWrite,
+	.Process = StubNone,
+};
+
+const sCYCLE_COUNTER sCycleCounter =
+{
+	.Enable = StubNone,
+};
+
+const sCRC sCrc =
+{
+	.Calculate = StubCalculate,
+};
+
+const sTELEMETRY sTelemetry =
+{
+	.Transition = StubTransition,
+};
+
+const sITM_TRACE sItmTrace =
+{
+	.Word = StubWord,
+};
+
+const sLOG sLog =
+{
+	.Printf = StubPrintf,
+};
+
+const sFAULT_CAPTURE sFaultCapture =
+{
+	.ResetByException = StubResetByException,
+};
+
+const sSCHEDULER sScheduler =
+{
+	.Register = StubRegister,
+};
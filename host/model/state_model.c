@@ -0,0 +1,228 @@
+/*******************************************************************************
+ * Filename:			state_model.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    State machine source is included to reach its state,
+ *						region, coroutine, event flag and software timer are
+ *						the firmware modules. Time runs on timer events only
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "../../Core/Src/state_machine.c"
+#include "state_model.h"
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+// HAL tick of this model copy, advanced by timer events
+static uint32_t modelTick;
+
+/*******************************************************************************
+ * @fn      HAL_GetTick
+ * @brief   Model time in ms
+ * @param   None
+ * @return  Tick
+ ******************************************************************************/
+uint32_t HAL_GetTick(void)
+{
+	return modelTick;
+}
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      ModelLoad
+ * @brief   Put state into state machine, coroutine, flags and timers. Audit
+ *          counters start from 0 to give the outcome
+ * @param   psState
+ * @return  None
+ ******************************************************************************/
+static void ModelLoad(const sMODEL_STATE *psState)
+{
+	uint8_t i = 0;
+
+	sStateMachinePro.eCurrentMachineStatus = (eMACHINE_STATUS)psState->status;
+	memcpy(sStateMachinePro.regionState, psState->regionState, sizeof(sStateMachinePro.regionState));
+	sStateMachinePro.flowState = psState->flowState;
+	sStateMachinePro.totalCoin = psState->totalCoin;
+	sStateMachinePro.heldCoin = psState->heldCoin;
+	sStateMachinePro.lifetimeCoin = 0;
+	sStateMachinePro.lifetimeVend = 0;
+	psDispenseCoroutine->waitMask = psState->waitMask;
+	psDispenseCoroutine->signal = psState->signal;
+	psDispenseCoroutine->received = psState->received;
+	psDispenseCoroutine->resume = psState->resume;
+	psDispenseCoroutine->finished = psState->finished;
+	((sDISPENSE_LOCAL *)psDispenseCoroutine->local)->period = psState->period;
+	for(i = 0; i < NUM_OF_SOFTWARE_TIMER; i++)
+	{
+		if(psState->countdown[i] > 0)
+		{
+			sSoftwareTimer.Start(i, psState->countdown[i]);
+		}
+		else
+		{
+			sSoftwareTimer.Stop(i);
+		}
+	}
+	for(i = 0; i < EVENT_FLAG_NUM_OF_WORD; i++)
+	{
+		eventFlags[i] = psState->eventFlags[i];
+	}
+}
+
+/*******************************************************************************
+ * @fn      ModelSave
+ * @brief   Take state back, padding cleared for byte compare
+ * @param   psState
+ * @return  None
+ ******************************************************************************/
+static void ModelSave(sMODEL_STATE *psState)
+{
+	uint8_t i = 0;
+
+	memset(psState, 0, sizeof(sMODEL_STATE));
+	psState->status = sStateMachinePro.eCurrentMachineStatus;
+	memcpy(psState->regionState, sStateMachinePro.regionState, sizeof(psState->regionState));
+	psState->flowState = sStateMachinePro.flowState;
+	psState->totalCoin = sStateMachinePro.totalCoin;
+	psState->heldCoin = sStateMachinePro.heldCoin;
+	psState->waitMask = psDispenseCoroutine->waitMask;
+	psState->signal = psDispenseCoroutine->signal;
+	psState->received = psDispenseCoroutine->received;
+	psState->resume = psDispenseCoroutine->resume;
+	psState->finished = psDispenseCoroutine->finished;
+	psState->period = ((sDISPENSE_LOCAL *)psDispenseCoroutine->local)->period;
+	for(i = 0; i < NUM_OF_SOFTWARE_TIMER; i++)
+	{
+		psState->countdown[i] = sSoftwareTimer.GetCountdown(i);
+	}
+	for(i = 0; i < EVENT_FLAG_NUM_OF_WORD; i++)
+	{
+		psState->eventFlags[i] = eventFlags[i];
+	}
+}
+
+/*******************************************************************************
+ * @fn      ModelNextExpiry
+ * @brief   Time to the first timer that runs out
+ * @param   None
+ * @return  ms, 0 when no timer runs
+ ******************************************************************************/
+static uint32_t ModelNextExpiry(void)
+{
+	uint32_t next = 0;
+	uint32_t countdown = 0;
+	uint8_t i = 0;
+
+	for(i = 0; i < NUM_OF_SOFTWARE_TIMER; i++)
+	{
+		countdown = sSoftwareTimer.GetCountdown(i);
+		if(countdown > 0 && (next == 0 || countdown < next))
+		{
+			next = countdown;
+		}
+	}
+	return next;
+}
+
+static void ModelInitialize(sMODEL_STATE *psState);
+static bool ModelStep(const sMODEL_STATE *psState, eMODEL_EVENT eModelEvent, sMODEL_STATE *psNext, sMODEL_OUTCOME *psOutcome);
+static void ModelGetCoverage(sSTATE_MACHINE_COVERAGE *psCoverage);
+
+/*******************************************************************************
+ * @fn      ModelInitialize
+ * @brief   Cold start with empty journal, once per model copy
+ * @param   psState		State after start
+ * @return  None
+ ******************************************************************************/
+static void ModelInitialize(sMODEL_STATE *psState)
+{
+	sStateMachine.Initialize();
+	ModelSave(psState);
+}
+
+/*******************************************************************************
+ * @fn      ModelStep
+ * @brief   Apply one event to a state
+ * @param   psState
+ *          eModelEvent
+ *          psNext		Resulting state
+ *          psOutcome
+ * @return  true
+ *          false	Event can not happen in this state
+ ******************************************************************************/
+static bool ModelStep(const sMODEL_STATE *psState, eMODEL_EVENT eModelEvent, sMODEL_STATE *psNext, sMODEL_OUTCOME *psOutcome)
+{
+	uint32_t period = 0;
+
+	ModelLoad(psState);
+	switch(eModelEvent)
+	{
+		case insertCoinModelEvent:
+			sStateMachine.InsertCoin();
+			break;
+		case insertCoinsModelEvent:
+			sStateMachine.InsertCoins(UINT8_MAX);
+			break;
+		case dispenseButtonModelEvent:
+			sStateMachine.DispenseButtonPressed();
+			break;
+		case maintenanceStartModelEvent:
+			sStateMachine.Maintenance(true);
+			break;
+		case maintenanceEndModelEvent:
+			sStateMachine.Maintenance(false);
+			break;
+		case timerModelEvent:
+			period = ModelNextExpiry();
+			if(period == 0)
+			{
+				return false;
+			}
+			// 1 ms timer interrupts up to the expiry
+			while(period-- > 0)
+			{
+				modelTick++;
+				SoftwareTimerInterruptCallback();
+			}
+			break;
+		case coroutineModelEvent:
+			// Main loop takes the flag, then runs the task
+			if((eventFlags[coroutineEventFlag / 32] & ((uint32_t)0x01 << (coroutineEventFlag % 32))) == 0)
+			{
+				return false;
+			}
+			sEventFlag.Clear(coroutineEventFlag);
+			sCoroutine.Run();
+			break;
+		default:
+			return false;
+	}
+	ModelSave(psNext);
+	psOutcome->acceptedCoin = sStateMachinePro.lifetimeCoin;
+	psOutcome->vend = sStateMachinePro.lifetimeVend;
+	return true;
+}
+
+/*******************************************************************************
+ * @fn      ModelGetCoverage
+ * @brief   Status and event coverage of all steps of this model copy
+ * @param   psCoverage
+ * @return  None
+ ******************************************************************************/
+static void ModelGetCoverage(sSTATE_MACHINE_COVERAGE *psCoverage)
+{
+	sStateMachine.GetCoverage(psCoverage);
+}
+
+// State model
+const sSTATE_MODEL sStateModel =
+{
+	ModelInitialize,
+	ModelStep,
+	ModelGetCoverage,
+};
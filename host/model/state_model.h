@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * Filename:			state_model.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    State machine with coroutine, event flags and software
+ *						timer as one explicit state. Built as shared object,
+ *						a checker thread loads its own copy with dlmopen
+*******************************************************************************/
+
+#ifndef _STATE_MODEL_H_
+#define _STATE_MODEL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "state_machine.h"
+#include "software_timer.h"
+#include "event_flag.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define STATE_MODEL_SYMBOL		"sStateModel"
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Inputs of the model, any of them may come next
+typedef enum
+{
+	insertCoinModelEvent = 0,
+	insertCoinsModelEvent,			// UINT8_MAX coins in one pulse train
+	dispenseButtonModelEvent,
+	maintenanceStartModelEvent,
+	maintenanceEndModelEvent,
+	timerModelEvent,				// Time runs to next timer expiry
+	coroutineModelEvent,			// Main loop runs coroutine task
+	totalModelEvent,
+}
+eMODEL_EVENT;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Everything that decides the next transition. Audit counters only grow and
+// are left out, fields are compared as bytes so padding is zero
+typedef struct
+{
+	uint32_t heldCoin;
+	uint32_t waitMask;				// Dispense coroutine frame
+	uint32_t signal;
+	uint32_t received;
+	uint32_t period;
+	uint32_t countdown[NUM_OF_SOFTWARE_TIMER];
+	uint32_t eventFlags[EVENT_FLAG_NUM_OF_WORD];
+	uint16_t resume;
+	uint8_t regionState[maximumRegion];
+	uint8_t status;
+	uint8_t flowState;
+	uint8_t totalCoin;
+	uint8_t finished;
+}
+sMODEL_STATE;
+
+// What a step did beside the state change
+typedef struct
+{
+	uint32_t acceptedCoin;			// Lifetime coin increase
+	uint32_t vend;					// Lifetime vend increase
+}
+sMODEL_OUTCOME;
+
+// Define state model function structure
+typedef struct _sSTATE_MODEL
+{
+	void (*Initialize)(sMODEL_STATE *psState);
+	bool (*Step)(const sMODEL_STATE *psState, eMODEL_EVENT eModelEvent, sMODEL_STATE *psNext, sMODEL_OUTCOME *psOutcome);
+	void (*GetCoverage)(sSTATE_MACHINE_COVERAGE *psCoverage);
+}
+sSTATE_MODEL;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+extern const sSTATE_MODEL sStateModel;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _STATE_MODEL_H_ */
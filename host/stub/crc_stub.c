@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * Filename:			crc_stub.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    CRC for host build, crc.c feeds the CRC unit which
+ *						is plain memory here
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "crc.h"
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+// Same result as the CRC unit at reset configuration, word bits MSB first
+static uint32_t CrcCalculate(const void *data, uint32_t numOfWord)
+{
+	const uint32_t *word = data;
+	uint32_t crc = 0xFFFFFFFF;
+	uint32_t i = 0;
+	uint8_t j = 0;
+
+	for(i = 0; i < numOfWord; i++)
+	{
+		crc ^= word[i];
+		for(j = 0; j < 32; j++)
+		{
+			crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+// CRC function structure
+const sCRC sCrc =
+{
+	CrcCalculate,
+};
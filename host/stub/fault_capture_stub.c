@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * Filename:			fault_capture_stub.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Fault capture for host build, fault_capture.c holds
+ *						ARM handler assembly
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "fault_capture.h"
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+static void FaultCaptureInitialize(void)
+{
+}
+
+static __attribute__((noreturn)) void FaultCaptureError(uint32_t caller)
+{
+	fprintf(stderr, "Fault capture error from 0x%08lX\n", (unsigned long)caller);
+	abort();
+}
+
+static void FaultCapturePrint(void)
+{
+}
+
+static void FaultCaptureClear(void)
+{
+}
+
+static void FaultCaptureTest(void)
+{
+}
+
+static bool FaultCaptureResetByException(void)
+{
+	return false;
+}
+
+// Fault capture function structure
+const sFAULT_CAPTURE sFaultCapture =
+{
+	FaultCaptureInitialize,
+	FaultCaptureError,
+	FaultCapturePrint,
+	FaultCaptureClear,
+	FaultCaptureTest,
+	FaultCaptureResetByException,
+};
@@ -0,0 +1,452 @@
+/*******************************************************************************
+ * Filename:			host_hal.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Stub HAL for host build. Peripherals are RAM, flash is
+ *						mapped at its target address so linker symbols hold
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "host_hal.h"
+#include "main.h"
+#include <sys/mman.h>
+#include <time.h>
+
+/*******************************************************************************
+ * ENUMERATE
+ ******************************************************************************/
+// Flash operation in flight
+typedef enum
+{
+	noneHostFlash = 0,
+	programHostFlash,
+	eraseHostFlash,
+}
+eHOST_FLASH;
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define host flash property structure
+typedef struct
+{
+	eHOST_FLASH eOperation;
+	uint32_t address;
+	uint64_t data;
+}
+sHOST_FLASH_PRO;
+static sHOST_FLASH_PRO sHostFlashPro;
+
+// DMA started by firmware
+typedef struct
+{
+	DMA_HandleTypeDef *hdma;
+	uint32_t memory;
+	uint32_t length;
+	uint8_t size;			// Bytes per memory element
+	bool circular;
+	bool busy;
+}
+sHOST_DMA;
+static sHOST_DMA sHostDma[HOST_DMA_SIZE];
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+#define HOST_PERIPHERAL_DEFINE(type, name)	type host##name;
+HOST_PERIPHERAL_LIST(HOST_PERIPHERAL_DEFINE)
+
+uint32_t hostPrimask;
+void (*hostIdleHook)(void);
+uint32_t (*hostCycleHook)(void);
+volatile uint32_t hostTick;
+uint32_t hostFlashRefuse;
+sHOST_FLASH_STATISTIC sHostFlashStatistic;
+void (*hostDmaTransmitHook)(const uint8_t *data, uint32_t length);
+
+uint32_t SystemCoreClock = 80000000;
+uint32_t uwTickPrio = (1UL << __NVIC_PRIO_BITS);
+
+/*******************************************************************************
+ * @fn      HostFlashMap
+ * @brief   Map simulated flash before main, firmware takes its address from
+ *          linker symbols
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+__attribute__((constructor)) static void HostFlashMap(void)
+{
+	void *flash = mmap((void *)HOST_FLASH_START, HOST_FLASH_SIZE, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+	if(flash != (void *)HOST_FLASH_START)
+	{
+		fprintf(stderr, "Cannot map flash at 0x%08X\n", HOST_FLASH_START);
+		exit(EXIT_FAILURE);
+	}
+	HostFlashErase();
+	// Oscillators ready at once
+	RCC->CR |= RCC_CR_HSIRDY | RCC_CR_MSIRDY | RCC_CR_PLLRDY;
+}
+
+/*******************************************************************************
+ * @fn      HostFlashErase
+ * @brief   Erase all simulated flash
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+void HostFlashErase(void)
+{
+	memset((void *)HOST_FLASH_START, 0xFF, HOST_FLASH_SIZE);
+	memset(&sHostFlashPro, 0, sizeof(sHostFlashPro));
+	memset(&sHostFlashStatistic, 0, sizeof(sHostFlashStatistic));
+}
+
+/*******************************************************************************
+ * @fn      HostFlashStart
+ * @brief   Take operation unless one is in flight or refusal is injected
+ * @param   eOperation
+ *          address
+ *          data
+ * @return  HAL status
+ ******************************************************************************/
+static HAL_StatusTypeDef HostFlashStart(eHOST_FLASH eOperation, uint32_t address, uint64_t data)
+{
+	if(sHostFlashPro.eOperation != noneHostFlash)
+	{
+		return HAL_BUSY;
+	}
+	if(hostFlashRefuse > 0)
+	{
+		hostFlashRefuse--;
+		sHostFlashStatistic.refuseCount++;
+		return HAL_ERROR;
+	}
+	sHostFlashPro.eOperation = eOperation;
+	sHostFlashPro.address = address;
+	sHostFlashPro.data = data;
+	return HAL_OK;
+}
+
+/*******************************************************************************
+ * @fn      HostFlashComplete
+ * @brief   Finish operation in flight. Program needs an erased double word
+ *          like PROGERR on target
+ * @param   None
+ * @return  false: none in flight
+ ******************************************************************************/
+bool HostFlashComplete(void)
+{
+	sHOST_FLASH_PRO sOperation = sHostFlashPro;
+	uint64_t *doubleWord = (uint64_t *)(uintptr_t)sOperation.address;
+
+	if(sOperation.eOperation == noneHostFlash)
+	{
+		return false;
+	}
+	sHostFlashPro.eOperation = noneHostFlash;
+	if(sOperation.address < HOST_FLASH_START || sOperation.address >= HOST_FLASH_START + HOST_FLASH_SIZE)
+	{
+		sHostFlashStatistic.errorCount++;
+		HAL_FLASH_OperationErrorCallback(sOperation.address);
+		return true;
+	}
+	if(sOperation.eOperation == eraseHostFlash)
+	{
+		memset(doubleWord, 0xFF, FLASH_PAGE_SIZE);
+		sHostFlashStatistic.eraseCount++;
+		sHostFlashStatistic.pageErase[(sOperation.address - HOST_FLASH_START) / FLASH_PAGE_SIZE]++;
+		HAL_FLASH_EndOfOperationCallback(0xFFFFFFFF);
+		return true;
+	}
+	if(*doubleWord != UINT64_MAX)
+	{
+		sHostFlashStatistic.errorCount++;
+		HAL_FLASH_OperationErrorCallback(sOperation.address);
+		return true;
+	}
+	*doubleWord = sOperation.data;
+	sHostFlashStatistic.programCount++;
+	HAL_FLASH_EndOfOperationCallback(sOperation.address);
+	return true;
+}
+
+/*******************************************************************************
+ * @fn      HostDmaFind
+ * @brief   DMA slot of handle, new slot when not started before
+ * @param   hdma
+ * @return  Slot
+ ******************************************************************************/
+static sHOST_DMA *HostDmaFind(DMA_HandleTypeDef *hdma)
+{
+	uint8_t i = 0;
+
+	for(i = 0; i < HOST_DMA_SIZE; i++)
+	{
+		if(sHostDma[i].hdma == hdma || sHostDma[i].hdma == NULL)
+		{
+			sHostDma[i].hdma = hdma;
+			return &sHostDma[i];
+		}
+	}
+	fprintf(stderr, "Increase HOST_DMA_SIZE\n");
+	abort();
+}
+
+/*******************************************************************************
+ * @fn      HostDmaReceive
+ * @brief   Write into circular buffer at CNDTR position like DMA does,
+ *          CNDTR counts memory elements
+ * @param   channel
+ *          data
+ *          length		Bytes, whole elements
+ * @return  None
+ ******************************************************************************/
+void HostDmaReceive(DMA_Channel_TypeDef *channel, const uint8_t *data, uint32_t length)
+{
+	sHOST_DMA *psDma = NULL;
+	uint8_t *memory = NULL;
+	uint8_t i = 0;
+
+	for(i = 0; i < HOST_DMA_SIZE && psDma == NULL; i++)
+	{
+		if(sHostDma[i].hdma != NULL && sHostDma[i].hdma->Instance == channel && sHostDma[i].circular)
+		{
+			psDma = &sHostDma[i];
+		}
+	}
+	if(psDma == NULL)
+	{
+		return;
+	}
+	memory = (uint8_t *)(uintptr_t)psDma->memory;
+	for(; length >= psDma->size; length -= psDma->size)
+	{
+		memcpy(&memory[(psDma->length - channel->CNDTR) * psDma->size], data, psDma->size);
+		data += psDma->size;
+		channel->CNDTR = channel->CNDTR == 1 ? psDma->length : channel->CNDTR - 1;
+	}
+}
+
+/*******************************************************************************
+ * @fn      HostDmaComplete
+ * @brief   Send memory to peripheral transfers to hook, callback may start
+ *          the next one
+ * @param   None
+ * @return  false: none in flight
+ ******************************************************************************/
+bool HostDmaComplete(void)
+{
+	bool completed = false;
+	uint8_t i = 0;
+
+	for(i = 0; i < HOST_DMA_SIZE; i++)
+	{
+		if(sHostDma[i].busy)
+		{
+			HAL_DMA_IRQHandler(sHostDma[i].hdma);
+			completed = true;
+		}
+	}
+	return completed;
+}
+
+/*******************************************************************************
+ * @fn      HostNanosecond
+ * @brief   Monotonic host time
+ * @param   None
+ * @return  Nanoseconds
+ ******************************************************************************/
+uint64_t HostNanosecond(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+/*******************************************************************************
+ * HAL FUNCTIONS
+ ******************************************************************************/
+HAL_StatusTypeDef HAL_FLASH_Program_IT(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+	return HostFlashStart(programHostFlash, Address, Data);
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase_IT(FLASH_EraseInitTypeDef *pEraseInit)
+{
+	uint32_t address = FLASH_BASE + pEraseInit->Page * FLASH_PAGE_SIZE;
+
+	if(pEraseInit->Banks == FLASH_BANK_2)
+	{
+		address += FLASH_BANK_SIZE;
+	}
+	return HostFlashStart(eraseHostFlash, address, 0);
+}
+
+__weak void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue)
+{
+}
+
+__weak void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue)
+{
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+	return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void)
+{
+	return hostTick;
+}
+
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+	return HAL_OK;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	return (GPIOx->IDR & GPIO_Pin) != 0 ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+}
+
+void HAL_MPU_Enable(uint32_t MPU_Control)
+{
+}
+
+void HAL_MPU_Disable(void)
+{
+}
+
+void HAL_MPU_ConfigRegion(MPU_Region_InitTypeDef *MPU_Init)
+{
+}
+
+HAL_StatusTypeDef HAL_PWREx_ControlVoltageScaling(uint32_t VoltageScaling)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+	sHOST_DMA *psDma = HostDmaFind(hdma);
+
+	psDma->circular = hdma->Init.Mode == DMA_CIRCULAR;
+	psDma->memory = hdma->Init.Direction == DMA_PERIPH_TO_MEMORY ? DstAddress : SrcAddress;
+	psDma->length = DataLength;
+	psDma->size = hdma->Init.MemDataAlignment == DMA_MDATAALIGN_WORD ? 4 :
+			hdma->Init.MemDataAlignment == DMA_MDATAALIGN_HALFWORD ? 2 : 1;
+	hdma->Instance->CNDTR = DataLength;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+	sHOST_DMA *psDma = HostDmaFind(hdma);
+
+	if(psDma->busy)
+	{
+		return HAL_BUSY;
+	}
+	HAL_DMA_Start(hdma, SrcAddress, DstAddress, DataLength);
+	psDma->busy = true;
+	return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+	sHOST_DMA *psDma = HostDmaFind(hdma);
+
+	if(!psDma->busy)
+	{
+		return;
+	}
+	psDma->busy = false;
+	hdma->Instance->CNDTR = 0;
+	if(hostDmaTransmitHook != NULL)
+	{
+		hostDmaTransmitHook((const uint8_t *)(uintptr_t)psDma->memory, psDma->length);
+	}
+	if(hdma->XferCpltCallback != NULL)
+	{
+		hdma->XferCpltCallback(hdma);
+	}
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Init(TIM_HandleTypeDef *htim)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_IC_InitTypeDef *sConfig, uint32_t Channel)
+{
+	return HAL_OK;
+}
+
+// Capture timestamps come from HostDmaReceive, DMA interrupt is not raised
+HAL_StatusTypeDef HAL_TIM_IC_Start_DMA(TIM_HandleTypeDef *htim, uint32_t Channel, uint32_t *pData, uint16_t Length)
+{
+	return HAL_DMA_Start(htim->hdma[TIM_DMA_ID_CC1 + Channel / 4], (uint32_t)(uintptr_t)&htim->Instance->CCR1 + Channel,
+			(uint32_t)(uintptr_t)pData, Length);
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim,
+		TIM_MasterConfigTypeDef *sMasterConfig)
+{
+	return HAL_OK;
+}
+
+void SystemCoreClockUpdate(void)
+{
+}
+
+void Error_Handler(void)
+{
+	fprintf(stderr, "Error_Handler\n");
+	abort();
+}
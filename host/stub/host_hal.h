@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Filename:			host_hal.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Host side of stub HAL, time, flash, idle control,
+ *						console pseudo-terminal and LPTIM pulse counter for
+ *						tests and tools
+*******************************************************************************/
+
+#ifndef _HOST_HAL_H_
+#define _HOST_HAL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "common.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Simulated flash covers FLOW and JOURNAL regions of the linker scripts
+#define HOST_FLASH_START		0x080F7000
+#define HOST_FLASH_SIZE			0x9000
+// DMA handles started at once
+#define HOST_DMA_SIZE			4
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Simulated flash statistic
+typedef struct
+{
+	uint32_t programCount;		// Double words programmed
+	uint32_t eraseCount;		// Pages erased
+	uint32_t errorCount;		// Programs onto unerased double word
+	uint32_t refuseCount;		// Operations refused at start
+	uint32_t pageErase[HOST_FLASH_SIZE / FLASH_PAGE_SIZE];	// Erases per page
+}
+sHOST_FLASH_STATISTIC;
+
+/*******************************************************************************
+ * PUBLIC VARIABLES
+ ******************************************************************************/
+// HAL_GetTick value, tests advance it
+extern volatile uint32_t hostTick;
+// Next n flash operations are refused with HAL_ERROR at start
+extern uint32_t hostFlashRefuse;
+extern sHOST_FLASH_STATISTIC sHostFlashStatistic;
+// Memory to peripheral DMA sink, e.g. console TX bytes
+extern void (*hostDmaTransmitHook)(const uint8_t *data, uint32_t length);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+// Erase all simulated flash to 0xFF
+void HostFlashErase(void);
+// Finish flash operation in flight, calls HAL end of operation or error
+// callback like FLASH_IRQHandler. false: none in flight
+bool HostFlashComplete(void);
+// Peripheral writes data through circular DMA of channel, e.g. console RX
+void HostDmaReceive(DMA_Channel_TypeDef *channel, const uint8_t *data, uint32_t length);
+// Finish memory to peripheral transfers in flight, bytes go to hook and
+// transfer complete callback runs. false: none in flight
+bool HostDmaComplete(void);
+// Monotonic host time in nanoseconds
+uint64_t HostNanosecond(void);
+// Console on pseudo-terminal, host_pty.c. Open returns slave path for a
+// terminal program, NULL on failure. Poll sends console TX, then waits up
+// to timeout ms for input and feeds it to console RX, returns bytes taken
+const char *HostPtyOpen(void);
+uint32_t HostPtyPoll(int timeout);
+void HostPtyClose(void);
+// LPTIM counter, host_lptim.c. Reset before firmware configures it, Pulse
+// counts input pulses and returns true when the interrupt is pending
+void HostLptimReset(LPTIM_TypeDef *lptim);
+bool HostLptimPulse(LPTIM_TypeDef *lptim, uint32_t numOfPulse);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HOST_HAL_H_ */
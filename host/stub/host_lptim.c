@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * Filename:			host_lptim.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    LPTIM counting external pulses for host build. CNT
+ *						counts up to ARR and wraps, compare and autoreload
+ *						match flags follow. Register writes complete at once
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "host_hal.h"
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      HostLptimReset
+ * @brief   Reset state, CMP and ARR writes show as done in ISR so firmware
+ *          does not wait for the kernel clock
+ * @param   lptim
+ * @return  None
+ ******************************************************************************/
+void HostLptimReset(LPTIM_TypeDef *lptim)
+{
+	memset(lptim, 0, sizeof(*lptim));
+	lptim->ISR = LPTIM_ISR_CMPOK | LPTIM_ISR_ARROK;
+}
+
+/*******************************************************************************
+ * @fn      HostLptimPulse
+ * @brief   Count pulses on Input1 while enabled in counter mode. Flags
+ *          cleared through ICR since last call are cleared first
+ * @param   lptim
+ *          numOfPulse
+ * @return  true	Compare or autoreload match interrupt pending
+ ******************************************************************************/
+bool HostLptimPulse(LPTIM_TypeDef *lptim, uint32_t numOfPulse)
+{
+	uint32_t i = 0;
+
+	lptim->ISR &= ~lptim->ICR | LPTIM_ISR_CMPOK | LPTIM_ISR_ARROK;
+	lptim->ICR = 0;
+	if((lptim->CR & LPTIM_CR_ENABLE) == 0 || (lptim->CFGR & LPTIM_CFGR_COUNTMODE) == 0)
+	{
+		return false;
+	}
+
+	for(i = 0; i < numOfPulse; i++)
+	{
+		lptim->CNT = lptim->CNT >= lptim->ARR ? 0 : lptim->CNT + 1;
+		if(lptim->CNT == lptim->CMP)
+		{
+			lptim->ISR |= LPTIM_ISR_CMPM;
+		}
+		if(lptim->CNT == lptim->ARR)
+		{
+			lptim->ISR |= LPTIM_ISR_ARRM;
+		}
+	}
+	return (lptim->ISR & lptim->IER & (LPTIM_ISR_CMPM | LPTIM_ISR_ARRM)) != 0;
+}
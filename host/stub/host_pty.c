@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * Filename:			host_pty.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Console on a pseudo-terminal for host build. Master
+ *						side stands for USART2, bytes move through console
+ *						DMA channels as on target
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+// posix_openpt, ptsname_r
+#define _GNU_SOURCE
+#include "host_hal.h"
+#include "console.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Define host pseudo-terminal property structure
+typedef struct
+{
+	int master;
+	// Held open so master never hangs up between terminal programs
+	int slave;
+	char path[64];
+}
+sHOST_PTY_PRO;
+static sHOST_PTY_PRO sHostPtyPro = {-1, -1, ""};
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      HostPtyTransmit
+ * @brief   Console TX DMA block to terminal, blocks while terminal is full
+ *          like DMA waits for the shift register
+ * @param   data
+ *          length
+ * @return  None
+ ******************************************************************************/
+static void HostPtyTransmit(const uint8_t *data, uint32_t length)
+{
+	ssize_t written = 0;
+
+	while(length > 0)
+	{
+		written = write(sHostPtyPro.master, data, length);
+		if(written <= 0)
+		{
+			return;
+		}
+		data += written;
+		length -= (uint32_t)written;
+	}
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      HostPtyOpen
+ * @brief   Open pseudo-terminal in raw mode, no echo and no line editing
+ *          like a serial port, and take console TX DMA
+ * @param   None
+ * @return  Slave path, NULL on failure
+ ******************************************************************************/
+const char *HostPtyOpen(void)
+{
+	struct termios sTermios;
+
+	sHostPtyPro.master = posix_openpt(O_RDWR | O_NOCTTY);
+	if(sHostPtyPro.master < 0 || grantpt(sHostPtyPro.master) != 0 || unlockpt(sHostPtyPro.master) != 0 ||
+	   ptsname_r(sHostPtyPro.master, sHostPtyPro.path, sizeof(sHostPtyPro.path)) != 0)
+	{
+		HostPtyClose();
+		return NULL;
+	}
+	sHostPtyPro.slave = open(sHostPtyPro.path, O_RDWR | O_NOCTTY);
+	if(sHostPtyPro.slave < 0 || tcgetattr(sHostPtyPro.slave, &sTermios) != 0)
+	{
+		HostPtyClose();
+		return NULL;
+	}
+	cfmakeraw(&sTermios);
+	if(tcsetattr(sHostPtyPro.slave, TCSANOW, &sTermios) != 0)
+	{
+		HostPtyClose();
+		return NULL;
+	}
+	hostDmaTransmitHook = HostPtyTransmit;
+	return sHostPtyPro.path;
+}
+
+/*******************************************************************************
+ * @fn      HostPtyPoll
+ * @brief   Send console TX in flight, then wait for terminal input. Input
+ *          goes to console RX DMA and raises the idle line interrupt. At
+ *          most half RX ring is taken per call, console runs in between
+ * @param   timeout		ms, -1 waits for input
+ * @return  Bytes received
+ ******************************************************************************/
+uint32_t HostPtyPoll(int timeout)
+{
+	struct pollfd sPoll = {sHostPtyPro.master, POLLIN, 0};
+	uint8_t data[CONSOLE_RX_SIZE / 2];
+	ssize_t length = 0;
+
+	while(HostDmaComplete())
+	{
+	}
+	if(poll(&sPoll, 1, timeout) <= 0 || (sPoll.revents & POLLIN) == 0)
+	{
+		return 0;
+	}
+	length = read(sHostPtyPro.master, data, sizeof(data));
+	if(length <= 0)
+	{
+		return 0;
+	}
+	HostDmaReceive(DMA1_Channel6, data, (uint32_t)length);
+	USART2->ISR |= USART_ISR_IDLE;
+	ConsoleInterruptCallback();
+	USART2->ISR &= ~USART_ISR_IDLE;
+	return (uint32_t)length;
+}
+
+/*******************************************************************************
+ * @fn      HostPtyClose
+ * @brief   Close pseudo-terminal, console TX DMA is dropped again
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+void HostPtyClose(void)
+{
+	if(sHostPtyPro.slave >= 0)
+	{
+		close(sHostPtyPro.slave);
+	}
+	if(sHostPtyPro.master >= 0)
+	{
+		close(sHostPtyPro.master);
+	}
+	sHostPtyPro.master = -1;
+	sHostPtyPro.slave = -1;
+	hostDmaTransmitHook = NULL;
+}
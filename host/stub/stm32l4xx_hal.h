@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * Filename:			stm32l4xx_hal.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Host build of firmware modules. Wraps ST HAL header,
+ *						core intrinsics and peripherals go to host_hal.c
+*******************************************************************************/
+
+#ifndef _HOST_STM32L4XX_HAL_H_
+#define _HOST_STM32L4XX_HAL_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+// Intrinsics with ARM assembly get other names, host versions follow
+#define __disable_irq			cmsis___disable_irq
+#define __enable_irq			cmsis___enable_irq
+#define __get_PRIMASK			cmsis___get_PRIMASK
+#define __set_PRIMASK			cmsis___set_PRIMASK
+#define __get_MSP				cmsis___get_MSP
+#define __get_IPSR				cmsis___get_IPSR
+#define __get_xPSR				cmsis___get_xPSR
+#define __DSB					cmsis___DSB
+#define __ISB					cmsis___ISB
+#define __DMB					cmsis___DMB
+#define __LDREXW				cmsis___LDREXW
+#define __STREXW				cmsis___STREXW
+
+#include_next "stm32l4xx_hal.h"
+
+#undef __disable_irq
+#undef __enable_irq
+#undef __get_PRIMASK
+#undef __set_PRIMASK
+#undef __get_MSP
+#undef __get_IPSR
+#undef __get_xPSR
+#undef __DSB
+#undef __ISB
+#undef __DMB
+#undef __LDREXW
+#undef __STREXW
+#undef __NOP
+#undef __WFI
+#undef __WFE
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * CORE INTRINSICS
+ ******************************************************************************/
+// PRIMASK is plain state, host interrupts are calls made by the test
+extern uint32_t hostPrimask;
+// Called by __WFI and __WFE, test advances time or raises interrupts here
+extern void (*hostIdleHook)(void);
+
+static inline void __disable_irq(void) { hostPrimask = 1; }
+static inline void __enable_irq(void) { hostPrimask = 0; }
+static inline uint32_t __get_PRIMASK(void) { return hostPrimask; }
+static inline void __set_PRIMASK(uint32_t primask) { hostPrimask = primask; }
+static inline uint32_t __get_MSP(void) { return (uint32_t)(uintptr_t)__builtin_frame_address(0); }
+static inline uint32_t __get_IPSR(void) { return 0; }
+static inline uint32_t __get_xPSR(void) { return 0; }
+static inline void __DSB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __ISB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __DMB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __NOP(void) { }
+static inline void __WFI(void) { if(hostIdleHook != NULL) hostIdleHook(); }
+static inline void __WFE(void) { if(hostIdleHook != NULL) hostIdleHook(); }
+
+/*******************************************************************************
+ * PERIPHERALS
+ ******************************************************************************/
+// Register blocks in RAM, a test writes what hardware would
+#define HOST_PERIPHERAL(type, name)		extern type host##name;
+
+#define HOST_PERIPHERAL_LIST(X)												\
+	X(TIM_TypeDef, TIM2)													\
+	X(TIM_TypeDef, TIM5)													\
+	X(TIM_TypeDef, TIM6)													\
+	X(LPTIM_TypeDef, LPTIM1)												\
+	X(LPTIM_TypeDef, LPTIM2)												\
+	X(USART_TypeDef, USART2)												\
+	X(DMA_TypeDef, DMA1)													\
+	X(DMA_Channel_TypeDef, DMA1_Channel5)									\
+	X(DMA_Channel_TypeDef, DMA1_Channel6)									\
+	X(DMA_Channel_TypeDef, DMA1_Channel7)									\
+	X(GPIO_TypeDef, GPIOA)													\
+	X(GPIO_TypeDef, GPIOB)													\
+	X(GPIO_TypeDef, GPIOC)													\
+	X(EXTI_TypeDef, EXTI)													\
+	X(RCC_TypeDef, RCC)														\
+	X(FLASH_TypeDef, FLASH)													\
+	X(CRC_TypeDef, CRC)														\
+	X(RTC_TypeDef, RTC)														\
+	X(DWT_Type, DWT)														\
+	X(ITM_Type, ITM)														\
+	X(TPI_Type, TPI)														\
+	X(SCB_Type, SCB)														\
+	X(NVIC_Type, NVIC)														\
+	X(MPU_Type, MPU)														\
+	X(SysTick_Type, SysTick)												\
+	X(CoreDebug_Type, CoreDebug)
+
+HOST_PERIPHERAL_LIST(HOST_PERIPHERAL)
+
+#undef TIM2
+#undef TIM5
+#undef TIM6
+#undef LPTIM1
+#undef LPTIM2
+#undef USART2
+#undef DMA1
+#undef DMA1_Channel5
+#undef DMA1_Channel6
+#undef DMA1_Channel7
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef EXTI
+#undef RCC
+#undef FLASH
+#undef CRC
+#undef RTC
+#undef DWT
+#undef ITM
+#undef TPI
+#undef SCB
+#undef NVIC
+#undef MPU
+#undef SysTick
+#undef CoreDebug
+
+#define TIM2					(&hostTIM2)
+#define TIM5					(&hostTIM5)
+#define TIM6					(&hostTIM6)
+#define LPTIM1					(&hostLPTIM1)
+#define LPTIM2					(&hostLPTIM2)
+#define USART2					(&hostUSART2)
+#define DMA1					(&hostDMA1)
+#define DMA1_Channel5			(&hostDMA1_Channel5)
+#define DMA1_Channel6			(&hostDMA1_Channel6)
+#define DMA1_Channel7			(&hostDMA1_Channel7)
+#define GPIOA					(&hostGPIOA)
+#define GPIOB					(&hostGPIOB)
+#define GPIOC					(&hostGPIOC)
+#define EXTI					(&hostEXTI)
+#define RCC						(&hostRCC)
+#define FLASH					(&hostFLASH)
+#define CRC						(&hostCRC)
+#define RTC						(&hostRTC)
+#define DWT						(&hostDWT)
+#define ITM						(&hostITM)
+#define TPI						(&hostTPI)
+#define SCB						(&hostSCB)
+#define NVIC					(&hostNVIC)
+#define MPU						(&hostMPU)
+#define SysTick					(&hostSysTick)
+#define CoreDebug				(&hostCoreDebug)
+
+// Cycle counter of cycle_counter.h, DWT->CYCCNT unless a simulation runs
+// its own clock
+extern uint32_t (*hostCycleHook)(void);
+static inline uint32_t HostCycleRead(void) { return hostCycleHook != NULL ? hostCycleHook() : DWT->CYCCNT; }
+#define CYCLE_COUNTER_READ()	HostCycleRead()
+
+// System clock switch completes at once, SWS follows SW
+#undef __HAL_RCC_GET_SYSCLK_SOURCE
+#define __HAL_RCC_GET_SYSCLK_SOURCE()	((RCC->CFGR & RCC_CFGR_SW) << RCC_CFGR_SWS_Pos)
+
+// Flash size register is in system memory, STM32L476RG has 1 MB
+#undef FLASH_SIZE
+#define FLASH_SIZE				(0x400U << 10U)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HOST_STM32L4XX_HAL_H_ */
@@ -0,0 +1,216 @@
+/*******************************************************************************
+ * Filename:			telemetry_decoder.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Host decoder of telemetry frames on the console byte
+ *						stream, console text between frames is passed on
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "telemetry_decoder.h"
+#include <cstring>
+
+namespace telemetry
+{
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Record types in eTELEMETRY_RECORD order with their size
+static const struct
+{
+	eTELEMETRY_RECORD type;
+	size_t size;
+}
+recordSize[] =
+{
+	{transitionTelemetryRecord, sizeof(sTELEMETRY_TRANSITION)},
+	{counterTelemetryRecord, sizeof(sTELEMETRY_COUNTER)},
+	{timerTelemetryRecord, sizeof(sTELEMETRY_TIMER)},
+	{coverageTelemetryRecord, sizeof(sTELEMETRY_COVERAGE)},
+};
+
+// Longest frame, pending bytes beyond it can only be text
+static constexpr size_t maximumFrame = Decoder::FrameSize(sizeof(sTELEMETRY_COVERAGE));
+
+/*******************************************************************************
+ * @fn      RecordSize
+ * @brief   Size of record type
+ * @param   type
+ * @return  0: unknown type
+ ******************************************************************************/
+static size_t RecordSize(uint8_t type)
+{
+	for(const auto &entry : recordSize)
+	{
+		if(entry.type == type)
+		{
+			return entry.size;
+		}
+	}
+	return 0;
+}
+
+/*******************************************************************************
+ * @fn      Decoder::Decoder
+ * @brief   Decoder with record and optional text handler
+ * @param   onRecord
+ *          onText
+ * @return  None
+ ******************************************************************************/
+Decoder::Decoder(RecordHandler onRecord, TextHandler onText)
+	: onRecord(std::move(onRecord)), onText(std::move(onText)), statistic()
+{
+	pending.reserve(2 * maximumFrame);
+}
+
+/*******************************************************************************
+ * @fn      Decoder::DecodeFrame
+ * @brief   COBS decode one frame, delimiter excluded
+ * @param   frame
+ *          length
+ *          record
+ * @return  false: not a valid record frame
+ ******************************************************************************/
+bool Decoder::DecodeFrame(const uint8_t *frame, size_t length, Record *record)
+{
+	uint8_t data[sizeof(sTELEMETRY_COVERAGE) + 1];
+	size_t in = 0;
+	size_t out = 0;
+	size_t size = 0;
+	uint8_t check = 0;
+	uint8_t code = 0;
+	uint8_t i = 0;
+
+	while(in < length)
+	{
+		code = frame[in++];
+		if(code == 0)
+		{
+			return false;
+		}
+		for(i = 1; i < code; i++)
+		{
+			if(in >= length || out >= sizeof(data) || frame[in] == 0)
+			{
+				return false;
+			}
+			data[out++] = frame[in++];
+		}
+		// Zero implied between blocks, not after the last one
+		if(code != 0xFF && in < length)
+		{
+			if(out >= sizeof(data))
+			{
+				return false;
+			}
+			data[out++] = 0;
+		}
+	}
+
+	size = out > 0 ? RecordSize(data[0]) : 0;
+	if(size == 0 || out != size + 1)
+	{
+		return false;
+	}
+	for(i = 0; i < out; i++)
+	{
+		check += data[i];
+	}
+	// Record sum plus inverted sum
+	if(check != 0xFF)
+	{
+		return false;
+	}
+	record->type = static_cast<eTELEMETRY_RECORD>(data[0]);
+	memcpy(&record->transition, data, size);
+	return true;
+}
+
+/*******************************************************************************
+ * @fn      Decoder::Feed
+ * @brief   Take stream bytes, handlers are called as frames end
+ * @param   data
+ *          length
+ * @return  None
+ ******************************************************************************/
+void Decoder::Feed(const uint8_t *data, size_t length)
+{
+	const uint8_t *end = data + length;
+	const uint8_t *delimiter = nullptr;
+
+	statistic.byteCount += length;
+	while(data < end)
+	{
+		delimiter = static_cast<const uint8_t *>(memchr(data, 0, end - data));
+		pending.insert(pending.end(), data, delimiter != nullptr ? delimiter : end);
+		if(delimiter == nullptr)
+		{
+			if(pending.size() >= 2 * maximumFrame)
+			{
+				Text(pending.size() - maximumFrame);
+			}
+			return;
+		}
+		Delimiter();
+		data = delimiter + 1;
+	}
+}
+
+/*******************************************************************************
+ * @fn      Decoder::Delimiter
+ * @brief   Try every record size back from delimiter, largest first so
+ *          the tail of a long frame is never taken for a short one. Bytes
+ *          before the frame are text
+ * @param   None
+ * @return  None
+ ******************************************************************************/
+void Decoder::Delimiter()
+{
+	Record record;
+	size_t frameSize = 0;
+	size_t i = 0;
+
+	for(i = sizeof(recordSize) / sizeof(recordSize[0]); i-- > 0;)
+	{
+		frameSize = FrameSize(recordSize[i].size);
+		if(pending.size() >= frameSize &&
+		   DecodeFrame(pending.data() + pending.size() - frameSize, frameSize, &record))
+		{
+			Text(pending.size() - frameSize);
+			pending.clear();
+			statistic.recordCount++;
+			if(onRecord)
+			{
+				onRecord(record);
+			}
+			return;
+		}
+	}
+	statistic.frameError++;
+	Text(pending.size());
+}
+
+/*******************************************************************************
+ * @fn      Decoder::Text
+ * @brief   Pass oldest pending bytes on as text
+ * @param   length
+ * @return  None
+ ******************************************************************************/
+void Decoder::Text(size_t length)
+{
+	if(length == 0)
+	{
+		return;
+	}
+	if(onText)
+	{
+		onText(reinterpret_cast<const char *>(pending.data()), length);
+	}
+	statistic.textCount += length;
+	pending.erase(pending.begin(), pending.begin() + length);
+}
+
+} // namespace telemetry
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * Filename:			telemetry_decoder.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Host decoder of telemetry frames on the console byte
+ *						stream, console text between frames is passed on
+*******************************************************************************/
+
+#ifndef _TELEMETRY_DECODER_H_
+#define _TELEMETRY_DECODER_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "telemetry.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace telemetry
+{
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Decoded record, type selects the member
+struct Record
+{
+	eTELEMETRY_RECORD type;
+	union
+	{
+		sTELEMETRY_TRANSITION transition;
+		sTELEMETRY_COUNTER counter;
+		sTELEMETRY_TIMER timer;
+		sTELEMETRY_COVERAGE coverage;
+	};
+};
+
+// Decoder statistic
+struct Statistic
+{
+	uint64_t byteCount;			// Bytes fed
+	uint64_t recordCount;		// Records decoded
+	uint64_t frameError;		// Delimiters ending no valid frame
+	uint64_t textCount;			// Console text bytes passed on
+};
+
+/*******************************************************************************
+ * CLASS
+ ******************************************************************************/
+// Stream decoder. A frame is found from its delimiter backwards, text may
+// run into a frame without a delimiter in between
+class Decoder
+{
+public:
+	using RecordHandler = std::function<void(const Record &record)>;
+	using TextHandler = std::function<void(const char *text, size_t length)>;
+
+	explicit Decoder(RecordHandler onRecord, TextHandler onText = nullptr);
+
+	// Any split of the stream gives the same records
+	void Feed(const uint8_t *data, size_t length);
+	// End of stream, bytes after last delimiter are text
+	void Flush() { Text(pending.size()); }
+	const Statistic &GetStatistic() const { return statistic; }
+
+	// Encoded size of a record frame, delimiter excluded
+	static constexpr size_t FrameSize(size_t recordSize) { return recordSize + 2; }
+	// COBS decode record and check byte of one frame. Record type, size and
+	// inverted byte sum must match. false: no record
+	static bool DecodeFrame(const uint8_t *frame, size_t length, Record *record);
+
+private:
+	void Delimiter();
+	void Text(size_t length);
+
+	RecordHandler onRecord;
+	TextHandler onText;
+	std::vector<uint8_t> pending;
+	Statistic statistic;
+};
+
+} // namespace telemetry
+
+#endif /* _TELEMETRY_DECODER_H_ */
@@ -0,0 +1,32 @@
+/*******************************************************************************
+ * Filename:			check.h
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Assertion of host tests, prints the failed condition
+ *						and exits non-zero, also in release builds
+*******************************************************************************/
+
+#ifndef _CHECK_H_
+#define _CHECK_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define CHECK(condition)													\
+	do																		\
+	{																		\
+		if(!(condition))													\
+		{																	\
+			fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);	\
+			exit(EXIT_FAILURE);												\
+		}																	\
+	}																		\
+	while(0)
+
+#endif /* _CHECK_H_ */
@@ -0,0 +1,81 @@
+################################################################################
+# Filename:			log_format_size.sh
+# Revised:			Date: 2026.10.19
+# Revision:			V001
+# Description:		.text that one "Total coin = %d" message links in, C
+#					library snprintf against the log formatter, built at -Os.
+#					Only the call closure is linked, no startup or sink, C
+#					library string functions used by the formatter are not
+#					counted. Host x86-64 glibc, a proxy for newlib vfprintf
+#					e.g. sh test/log_format_size.sh build
+################################################################################
+
+set -e
+BUILD=$1/log_format
+CC=${CC:-gcc}
+LIBC=$($CC -print-file-name=libc.a)
+CPPFLAGS="-DUSE_HAL_DRIVER -DSTM32L476xx -I../Core/Inc -I../Core/Src -Istub -I../Drivers/CMSIS/Include \
+	-I../Drivers/CMSIS/Device/ST/STM32L4xx/Include -I../Drivers/STM32L4xx_HAL_Driver/Inc"
+CFLAGS="-std=gnu11 -Os -fno-pie -ffunction-sections -fdata-sections -w"
+# main is the entry, sections it does not reach are dropped, symbols left
+# undefined are outside the closure
+LDFLAGS="-static -no-pie -nostdlib -nostartfiles -Wl,-e,main -Wl,--defsym=_start=main \
+	-Wl,--unresolved-symbols=ignore-all -Wl,--gc-sections"
+mkdir -p $BUILD
+
+# One message formatted into a buffer the optimizer cannot drop
+cat > $BUILD/none.c << 'EOF'
+volatile char sink;
+int main(int argc, char *argv[]) { sink = (char)argc; return 0; }
+EOF
+cat > $BUILD/snprintf.c << 'EOF'
+#include <stdio.h>
+volatile char sink;
+int main(int argc, char *argv[])
+{
+	char buffer[128];
+	sink = buffer[snprintf(buffer, sizeof(buffer), "Total coin = %d\n", argc) - 2];
+	return 0;
+}
+EOF
+cat > $BUILD/slog.c << 'EOF'
+#include "log.c"
+volatile char sink;
+static uint32_t Format(char *buffer, uint32_t size, const char *format, ...)
+{
+	uint32_t length = 0;
+	va_list args;
+
+	va_start(args, format);
+	length = LogFormat(buffer, size, format, args);
+	va_end(args);
+	return length;
+}
+int main(int argc, char *argv[])
+{
+	char buffer[128];
+	sink = buffer[Format(buffer, sizeof(buffer), "Total coin = %d\n", argc) - 2];
+	return 0;
+}
+EOF
+
+# text column of size for file
+text()
+{
+	size "$1" | awk 'NR > 1 { print $1 }'
+}
+
+# Formatter links without C library, its strlen is left undefined
+for NAME in none slog
+do
+	$CC $CPPFLAGS $CFLAGS $LDFLAGS -o $BUILD/$NAME $BUILD/$NAME.c -lgcc
+done
+$CC $CPPFLAGS $CFLAGS $LDFLAGS -o $BUILD/snprintf $BUILD/snprintf.c -Wl,--start-group $LIBC -lgcc -Wl,--end-group
+NONE=$(text $BUILD/none)
+SNPRINTF=$(($(text $BUILD/snprintf) - NONE))
+LOG=$(($(text $BUILD/slog) - NONE))
+printf "snprintf %8d bytes .text (host glibc -Os proxy)\n" $SNPRINTF
+printf "sLog     %8d bytes .text, %d less\n" $LOG $((SNPRINTF - LOG))
+
+test $LOG -lt $SNPRINTF
+echo "Log format size passed"
@@ -0,0 +1,37 @@
+################################################################################
+# Filename:			log_level_size.sh
+# Revised:			Date: 2026.10.19
+# Revision:			V001
+# Description:		Firmware modules built at -Os for every LOG_LEVEL,
+#					.text of log and modules with log sites and of all modules.
+#					Host x86-64 code, a proxy for the ARM image delta
+#					e.g. sh test/log_level_size.sh build
+################################################################################
+
+set -e
+BUILD=$1/log_level
+# Modules with log sites, log.c reports levels compiled out
+SITE="state_machine flow_vm main_loop log"
+
+# text column of size for files
+text()
+{
+	size "$@" | awk 'NR > 1 { sum += $1 } END { print sum }'
+}
+
+for LEVEL in DEBUG INFO WARNING ERROR NONE
+do
+	${MAKE:-make} -s --no-print-directory BUILD=$BUILD/$LEVEL DEFINE=-DLOG_LEVEL=LOG_LEVEL_$LEVEL OPTIMIZE=-Os \
+		$BUILD/$LEVEL/libcore.a
+	SITE_TEXT=$(text $(for NAME in $SITE; do echo $BUILD/$LEVEL/core/$NAME.o; done))
+	ALL_TEXT=$(text $BUILD/$LEVEL/core/*.o)
+	eval "SITE_$LEVEL=$SITE_TEXT ALL_$LEVEL=$ALL_TEXT"
+	printf "LOG_LEVEL_%-8s log modules %6d, all modules %6d bytes .text\n" $LEVEL $SITE_TEXT $ALL_TEXT
+done
+printf "DEBUG to WARNING: %d bytes .text less (host -Os proxy)\n" $((ALL_DEBUG - ALL_WARNING))
+
+# Lower levels remove log sites, other modules do not change
+test $SITE_WARNING -lt $SITE_DEBUG
+test $SITE_NONE -le $SITE_ERROR
+test $((ALL_DEBUG - ALL_WARNING)) -eq $((SITE_DEBUG - SITE_WARNING))
+echo "Log level size passed"
@@ -0,0 +1,211 @@
+/*******************************************************************************
+ * Filename:			test_coin_capture.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Coin capture classifier on validator pulse traces.
+ *						Source is included with COIN_CAPTURE_ENABLE set, edge
+ *						timestamps reach the buffer through the capture DMA.
+ *						The trace is generated: 1, 2 and 5 unit pulses with
+ *						width spread, short glitches and lost rising edges,
+ *						TIM2 wraps during it. Denomination totals are checked,
+ *						then classifier throughput is measured
+ *						e.g. test_coin_capture [coins] [benchmark edges]
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "coin_capture.h"
+#undef COIN_CAPTURE_ENABLE
+#define COIN_CAPTURE_ENABLE			1
+#include "../../Core/Src/coin_capture.c"
+#include "host_hal.h"
+#include "check.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_COIN					20000
+#define TEST_BENCHMARK_EDGE			20000000
+// 1 in n pulses is a glitch, 1 in n coins loses its rising edge
+#define TEST_GLITCH_RATE			50
+#define TEST_LOST_EDGE_RATE			200
+// Glitch width range in us, below every denomination
+#define TEST_GLITCH_WIDTH			5000
+// High time between pulses in us, longer after a lost edge to resync
+#define TEST_MINIMUM_GAP			50000
+#define TEST_MAXIMUM_GAP			200000
+#define TEST_RESYNC_GAP				(COIN_CAPTURE_MAXIMUM_WIDTH + 50000)
+// Events per classifier call, as MainLoop
+#define TEST_EVENT					8
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Generated trace and what the classifier should find in it
+typedef struct
+{
+	uint32_t *stamp;
+	uint32_t numOfEdge;
+	uint32_t coin[6];			// Coins per value
+	uint32_t glitch;
+	uint32_t lostEdge;
+}
+sTEST_TRACE;
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static uint64_t randomState = 0x2545F4914F6CDD1D;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      Random
+ * @brief   xorshift64, uniform in [minimum, maximum]
+ ******************************************************************************/
+static uint32_t Random(uint32_t minimum, uint32_t maximum)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 7;
+	randomState ^= randomState << 17;
+	return minimum + (uint32_t)((randomState >> 11) % (maximum - minimum + 1));
+}
+
+/*******************************************************************************
+ * @fn      Generate
+ * @brief   Trace of numOfCoin coins and the glitches between them, starts
+ *          one minute before TIM2 wraps
+ ******************************************************************************/
+static void Generate(sTEST_TRACE *psTrace, uint32_t numOfCoin)
+{
+	const sCOIN_DENOMINATION *psDenomination = NULL;
+	uint32_t now = 0xFFFFFFFF - 60000000;
+	uint32_t coin = 0;
+	bool glitch = false;
+
+	memset(psTrace, 0, sizeof(*psTrace));
+	// At most one glitch before a coin, 4 edges per coin
+	psTrace->stamp = malloc(sizeof(uint32_t) * 4 * numOfCoin);
+	CHECK(psTrace->stamp != NULL);
+
+	while(coin < numOfCoin)
+	{
+		now += Random(TEST_MINIMUM_GAP, TEST_MAXIMUM_GAP);
+		psTrace->stamp[psTrace->numOfEdge++] = now;
+		if(!glitch && Random(1, TEST_GLITCH_RATE) == 1)
+		{
+			now += Random(1, TEST_GLITCH_WIDTH);
+			psTrace->stamp[psTrace->numOfEdge++] = now;
+			psTrace->glitch++;
+			glitch = true;
+			continue;
+		}
+
+		coin++;
+		glitch = false;
+		psDenomination = &sCoinDenomination[Random(0, sizeof(sCoinDenomination) / sizeof(sCoinDenomination[0]) - 1)];
+		now += Random(psDenomination->minimumWidth, psDenomination->maximumWidth);
+		if(Random(1, TEST_LOST_EDGE_RATE) == 1)
+		{
+			// Rising edge missed, next falling edge is far enough to resync
+			now += TEST_RESYNC_GAP;
+			psTrace->lostEdge++;
+			continue;
+		}
+		psTrace->stamp[psTrace->numOfEdge++] = now;
+		psTrace->coin[psDenomination->value]++;
+	}
+}
+
+/*******************************************************************************
+ * @fn      Feed
+ * @brief   Capture DMA stores edges, less than the buffer so none is lost
+ ******************************************************************************/
+static void Feed(const uint32_t *stamp, uint32_t numOfEdge)
+{
+	HostDmaReceive(DMA1_Channel5, (const uint8_t *)stamp, numOfEdge * sizeof(uint32_t));
+}
+
+/*******************************************************************************
+ * @fn      Drain
+ * @brief   Classify until stored edges are used up, add events per value
+ ******************************************************************************/
+static void Drain(uint32_t *coin)
+{
+	sCOIN_CAPTURE_EVENT sEvent[TEST_EVENT];
+	uint8_t numOfEvent = 0;
+	uint8_t i = 0;
+
+	do
+	{
+		numOfEvent = CoinCaptureClassify(sEvent, TEST_EVENT);
+		for(i = 0; i < numOfEvent; i++)
+		{
+			CHECK(sEvent[i].value < 6);
+			coin[sEvent[i].value]++;
+		}
+	}
+	while(numOfEvent == TEST_EVENT);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t numOfCoin = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : TEST_COIN;
+	uint32_t numOfBenchmarkEdge = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : TEST_BENCHMARK_EDGE;
+	sCOIN_CAPTURE_STATISTIC sStatistic;
+	sCOIN_CAPTURE_EVENT sEvent[COIN_CAPTURE_BUFFER / 2];
+	sTEST_TRACE sTrace;
+	uint32_t coin[6] = {0};
+	uint32_t numOfEdge = 0;
+	uint32_t edge = 0;
+	uint32_t batch = 0;
+	uint64_t startTime = 0;
+	uint64_t elapsed = 0;
+	uint8_t i = 0;
+
+	sCoinCapture.Initialize();
+	Generate(&sTrace, numOfCoin);
+
+	// Trace in random batches as the 20 ms timer finds them
+	for(edge = 0; edge < sTrace.numOfEdge; edge += batch)
+	{
+		batch = Random(1, COIN_CAPTURE_BUFFER - 1);
+		batch = batch < sTrace.numOfEdge - edge ? batch : sTrace.numOfEdge - edge;
+		Feed(&sTrace.stamp[edge], batch);
+		Drain(coin);
+	}
+	sCoinCapture.GetStatistic(&sStatistic);
+	for(i = 0; i < 6; i++)
+	{
+		CHECK(coin[i] == sTrace.coin[i]);
+	}
+	CHECK(sStatistic.edgeCount == sTrace.numOfEdge);
+	CHECK(sStatistic.coinCount == numOfCoin - sTrace.lostEdge);
+	CHECK(sStatistic.rejectCount == sTrace.glitch && sStatistic.resyncCount == sTrace.lostEdge);
+	printf("%lu coins, %lu glitches, %lu lost edges in %lu edges classified\n", (unsigned long)numOfCoin,
+			(unsigned long)sTrace.glitch, (unsigned long)sTrace.lostEdge, (unsigned long)sTrace.numOfEdge);
+
+	// Throughput on full buffers, trace replays from its start until enough
+	// edges, DMA model is not timed
+	batch = COIN_CAPTURE_BUFFER - 1;
+	for(edge = 0; numOfEdge < numOfBenchmarkEdge; numOfEdge += batch)
+	{
+		if(edge + batch > sTrace.numOfEdge)
+		{
+			edge = 0;
+		}
+		Feed(&sTrace.stamp[edge], batch);
+		startTime = HostNanosecond();
+		CoinCaptureClassify(sEvent, COIN_CAPTURE_BUFFER / 2);
+		elapsed += HostNanosecond() - startTime;
+		edge += batch;
+	}
+	printf("Classifier %.1f ns per edge, %.1f M edges/s (host)\n", (double)elapsed / numOfEdge,
+			numOfEdge * 1000.0 / elapsed);
+
+	free(sTrace.stamp);
+	printf("Coin capture passed\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * Filename:			test_console.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Console over a pseudo-terminal as a terminal program
+ *						sees it: commands, split and overlong lines, then
+ *						round trip rate through the terminal and parse rate
+ *						of lines in the RX ring
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "console.h"
+#include "main_loop.h"
+#include "event_flag.h"
+#include "scheduler.h"
+#include "state_machine.h"
+#include "host_hal.h"
+#include "check.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_ROUND_TRIP			20000
+#define TEST_PARSE				2000000
+#define TEST_REPLY_SIZE			2048
+// Reply of status after coin 3
+#define TEST_STATUS_REPLY		"Status accept coin, total coin 3\n"
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+// Terminal program side of the pseudo-terminal
+static int terminal = -1;
+static uint64_t parseByte;
+
+/*******************************************************************************
+ * @fn      Execute
+ * @brief   Main loop passes as MainLoop until no task is ready
+ ******************************************************************************/
+static void Execute(void)
+{
+	uint64_t pendingFlags = 0;
+	uint8_t taskId = 0;
+
+	pendingFlags = sEventFlag.FetchAndClearAll();
+	sScheduler.Release(0, (uint32_t)pendingFlags);
+	sScheduler.Release(1, (uint32_t)(pendingFlags >> 32));
+	while((taskId = sScheduler.Next()) != SCHEDULER_NO_TASK)
+	{
+		sScheduler.Run(taskId);
+	}
+}
+
+/*******************************************************************************
+ * @fn      Run
+ * @brief   Take terminal input until there is none, then send TX in flight
+ ******************************************************************************/
+static void Run(void)
+{
+	do
+	{
+		Execute();
+	}
+	while(HostPtyPoll(0) > 0);
+	HostPtyPoll(0);
+}
+
+/*******************************************************************************
+ * @fn      Reply
+ * @brief   Read terminal until number of lines arrived
+ ******************************************************************************/
+static const char *Reply(uint32_t numOfLine)
+{
+	static char reply[TEST_REPLY_SIZE];
+	struct pollfd sPoll = {terminal, POLLIN, 0};
+	uint32_t length = 0;
+	uint32_t lineCount = 0;
+	ssize_t received = 0;
+	uint32_t i = 0;
+
+	while(lineCount < numOfLine)
+	{
+		CHECK(poll(&sPoll, 1, 1000) == 1);
+		received = read(terminal, &reply[length], sizeof(reply) - 1 - length);
+		CHECK(received > 0);
+		for(i = length; i < length + received; i++)
+		{
+			lineCount += reply[i] == '\n' ? 1 : 0;
+		}
+		length += received;
+	}
+	CHECK(lineCount == numOfLine);
+	reply[length] = '\0';
+	return reply;
+}
+
+/*******************************************************************************
+ * @fn      Command
+ * @brief   Type line at terminal and take reply of its lines
+ ******************************************************************************/
+static const char *Command(const char *line, uint32_t numOfLine)
+{
+	CHECK(write(terminal, line, strlen(line)) == (ssize_t)strlen(line));
+	Run();
+	return Reply(numOfLine);
+}
+
+/*******************************************************************************
+ * @fn      CountTransmit
+ * @brief   TX sink of parse benchmark
+ ******************************************************************************/
+static void CountTransmit(const uint8_t *data, uint32_t length)
+{
+	parseByte += length;
+}
+
+int main(void)
+{
+	// Tail after half RX ring would be a valid command
+	static const char overlong[] = "statusstatusstatusstatusstatusstatusstatusstatusstatusstatusstatus\n";
+	// Eight lines fit in half RX ring, reply of eight fits in TX ring
+	static const char batch[] = "status\nstatus\nstatus\nstatus\nstatus\nstatus\nstatus\nstatus\n";
+	sCONSOLE_STATISTIC sStatistic;
+	sSTATE_MACHINE_COUNTER sCounter;
+	void (*transmitHook)(const uint8_t *data, uint32_t length) = NULL;
+	const char *path = NULL;
+	const char *reply = NULL;
+	uint64_t startTime = 0;
+	double second = 0;
+	uint32_t i = 0;
+
+	path = HostPtyOpen();
+	CHECK(path != NULL);
+	terminal = open(path, O_RDWR | O_NOCTTY);
+	CHECK(terminal >= 0);
+	sScheduler.Initialize();
+	sStateMachine.Initialize();
+	sConsole.Initialize();
+	Run();
+	// State machine log written before the console was up is sent first
+	reply = Reply(4);
+	CHECK(strstr(reply, "Please insert coin\n") < strstr(reply, "Console ready, type help\n"));
+	CHECK(strstr(reply, "Please insert coin\n") != NULL);
+
+	CHECK(strcmp(Command("status\r\n", 1), "Status accept coin, total coin 0\n") == 0);
+	// Tokens in place between any run of spaces
+	CHECK(strcmp(Command("  coin   3  \n", 2), "Insert coin at accept coin state\nTotal coin = 3\n") == 0);
+	CHECK(strcmp(Command("status\n", 1), TEST_STATUS_REPLY) == 0);
+	CHECK(strcmp(Command("coin 0\n", 1), "coin [1-255]\n") == 0);
+	CHECK(strcmp(Command("reboot\n", 1), "Unknown command, type help\n") == 0);
+	// Idle line in the middle of a line, line runs at its end
+	CHECK(strcmp(Command("sta", 0), "") == 0);
+	CHECK(strcmp(Command("tus\n", 1), TEST_STATUS_REPLY) == 0);
+	// Line longer than half RX ring is dropped to its end, next line runs
+	CHECK(strcmp(Command(overlong, 0), "") == 0);
+	CHECK(strcmp(Command("status\n", 1), TEST_STATUS_REPLY) == 0);
+	sConsole.GetStatistic(&sStatistic);
+	CHECK(sStatistic.unknownCommand == 1 && sStatistic.lineOverflow == 1 && sStatistic.txDrop == 0);
+
+	// Round trip of command and reply as a terminal program sees it
+	startTime = HostNanosecond();
+	for(i = 0; i < TEST_ROUND_TRIP; i++)
+	{
+		Command("status\n", 1);
+	}
+	second = (HostNanosecond() - startTime) / 1e9;
+	printf("Pseudo-terminal round trip %.1f us, %.0f commands/s (host)\n", second * 1e6 / TEST_ROUND_TRIP,
+			TEST_ROUND_TRIP / second);
+
+	// Lines parsed in place from RX ring, replies to a sink
+	transmitHook = hostDmaTransmitHook;
+	hostDmaTransmitHook = CountTransmit;
+	startTime = HostNanosecond();
+	for(i = 0; i < TEST_PARSE / 8; i++)
+	{
+		HostDmaReceive(DMA1_Channel6, (const uint8_t *)batch, sizeof(batch) - 1);
+		USART2->ISR |= USART_ISR_IDLE;
+		ConsoleInterruptCallback();
+		Execute();
+		while(HostDmaComplete())
+		{
+		}
+	}
+	second = (HostNanosecond() - startTime) / 1e9;
+	hostDmaTransmitHook = transmitHook;
+	sConsole.GetStatistic(&sStatistic);
+	CHECK(sStatistic.txDrop == 0 && parseByte == (uint64_t)TEST_PARSE * strlen(TEST_STATUS_REPLY));
+	printf("Parse and execute %.0f ns per command, %.1f MB/s of RX (host)\n", second * 1e9 / TEST_PARSE,
+			TEST_PARSE * 7 / second / 1e6);
+
+	// Counted pulse train beyond the uint8_t credit is held, none dropped
+	sStateMachine.InsertCoins(300);
+	sStateMachine.GetCounter(&sCounter);
+	CHECK(sStateMachine.GetTotalCoin() == UINT8_MAX && sCounter.heldCoin == 3 + 300 - UINT8_MAX);
+
+	HostPtyClose();
+	close(terminal);
+	printf("Console passed\n");
+	return EXIT_SUCCESS;
+}
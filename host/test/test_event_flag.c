@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * Filename:			test_event_flag.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Producer threads Set flags of both words while main
+ *						thread takes them with WaitAny and FetchAndClearAll.
+ *						Every Set is taken exactly once
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "event_flag.h"
+#include "host_hal.h"
+#include "check.h"
+#include <pthread.h>
+#include <sched.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_PRODUCER			7
+// Flag of noise thread, Set and Clear on word 1 next to producer flags
+#define TEST_NOISE_FLAG			(EVENT_FLAG_MAXIMUM - 1)
+#define TEST_ROUND				300
+// A flag not taken by then is lost
+#define TEST_TIMEOUT			5000000000ULL
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+// A producer has one flag raised at a time, the next once consumer took it
+static uint32_t produced[EVENT_FLAG_MAXIMUM];
+static uint32_t consumed[EVENT_FLAG_MAXIMUM];
+static volatile bool stop;
+
+/*******************************************************************************
+ * @fn      Yield
+ * @brief   Idle hook of WaitAny
+ ******************************************************************************/
+static void Yield(void)
+{
+	sched_yield();
+}
+
+/*******************************************************************************
+ * @fn      Producer
+ * @brief   Flags id, id + TEST_PRODUCER, ... in turn, all below noise flag
+ ******************************************************************************/
+static void *Producer(void *arg)
+{
+	uint8_t id = (uint8_t)(uintptr_t)arg;
+	uint64_t startTime = 0;
+	uint32_t round = 0;
+	uint8_t flag = 0;
+
+	for(round = 0; round < TEST_ROUND; round++)
+	{
+		for(flag = id; flag < TEST_NOISE_FLAG; flag += TEST_PRODUCER)
+		{
+			__atomic_store_n(&produced[flag], produced[flag] + 1, __ATOMIC_RELEASE);
+			sEventFlag.Set(flag);
+			// Next Set goes to a flag the consumer may be swapping right now
+			startTime = HostNanosecond();
+			while(__atomic_load_n(&consumed[flag], __ATOMIC_ACQUIRE) != produced[flag])
+			{
+				CHECK(HostNanosecond() - startTime < TEST_TIMEOUT);
+				sched_yield();
+			}
+		}
+	}
+	return NULL;
+}
+
+/*******************************************************************************
+ * @fn      Noise
+ * @brief   Set and Clear of a flag sharing word 1 with producer flags
+ ******************************************************************************/
+static void *Noise(void *arg)
+{
+	while(!stop)
+	{
+		sEventFlag.Set(TEST_NOISE_FLAG);
+		sEventFlag.Clear(TEST_NOISE_FLAG);
+	}
+	return NULL;
+}
+
+int main(void)
+{
+	pthread_t producer[TEST_PRODUCER];
+	pthread_t noise;
+	uint64_t mask = ((uint64_t)0x01 << TEST_NOISE_FLAG) - 1;
+	uint64_t flags = 0;
+	uint64_t taken = 0;
+	uint64_t startTime = 0;
+	uint8_t flag = 0;
+	uint8_t i = 0;
+
+	// Out of range flags are ignored
+	sEventFlag.Set(EVENT_FLAG_MAXIMUM);
+	sEventFlag.Set(UINT8_MAX);
+	CHECK(sEventFlag.FetchAndClearAll() == 0);
+	sEventFlag.Set(0);
+	sEventFlag.Set(32);
+	CHECK(sEventFlag.FetchAndClearAll() == ((uint64_t)0x01 << 32 | 0x01));
+
+	hostIdleHook = Yield;
+	startTime = HostNanosecond();
+	CHECK(pthread_create(&noise, NULL, Noise, NULL) == 0);
+	for(i = 0; i < TEST_PRODUCER; i++)
+	{
+		CHECK(pthread_create(&producer[i], NULL, Producer, (void *)(uintptr_t)i) == 0);
+	}
+	while(taken < (uint64_t)TEST_ROUND * TEST_NOISE_FLAG)
+	{
+		sEventFlag.WaitAny(mask);
+		flags = sEventFlag.FetchAndClearAll() & mask;
+		for(flag = 0; flags != 0; flag++, flags >>= 1)
+		{
+			if(flags & 0x01)
+			{
+				// Taken twice for one Set otherwise
+				CHECK(__atomic_load_n(&produced[flag], __ATOMIC_ACQUIRE) == consumed[flag] + 1);
+				__atomic_store_n(&consumed[flag], consumed[flag] + 1, __ATOMIC_RELEASE);
+				taken++;
+			}
+		}
+	}
+	for(i = 0; i < TEST_PRODUCER; i++)
+	{
+		pthread_join(producer[i], NULL);
+	}
+	stop = true;
+	pthread_join(noise, NULL);
+	for(flag = 0; flag < TEST_NOISE_FLAG; flag++)
+	{
+		CHECK(produced[flag] == TEST_ROUND && consumed[flag] == TEST_ROUND);
+	}
+	CHECK((sEventFlag.FetchAndClearAll() & mask) == 0);
+	printf("%llu flags from %d threads taken once each in %llu ms\n", (unsigned long long)taken, TEST_PRODUCER,
+			(unsigned long long)((HostNanosecond() - startTime) / 1000000));
+	printf("Event flag passed\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,193 @@
+/*******************************************************************************
+ * Filename:			test_exti_guard.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    EXTI guard under a 100 kHz bounce burst on the coin
+ *						line. Edges reach the guard while the line is unmasked,
+ *						1 ms timer ticks run the guard tick. Threshold, polled
+ *						event, unmask after quiet line and counters are checked.
+ *						Contact falls at a random point of each 10 us and stays
+ *						low 1 to 3 us, guard samples of a burst are mostly high
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "exti_guard.h"
+#include "event_flag.h"
+#include "software_timer.h"
+#include "host_hal.h"
+#include "check.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_BURST_PERIOD		10				// us, 100 kHz edges
+#define TEST_BURST_LOW			3				// us, longest low of a bounce
+#define TEST_BURST				20000			// us of burst
+// Guard period in us
+#define TEST_GUARD_PERIOD		(EXTI_GUARD_PERIOD * 1000)
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static const sDEBOUNCE_INPUT *psCoin = &sDebounceInput[coinDebounceInput];
+static uint64_t randomState = 0x2545F4914F6CDD1D;
+// Simulated time, us
+static uint64_t now;
+static uint32_t fallTime;
+static uint32_t riseTime;
+static uint32_t edgeCount;
+static uint32_t interruptCount;
+static uint32_t acceptCount;
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      Random
+ * @brief   xorshift64, uniform in [0, range)
+ ******************************************************************************/
+static uint32_t Random(uint32_t range)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 7;
+	randomState ^= randomState << 17;
+	return (uint32_t)((randomState >> 11) % range);
+}
+
+/*******************************************************************************
+ * @fn      SetLevel
+ * @brief   Coin pin level, a falling edge raises EXTI unless the line is
+ *          masked and goes to the guard as HAL_GPIO_EXTI_Callback does
+ ******************************************************************************/
+static void SetLevel(GPIO_PinState level)
+{
+	bool high = (psCoin->port->IDR & psCoin->gpioPin) != 0;
+
+	if(level == GPIO_PIN_SET)
+	{
+		psCoin->port->IDR |= psCoin->gpioPin;
+		return;
+	}
+	psCoin->port->IDR &= ~(uint32_t)psCoin->gpioPin;
+	if(!high)
+	{
+		return;
+	}
+	edgeCount++;
+	if((EXTI->IMR1 & psCoin->gpioPin) == 0)
+	{
+		return;
+	}
+	interruptCount++;
+	acceptCount += sExtiGuard.Edge(coinDebounceInput) ? 1 : 0;
+}
+
+/*******************************************************************************
+ * @fn      Run
+ * @brief   Advance time by us, burst falls once every 10 us and rises
+ *          after a short low, else the pin holds level. 1 ms timer
+ *          interrupt every ms
+ ******************************************************************************/
+static void Run(uint32_t duration, bool burst, GPIO_PinState level)
+{
+	uint64_t end = now + duration;
+
+	while(now < end)
+	{
+		now++;
+		if(burst)
+		{
+			if(now % TEST_BURST_PERIOD == 0)
+			{
+				fallTime = Random(TEST_BURST_PERIOD - TEST_BURST_LOW);
+				riseTime = fallTime + 1 + Random(TEST_BURST_LOW);
+			}
+			SetLevel(now % TEST_BURST_PERIOD >= fallTime && now % TEST_BURST_PERIOD < riseTime ? GPIO_PIN_RESET : GPIO_PIN_SET);
+		}
+		else
+		{
+			SetLevel(level);
+		}
+		if(now % 1000 == 0)
+		{
+			hostTick++;
+			SoftwareTimerInterruptCallback();
+		}
+	}
+}
+
+/*******************************************************************************
+ * @fn      Masked
+ * @brief   Coin line EXTI masked
+ ******************************************************************************/
+static bool Masked(void)
+{
+	return (EXTI->IMR1 & psCoin->gpioPin) == 0;
+}
+
+int main(void)
+{
+	const uint64_t coinFlag = (uint64_t)0x01 << psCoin->eEventFlag;
+	sEXTI_GUARD_COUNTER sCounter;
+	uint32_t i = 0;
+
+	psCoin->port->IDR |= psCoin->gpioPin;
+	EXTI->IMR1 |= psCoin->gpioPin;
+	sExtiGuard.Initialize();
+
+	// Bounce below threshold keeps the interrupt, every edge restarts debounce
+	Run(1000, false, GPIO_PIN_SET);
+	for(i = 0; i < EXTI_GUARD_THRESHOLD / 2; i++)
+	{
+		Run(50, false, GPIO_PIN_RESET);
+		Run(50, false, GPIO_PIN_SET);
+	}
+	Run(EXTI_GUARD_QUIET_TICK * TEST_GUARD_PERIOD, false, GPIO_PIN_SET);
+	sExtiGuard.GetCounter(coinDebounceInput, &sCounter);
+	CHECK(!Masked() && !sCounter.polling && sCounter.stormCount == 0);
+	CHECK(acceptCount == EXTI_GUARD_THRESHOLD / 2 && sCounter.maximumEdgeRate == EXTI_GUARD_THRESHOLD / 2);
+
+	// 100 kHz burst, then a coin holds the line low
+	edgeCount = interruptCount = acceptCount = 0;
+	sEventFlag.FetchAndClearAll();
+	Run(TEST_BURST, true, GPIO_PIN_RESET);
+	sExtiGuard.GetCounter(coinDebounceInput, &sCounter);
+	CHECK(Masked() && sCounter.polling && sCounter.stormCount == 1);
+	// Guard tick may split the first edges over two windows
+	CHECK(interruptCount >= EXTI_GUARD_THRESHOLD + 1 && interruptCount <= 2 * EXTI_GUARD_THRESHOLD + 1);
+	CHECK(acceptCount == interruptCount - 1 && sCounter.maximumEdgeRate <= EXTI_GUARD_THRESHOLD + 1);
+	printf("100 kHz burst of %lu ms: %lu edges, %lu interrupts taken\n",
+			(unsigned long)(TEST_BURST / 1000), (unsigned long)edgeCount, (unsigned long)interruptCount);
+
+	// Stable low makes one polled event after debounce ticks, not before. Last
+	// sample of the burst may already be low
+	Run((EXTI_GUARD_DEBOUNCE_TICK - 2) * TEST_GUARD_PERIOD, false, GPIO_PIN_RESET);
+	CHECK((sEventFlag.FetchAndClearAll() & coinFlag) == 0);
+	Run(3 * TEST_GUARD_PERIOD, false, GPIO_PIN_RESET);
+	CHECK((sEventFlag.FetchAndClearAll() & coinFlag) != 0);
+	Run(EXTI_GUARD_QUIET_TICK * TEST_GUARD_PERIOD, false, GPIO_PIN_RESET);
+	sExtiGuard.GetCounter(coinDebounceInput, &sCounter);
+	CHECK(sCounter.polledEventCount == 1 && (sEventFlag.FetchAndClearAll() & coinFlag) == 0);
+
+	// Line high but not yet quiet stays masked, quiet line unmasks
+	Run((EXTI_GUARD_QUIET_TICK - 1) * TEST_GUARD_PERIOD, false, GPIO_PIN_SET);
+	CHECK(Masked());
+	Run(2 * TEST_GUARD_PERIOD, false, GPIO_PIN_SET);
+	sExtiGuard.GetCounter(coinDebounceInput, &sCounter);
+	CHECK(!Masked() && !sCounter.polling && sCounter.recoverCount == 1);
+
+	// Noise longer than quiet time keeps the line masked, noise ending high
+	// makes no event
+	Run(2 * EXTI_GUARD_QUIET_TICK * TEST_GUARD_PERIOD, true, GPIO_PIN_RESET);
+	Run(TEST_GUARD_PERIOD, false, GPIO_PIN_SET);
+	CHECK(Masked());
+	Run(EXTI_GUARD_QUIET_TICK * TEST_GUARD_PERIOD, false, GPIO_PIN_SET);
+	sExtiGuard.GetCounter(coinDebounceInput, &sCounter);
+	CHECK(!Masked() && sCounter.stormCount == 2 && sCounter.recoverCount == 2 && sCounter.polledEventCount == 1);
+	CHECK((sEventFlag.FetchAndClearAll() & coinFlag) == 0);
+
+	printf("EXTI guard passed\n");
+	return EXIT_SUCCESS;
+}
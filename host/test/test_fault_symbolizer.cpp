@@ -0,0 +1,171 @@
+/*******************************************************************************
+ * Filename:			test_fault_symbolizer.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Fault symbolizer on an ARM ELF written by the test.
+ *						Thumb calls are told from other code addresses on
+ *						the stack, dump lines are taken from console text
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "fault_symbolizer.h"
+#include "check.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <elf.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_TEXT_ADDRESS		0x08000100
+#define TEST_FUNCTION_SIZE		0x20
+
+/*******************************************************************************
+ * @fn      Append
+ * @brief   Bytes of a value at end of file image
+ ******************************************************************************/
+template<typename T> static size_t Append(std::vector<uint8_t> &image, const T &value)
+{
+	size_t offset = image.size();
+
+	image.resize(offset + sizeof(T));
+	memcpy(image.data() + offset, &value, sizeof(T));
+	return offset;
+}
+
+/*******************************************************************************
+ * @fn      WriteElf
+ * @brief   ELF with Outer, Middle and Inner, 0x20 bytes each from
+ *          0x08000100. Outer calls with BL at +0x0C, Middle with BLX r3 at
+ *          +0x06
+ ******************************************************************************/
+static std::string WriteElf(void)
+{
+	static const char name[] = "\0Outer\0Middle\0Inner";
+	static const char sectionName[] = "\0.text\0.symtab\0.strtab\0.shstrtab";
+	std::vector<uint8_t> image(sizeof(Elf32_Ehdr));
+	std::vector<uint8_t> text(3 * TEST_FUNCTION_SIZE, 0);
+	const uint16_t bl[] = {0xF000, 0xF808};
+	const uint16_t blx = 0x4798;
+	Elf32_Ehdr header = {};
+	Elf32_Shdr section[5] = {};
+	Elf32_Sym symbol = {};
+	char path[] = "/tmp/test_fault_symbolizerXXXXXX";
+	int file = mkstemp(path);
+	size_t offset = 0;
+
+	CHECK(file >= 0);
+	memcpy(&text[0x0C], bl, sizeof(bl));
+	memcpy(&text[TEST_FUNCTION_SIZE + 0x06], &blx, sizeof(blx));
+
+	section[1] = {1, SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, TEST_TEXT_ADDRESS, (Elf32_Off)image.size(),
+				  (Elf32_Word)text.size(), 0, 0, 2, 0};
+	image.insert(image.end(), text.begin(), text.end());
+
+	offset = image.size();
+	Append(image, Elf32_Sym{});
+	for(uint32_t i = 0; i < 3; i++)
+	{
+		const uint32_t nameOffset[] = {1, 7, 14};
+
+		symbol.st_name = nameOffset[i];
+		symbol.st_value = (TEST_TEXT_ADDRESS + i * TEST_FUNCTION_SIZE) | 0x01;
+		symbol.st_size = TEST_FUNCTION_SIZE;
+		symbol.st_info = ELF32_ST_INFO(STB_GLOBAL, STT_FUNC);
+		symbol.st_shndx = 1;
+		Append(image, symbol);
+	}
+	// A data object over the code is no function
+	symbol.st_name = 1;
+	symbol.st_value = TEST_TEXT_ADDRESS;
+	symbol.st_size = 3 * TEST_FUNCTION_SIZE;
+	symbol.st_info = ELF32_ST_INFO(STB_GLOBAL, STT_OBJECT);
+	Append(image, symbol);
+	section[2] = {7, SHT_SYMTAB, 0, 0, (Elf32_Off)offset, (Elf32_Word)(image.size() - offset), 3, 1, 4,
+				  sizeof(Elf32_Sym)};
+
+	section[3] = {15, SHT_STRTAB, 0, 0, (Elf32_Off)image.size(), sizeof(name), 0, 0, 1, 0};
+	image.insert(image.end(), name, name + sizeof(name));
+	section[4] = {23, SHT_STRTAB, 0, 0, (Elf32_Off)image.size(), sizeof(sectionName), 0, 0, 1, 0};
+	image.insert(image.end(), sectionName, sectionName + sizeof(sectionName));
+
+	image.resize((image.size() + 3) & ~(size_t)3);
+	memcpy(header.e_ident, ELFMAG, SELFMAG);
+	header.e_ident[EI_CLASS] = ELFCLASS32;
+	header.e_ident[EI_DATA] = ELFDATA2LSB;
+	header.e_ident[EI_VERSION] = EV_CURRENT;
+	header.e_type = ET_EXEC;
+	header.e_machine = EM_ARM;
+	header.e_version = EV_CURRENT;
+	header.e_ehsize = sizeof(Elf32_Ehdr);
+	header.e_shentsize = sizeof(Elf32_Shdr);
+	header.e_shnum = 5;
+	header.e_shstrndx = 4;
+	header.e_shoff = image.size();
+	for(const auto &entry : section)
+	{
+		Append(image, entry);
+	}
+	memcpy(image.data(), &header, sizeof(header));
+
+	CHECK(write(file, image.data(), image.size()) == (ssize_t)image.size());
+	close(file);
+	return path;
+}
+
+int main(void)
+{
+	const std::string path = WriteElf();
+	fault::Elf elf;
+	fault::Elf wrong;
+	uint32_t offset = 0;
+
+	CHECK(elf.Load(path));
+	CHECK(*elf.Function(0x0800014A, &offset) == "Inner" && offset == 0x0A);
+	CHECK(elf.Function(0x08000160, &offset) == nullptr && elf.Function(0x080000FE, &offset) == nullptr);
+	// Behind BL, behind BLX r3, same address in ARM state, no call before
+	CHECK(elf.ReturnAddress(0x08000111) && elf.ReturnAddress(0x08000129));
+	CHECK(!elf.ReturnAddress(0x08000110) && !elf.ReturnAddress(0x08000105));
+	CHECK(!elf.ReturnAddress(0xFFFFFFF9) && !elf.ReturnAddress(0x20017F00));
+	CHECK(!wrong.Load("/proc/self/exe") && !wrong.Load("/nonexistent"));
+
+	// Console text as printed by FaultCapturePrint, an older record first
+	const fault::Dump dump = fault::ParseDump(
+		"pc 0x08000101 lr 0x00000000 xpsr 0x01000000 sp 0x20017000\n"
+		"stack 0x20017000: 0x08000111\n"
+		"Reset by fault, 1 in a row\n"
+		"Fault exception 6, exc_return 0xFFFFFFF9, 1 of 3 resets in a row\n"
+		"pc 0x0800014A lr 0x08000129 xpsr 0x21000000 sp 0x20017F80\n"
+		"r0 0x00000000 r1 0x00000001 r2 0x00000002 r3 0x08000141 r12 0x00000000\n"
+		"cfsr 0x00010000 hfsr 0x00000000 mmfar 0xE000ED34 bfar 0xE000ED38\n"
+		"UNDEFINSTR \n"
+		"stack 0x20017F80: 0x20017F00 0x08000129 0x08000105 0x08000110 0x08000111 0xFFFFFFF9 0x00000000 0x00000000\n"
+		"stack 0x20017FA0: 0x08000111\n"
+		"stack 0x20017FC0: 0x08000129\n"
+		"Log tail:\n"
+		"pc values in the log tail are not a record\n");
+	CHECK(dump.valid && dump.pc == 0x0800014A && dump.lr == 0x08000129 && dump.sp == 0x20017F80);
+	// Line after a gap is not stack
+	CHECK(dump.stackAddress == 0x20017F80 && dump.stack.size() == 9);
+
+	const auto frame = fault::Backtrace(elf, dump);
+	for(const auto &entry : frame)
+	{
+		printf("0x%08lX %-8s %s+0x%lX\n", (unsigned long)entry.address, entry.source.c_str(), entry.function.c_str(),
+				(unsigned long)entry.offset);
+	}
+	// Repeats of the frame before are dropped, Middle stacked its lr and a
+	// stale copy of Outer's return address is further up
+	CHECK(frame.size() == 3);
+	CHECK(frame[0].source == "pc" && frame[0].function == "Inner" && frame[0].offset == 0x0A);
+	CHECK(frame[1].source == "lr" && frame[1].function == "Middle" && frame[1].offset == 0x08);
+	CHECK(frame[2].source == "sp+0x10" && frame[2].function == "Outer" && frame[2].offset == 0x10);
+
+	unlink(path.c_str());
+	printf("Fault symbolizer passed\n");
+	return EXIT_SUCCESS;
+}
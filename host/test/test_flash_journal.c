@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * Filename:			test_flash_journal.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Flash journal on simulated flash. Refused and failed
+ *						operations, reset with a program in flight, write after
+ *						a warm restart that did not mount. Source is included
+ *						for its RAM state, cleared as at reset. Then write
+ *						amplification, wear and mount time over 1M records.
+ *						Lifetime vend passes 65535 several times on the way
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "../../Core/Src/flash_journal.c"
+#include "host_hal.h"
+#include "check.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_RECORD				1000000
+#define TEST_MOUNT_PERIOD		100000
+#define TEST_MOUNT_RUN			1000
+#define TEST_JOURNAL_START		0x080F8000
+#define TEST_JOURNAL_SIZE		0x8000
+
+/*******************************************************************************
+ * @fn      Record
+ * @brief   Record number n
+ ******************************************************************************/
+static sFLASH_JOURNAL_RECORD Record(uint32_t n)
+{
+	sFLASH_JOURNAL_RECORD sRecord = {0};
+
+	sRecord.lifetimeCoin = n;
+	sRecord.lifetimeVend = n / 3;
+	sRecord.totalCoin = (uint8_t)n;
+	return sRecord;
+}
+
+/*******************************************************************************
+ * @fn      Run
+ * @brief   Main loop work and flash interrupts until journal is idle
+ ******************************************************************************/
+static void Run(void)
+{
+	do
+	{
+		sFlashJournal.Process();
+	}
+	while(HostFlashComplete());
+}
+
+/*******************************************************************************
+ * @fn      CheckMount
+ * @brief   Reset and mount, newest record must be n
+ ******************************************************************************/
+static void CheckMount(uint32_t n)
+{
+	sFLASH_JOURNAL_RECORD sRecord;
+
+	CHECK(sFlashJournal.Mount(&sRecord));
+	CHECK(sRecord.lifetimeCoin == n && sRecord.lifetimeVend == n / 3 && sRecord.totalCoin == (uint8_t)n);
+}
+
+int main(void)
+{
+	sFLASH_JOURNAL_RECORD sRecord;
+	sFLASH_JOURNAL_STATISTIC sStatistic;
+	uint64_t startTime = 0;
+	uint64_t mountTime = 0;
+	uint64_t maximumMount = 0;
+	uint32_t recordWrite = 0;
+	uint32_t headerWrite = 0;
+	uint32_t errorCount = 0;
+	uint32_t minimumErase = UINT32_MAX;
+	uint32_t maximumErase = 0;
+	uint32_t slot = 0;
+	uint32_t n = 0;
+	uint32_t i = 0;
+
+	CHECK(!sFlashJournal.Mount(&sRecord));
+
+	// Refused start changes nothing, record goes out on the next pass
+	sRecord = Record(1);
+	sFlashJournal.Write(&sRecord);
+	hostFlashRefuse = 1;
+	sFlashJournal.Process();
+	sFlashJournal.GetStatistic(&sStatistic);
+	CHECK(sStatistic.errorCount == 1 && sHostFlashStatistic.refuseCount == 1);
+	Run();
+	CHECK(sHostFlashStatistic.pageErase[(TEST_JOURNAL_START - HOST_FLASH_START) / FLASH_PAGE_SIZE] == 1);
+	CheckMount(1);
+
+	// Program onto a dirty slot fails, record moves to the next slot
+	sRecord = Record(2);
+	memset((void *)(uintptr_t)(TEST_JOURNAL_START + 3 * sizeof(uint64_t)), 0, sizeof(uint64_t));
+	sFlashJournal.Write(&sRecord);
+	Run();
+	CHECK(sHostFlashStatistic.errorCount == 1);
+	CheckMount(2);
+
+	// Reset with program in flight, journal keeps the previous record
+	sRecord = Record(3);
+	sFlashJournal.Write(&sRecord);
+	sFlashJournal.Process();
+	CheckMount(2);
+	HostFlashComplete();
+	CheckMount(3);
+
+	// Warm restart skips Mount, first write finds the page and appends
+	memset(&sFlashJournalPro, 0, sizeof(sFlashJournalPro));
+	sRecord = Record(4);
+	sFlashJournal.Write(&sRecord);
+	Run();
+	CHECK(sHostFlashStatistic.pageErase[(TEST_JOURNAL_START - HOST_FLASH_START) / FLASH_PAGE_SIZE] == 1);
+	CHECK(sHostFlashStatistic.pageErase[(TEST_JOURNAL_START - HOST_FLASH_START) / FLASH_PAGE_SIZE + 1] == 0);
+	CheckMount(4);
+
+	HostFlashErase();
+	CHECK(!sFlashJournal.Mount(&sRecord));
+	for(n = 1; n <= TEST_RECORD; n++)
+	{
+		sRecord = Record(n);
+		sFlashJournal.Write(&sRecord);
+		Run();
+		if(n % TEST_MOUNT_PERIOD == 0 || n == TEST_RECORD)
+		{
+			// Mount clears the journal statistic, sum it up before
+			sFlashJournal.GetStatistic(&sStatistic);
+			recordWrite += sStatistic.recordWrite;
+			headerWrite += sStatistic.headerWrite;
+			errorCount += sStatistic.errorCount;
+			// Mount at every fill level of the newest page
+			for(i = 0; i < TEST_MOUNT_RUN; i++)
+			{
+				startTime = HostNanosecond();
+				sFlashJournal.Mount(&sRecord);
+				mountTime = HostNanosecond() - startTime;
+				maximumMount = mountTime > maximumMount ? mountTime : maximumMount;
+			}
+			CheckMount(n);
+		}
+	}
+
+	CHECK(recordWrite == TEST_RECORD && errorCount == 0);
+	CHECK(sHostFlashStatistic.programCount == recordWrite + headerWrite);
+	for(i = 0; i < TEST_JOURNAL_SIZE / FLASH_PAGE_SIZE; i++)
+	{
+		slot = sHostFlashStatistic.pageErase[(TEST_JOURNAL_START - HOST_FLASH_START) / FLASH_PAGE_SIZE + i];
+		minimumErase = slot < minimumErase ? slot : minimumErase;
+		maximumErase = slot > maximumErase ? slot : maximumErase;
+	}
+	// Wear leveled, pages are erased in turn
+	CHECK(maximumErase - minimumErase <= 1);
+
+	printf("%d records of %d bytes: %lu programs, %lu headers, %lu page erases\n", TEST_RECORD,
+			(int)FLASH_JOURNAL_RECORD_SIZE, (unsigned long)sHostFlashStatistic.programCount,
+			(unsigned long)headerWrite, (unsigned long)sHostFlashStatistic.eraseCount);
+	printf("Write amplification %.4f programmed, %.4f erased bytes per record byte\n",
+			(double)sHostFlashStatistic.programCount / TEST_RECORD,
+			(double)sHostFlashStatistic.eraseCount * FLASH_PAGE_SIZE / ((double)TEST_RECORD * FLASH_JOURNAL_RECORD_SIZE));
+	printf("Page erases %lu to %lu, 10k cycle endurance reached after %.0fM records\n", (unsigned long)minimumErase,
+			(unsigned long)maximumErase, 10000.0 * TEST_RECORD / maximumErase / 1e6);
+	printf("Mount worst %llu ns on host\n", (unsigned long long)maximumMount);
+	printf("Flash journal passed\n");
+	return EXIT_SUCCESS;
+}
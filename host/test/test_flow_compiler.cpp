@@ -0,0 +1,220 @@
+/*******************************************************************************
+ * Filename:			test_flow_compiler.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Flow compiler errors, then the example flow with a
+ *						changed setting goes through Intel HEX into simulated
+ *						flash and the flow VM runs it instead of the built-in
+ *						flow. A damaged page falls back to the built-in flow
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "flow_compiler.h"
+#include "host_hal.h"
+#include "software_timer.h"
+#include "check.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// make runs tests in host/
+#define TEST_SOURCE				"flow/vending.flow"
+// Code bytes of the built-in program of flow_vm.c
+#define TEST_BUILT_IN_CODE		57
+#define TEST_COMPILE_RUN		1000
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static uint8_t status;
+static uint8_t totalCoin;
+static uint32_t lifetimeCoin;
+static uint32_t lifetimeVend;
+static uint32_t heldCoin;
+static uint32_t saveCount;
+
+/*******************************************************************************
+ * @fn      Save
+ * @brief   Journal stand-in of the flow context
+ ******************************************************************************/
+static void Save(void)
+{
+	saveCount++;
+}
+
+static void TimerCallback(uint8_t softwareTimerId, void *arg)
+{
+}
+
+/*******************************************************************************
+ * @fn      CompileError
+ * @brief   Source must fail with error starting with expected
+ ******************************************************************************/
+static void CompileError(const char *source, const char *expected)
+{
+	flow::Program program;
+	std::string error;
+
+	CHECK(!flow::Compile(source, &program, &error));
+	if(error.compare(0, strlen(expected), expected) != 0)
+	{
+		fprintf(stderr, "\"%s\" instead of \"%s\"\n", error.c_str(), expected);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/*******************************************************************************
+ * @fn      ProgramHex
+ * @brief   Write Intel HEX records to simulated flash like a programmer,
+ *          every record checksum must hold
+ * @return  Data bytes written
+ ******************************************************************************/
+static size_t ProgramHex(const std::string &text)
+{
+	std::istringstream input(text);
+	std::string line;
+	uint32_t upper = 0;
+	size_t count = 0;
+	bool end = false;
+
+	HostFlashErase();
+	while(std::getline(input, line))
+	{
+		uint8_t byte[5 + 255] = {0};
+		uint8_t sum = 0;
+		unsigned value = 0;
+		size_t length = (line.size() - 1) / 2;
+
+		CHECK(!end && line[0] == ':' && line.size() % 2 == 1 && length >= 5);
+		for(size_t i = 0; i < length; i++)
+		{
+			CHECK(sscanf(line.c_str() + 1 + 2 * i, "%2X", &value) == 1);
+			byte[i] = value;
+			sum += value;
+		}
+		CHECK(sum == 0 && byte[0] == length - 5);
+		if(byte[3] == 0x04)
+		{
+			upper = ((uint32_t)byte[4] << 24) | ((uint32_t)byte[5] << 16);
+		}
+		else if(byte[3] == 0x00)
+		{
+			const uint32_t address = upper | ((uint32_t)byte[1] << 8) | byte[2];
+
+			CHECK(address >= HOST_FLASH_START && address + byte[0] <= HOST_FLASH_START + HOST_FLASH_SIZE);
+			memcpy((void *)(uintptr_t)address, &byte[4], byte[0]);
+			count += byte[0];
+		}
+		else
+		{
+			CHECK(byte[3] == 0x01);
+			end = true;
+		}
+	}
+	CHECK(end);
+	return count;
+}
+
+/*******************************************************************************
+ * @fn      Vend
+ * @brief   Coins, button and dispensing periods until credit is used up.
+ *          Machine must reach enough coin after minimum coins
+ ******************************************************************************/
+static void Vend(uint8_t timerId, uint8_t minimum)
+{
+	status = acceptCoinMachineStatus;
+	totalCoin = 0;
+	lifetimeVend = 0;
+
+	sFlowVm.Run(startMachineEvent, 0);
+	sFlowVm.Run(insertCoinMachineEvent, minimum - 1);
+	CHECK(status == acceptCoinMachineStatus && totalCoin == minimum - 1);
+	sFlowVm.Run(dispenseButtonMachineEvent, 0);
+	CHECK(status == acceptCoinMachineStatus);
+	sFlowVm.Run(insertCoinMachineEvent, 1);
+	CHECK(status == enoughCoinMachineStatus && totalCoin == minimum);
+
+	sFlowVm.Run(dispenseButtonMachineEvent, 0);
+	CHECK(status == dispensingMachineStatus && sSoftwareTimer.GetCountdown(timerId) > 0);
+	sFlowVm.Run(dispenseButtonMachineEvent, 0);
+	CHECK(status == pauseDispenseMachineStatus && sSoftwareTimer.GetCountdown(timerId) == 0);
+	sFlowVm.Run(dispenseButtonMachineEvent, 0);
+	for(uint8_t i = 0; i < minimum; i++)
+	{
+		CHECK(status == dispensingMachineStatus);
+		sFlowVm.Run(dispensingTimerMachineEvent, 0);
+	}
+	CHECK(status == acceptCoinMachineStatus && totalCoin == 0 && lifetimeVend == 1);
+}
+
+int main(void)
+{
+	std::ifstream input(TEST_SOURCE);
+	std::string source((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	sFLOW_VM_CONTEXT sContext = {&status, &totalCoin, &lifetimeCoin, &lifetimeVend, &heldCoin, 0, Save};
+	flow::Program program;
+	std::string error;
+	std::string hex;
+	uint64_t startTime = 0;
+	uint64_t compileTime = 0;
+	size_t at = 0;
+
+	CHECK(!source.empty());
+	CompileError("load credit\n", "line 1: last instruction must be end");
+	CompileError("\n  fetch credit\nend\n", "line 2: unknown instruction");
+	CompileError("jump nowhere\nend\n", "line 1: label \"nowhere\" not defined");
+	CompileError("back:\n\tsave\n\tjump back\n\tend\n", "line 3: jump to \"back\"");
+	CompileError("load 65536\nend\n", "line 1: \"65536\" is no constant");
+	CompileError("goto vending\nend\n", "line 1: unknown status");
+	CompileError("print hello\nend\n", "line 1: unknown message");
+	CompileError("on accept coin a\non accept coin a\na:\nend\n", "line 2: handler of accept coin defined twice");
+	CompileError("on accept refund a\na:\nend\n", "line 1: unknown status \"accept\" or event \"refund\"");
+
+	// Example flow is the built-in flow
+	CHECK(flow::Compile(source, &program, &error));
+	CHECK(program.codeLength == TEST_BUILT_IN_CODE);
+	CHECK(program.image.size() % 8 == 0 && program.image.size() <= flow::pageSize);
+
+	// Field update: three coins are enough
+	at = source.find("MINIMUM_COINS\t\t5");
+	CHECK(at != std::string::npos);
+	source[at + strlen("MINIMUM_COINS\t\t")] = '3';
+	startTime = HostNanosecond();
+	for(uint32_t i = 0; i < TEST_COMPILE_RUN; i++)
+	{
+		CHECK(flow::Compile(source, &program, &error));
+		hex = flow::IntelHex(program.image, flow::programAddress);
+	}
+	compileTime = HostNanosecond() - startTime;
+	CHECK(ProgramHex(hex) == program.image.size());
+	CHECK(memcmp((const void *)(uintptr_t)flow::programAddress, program.image.data(), program.image.size()) == 0);
+
+	sContext.timerId = sSoftwareTimer.Initialize(NULL, TimerCallback, NULL, TIMER_ONCE_TYPE, NULL);
+	sFlowVm.Initialize(&sContext);
+	Vend(sContext.timerId, 3);
+	CHECK(saveCount > 0 && lifetimeCoin == 3);
+
+	// One flipped code bit fails the CRC, built-in flow needs five coins
+	((uint8_t *)(uintptr_t)flow::programAddress)[sizeof(sFLOW_VM_HEADER) + 1] ^= 0x01;
+	sFlowVm.Initialize(&sContext);
+	Vend(sContext.timerId, 5);
+
+	// Erased page, built-in flow
+	HostFlashErase();
+	sFlowVm.Initialize(&sContext);
+	Vend(sContext.timerId, 5);
+
+	printf("Flow compiler: %zu code bytes, %zu image bytes, %zu hex bytes, crc 0x%08lX, %.1f us per compile (host)\n",
+			program.codeLength, program.image.size(), hex.size(), (unsigned long)program.crc,
+			compileTime / 1000.0 / TEST_COMPILE_RUN);
+	printf("Flow compiler passed\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * Filename:			test_itm_demux.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    SWO demultiplexer on a stream of every ITM packet
+ *						kind, written the way itm_trace.c writes its ports.
+ *						Every split of the stream gives the same writes, then
+ *						demultiplexer throughput
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "itm_demux.h"
+#include "host_hal.h"
+#include "check.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_BENCHMARK_SIZE		(64 * 1024 * 1024)
+
+/*******************************************************************************
+ * @fn      Write
+ * @brief   Source packet of a stimulus port write
+ ******************************************************************************/
+static void Write(std::vector<uint8_t> &stream, uint8_t port, uint8_t size, uint32_t value, bool hardware = false)
+{
+	stream.push_back((port << 3) | (hardware ? 0x04 : 0x00) | (size == 4 ? 0x03 : size));
+	for(uint8_t i = 0; i < size; i++)
+	{
+		stream.push_back(value >> (8 * i));
+	}
+}
+
+/*******************************************************************************
+ * @fn      Text
+ * @brief   Text as ItmTraceText writes it, words then half word and byte
+ ******************************************************************************/
+static void Text(std::vector<uint8_t> &stream, const char *text)
+{
+	size_t length = strlen(text);
+	uint32_t value = 0;
+
+	for(; length >= 4; length -= 4, text += 4)
+	{
+		memcpy(&value, text, 4);
+		Write(stream, logItmChannel, 4, value);
+	}
+	if(length >= 2)
+	{
+		value = 0;
+		memcpy(&value, text, 2);
+		Write(stream, logItmChannel, 2, value);
+		length -= 2;
+		text += 2;
+	}
+	if(length > 0)
+	{
+		Write(stream, logItmChannel, 1, (uint8_t)*text);
+	}
+}
+
+/*******************************************************************************
+ * @fn      Stream
+ * @brief   Writes of all channels between sync, overflow, timestamp,
+ *          hardware, extension and reserved packets
+ ******************************************************************************/
+static std::vector<uint8_t> Stream(void)
+{
+	static const uint8_t sync[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x80};
+	std::vector<uint8_t> stream(sync, sync + sizeof(sync));
+
+	Text(stream, "Total coin = 5\n");
+	Write(stream, transitionItmChannel, 4, ITM_TRACE_TRANSITION(0, 1, 1));
+	stream.insert(stream.end(), {0xC0, 0x85, 0x01});		// Local timestamp 1
+	Write(stream, timerItmChannel, 4, ITM_TRACE_TIMER(3, 0x01123456));
+	stream.push_back(0x30);									// Local timestamp 2
+	Write(stream, profileItmChannel, 4, ITM_TRACE_PROFILE(5, 0, 0xFFFFF0));
+	stream.push_back(0x70);									// Overflow
+	Write(stream, 2, 4, 0x08000123, true);					// DWT PC sample
+	stream.insert(stream.end(), {0x94, 0x81, 0x00});		// Global timestamp 1
+	Write(stream, profileItmChannel, 4, ITM_TRACE_PROFILE(5, 1, 0x000010));
+	stream.insert(stream.end(), {0x88, 0x01});				// Extension
+	stream.push_back(0x80);									// Reserved without sync
+	Write(stream, 31, 2, 0xBEEF);
+	stream.insert(stream.end(), sync, sync + sizeof(sync));
+	Text(stream, "ok\n");
+	return stream;
+}
+
+/*******************************************************************************
+ * @fn      Check
+ * @brief   Writes and statistic of the test stream
+ ******************************************************************************/
+static void Check(const std::vector<itm::Packet> &packet, const itm::Statistic &statistic)
+{
+	std::string text;
+	uint32_t cycle = 0;
+	itm::Profiler profiler;
+
+	// Text of 15 bytes is 3 words, a half word and a byte
+	CHECK(packet.size() == 5 + 5 + 2);
+	for(size_t i = 0; i < 5; i++)
+	{
+		CHECK(packet[i].port == logItmChannel);
+		for(uint8_t j = 0; j < packet[i].size; j++)
+		{
+			text += (char)(packet[i].value >> (8 * j));
+		}
+	}
+	CHECK(text == "Total coin = 5\n" && packet[3].size == 2 && packet[4].size == 1);
+
+	const itm::Transition transition = itm::DecodeTransition(packet[5].value);
+	CHECK(packet[5].port == transitionItmChannel && transition.from == 0 && transition.to == 1 && transition.event == 1);
+	const itm::Timer timer = itm::DecodeTimer(packet[6].value);
+	CHECK(packet[6].port == timerItmChannel && timer.id == 3 && timer.tick == 0x123456);
+	const itm::Profile start = itm::DecodeProfile(packet[7].value);
+	const itm::Profile end = itm::DecodeProfile(packet[8].value);
+	CHECK(start.id == 5 && !start.end && start.cycle == 0xFFFFF0 && end.id == 5 && end.end);
+	CHECK(!profiler.Add(end, &cycle) && !profiler.Add(start, &cycle));
+	// Cycle counter bits wrapped during the task
+	CHECK(profiler.Add(end, &cycle) && cycle == 0x20);
+	CHECK(packet[9].port == 31 && packet[9].size == 2 && packet[9].value == 0xBEEF);
+	CHECK(packet[10].port == logItmChannel && packet[11].port == logItmChannel);
+
+	CHECK(statistic.syncCount == 2 && statistic.overflowCount == 1 && statistic.timestampCount == 3);
+	CHECK(statistic.hardwareCount == 1 && statistic.errorCount == 1);
+	CHECK(statistic.portPacket[logItmChannel] == 7 && statistic.portByte[logItmChannel] == 18);
+	CHECK(statistic.portByte[transitionItmChannel] == 4 && statistic.portByte[profileItmChannel] == 8);
+}
+
+int main(void)
+{
+	const std::vector<uint8_t> stream = Stream();
+	std::vector<uint8_t> benchmark;
+	std::vector<itm::Packet> packet;
+	uint64_t packetCount = 0;
+	uint64_t startTime = 0;
+	double second = 0;
+
+	for(size_t split = 0; split <= stream.size(); split++)
+	{
+		itm::Demux demux([&](const itm::Packet &entry) { packet.push_back(entry); });
+
+		packet.clear();
+		demux.Feed(stream.data(), split);
+		demux.Feed(stream.data() + split, stream.size() - split);
+		Check(packet, demux.GetStatistic());
+	}
+
+	// Trace mix of a busy machine: profile pairs, transitions, timers, text
+	while(benchmark.size() < TEST_BENCHMARK_SIZE)
+	{
+		for(uint32_t i = 0; i < 64; i++)
+		{
+			Write(benchmark, profileItmChannel, 4, ITM_TRACE_PROFILE(i % 7, i & 1, i * 977));
+			Write(benchmark, timerItmChannel, 4, ITM_TRACE_TIMER(i % 12, i));
+		}
+		Write(benchmark, transitionItmChannel, 4, ITM_TRACE_TRANSITION(1, 2, 2));
+		Text(benchmark, "Press button at enough coin machine status\n");
+	}
+	itm::Demux demux([&](const itm::Packet &entry) { packetCount += entry.size; });
+	startTime = HostNanosecond();
+	demux.Feed(benchmark.data(), benchmark.size());
+	second = (HostNanosecond() - startTime) / 1e9;
+	CHECK(demux.GetStatistic().errorCount == 0);
+	printf("Demultiplexed %zu MB, %.1f MB/s, %.0f payload MB/s (host)\n", benchmark.size() >> 20,
+			benchmark.size() / second / 1e6, packetCount / second / 1e6);
+	printf("ITM demux passed\n");
+	return EXIT_SUCCESS;
+}
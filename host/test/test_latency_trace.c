@@ -0,0 +1,312 @@
+/*******************************************************************************
+ * Filename:			test_latency_trace.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Host simulation of the edge-to-state-change path.
+ *						MainLoop runs as on target, its idle hook injects
+ *						bouncing coin and button presses at the given rates
+ *						and 1 ms timer interrupts in simulated time. Time the
+ *						main loop is busy is host time (host proxy), the stamp
+ *						timer holds simulated us at every wake up. At the
+ *						end the latency trace breakdown is printed as the
+ *						latency console command prints it
+ *						e.g. test_latency_trace [coin/s] [button/s] [bounces]
+ *						[simulated s]
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "main_loop.h"
+#include "latency_trace.h"
+#include "exti_guard.h"
+#include "state_machine.h"
+#include "software_timer.h"
+#include "tim.h"
+#include "host_hal.h"
+#include "check.h"
+#include <math.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_COIN_RATE			2.0				// Presses per s
+#define TEST_BUTTON_RATE		0.2
+#define TEST_BOUNCE				5				// Extra falling edges per press and release
+#define TEST_DURATION			600				// s of simulated time
+#define TEST_BOUNCE_INTERVAL	200000ULL		// ns between bounce edges
+#define TEST_HOLD				100000000ULL	// ns pin stays low per press
+#define TEST_CHANGE_SIZE		64
+#define TEST_REPORT_SIZE		4096
+// Debounce delay of main_loop.c
+#define TEST_DEBOUNCE			50
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Pin level changes of one input, in time order
+typedef struct
+{
+	double rate;					// Presses per s
+	uint64_t nextPress;				// ns
+	uint64_t changeTime[TEST_CHANGE_SIZE];
+	GPIO_PinState changeLevel[TEST_CHANGE_SIZE];
+	uint8_t numOfChange;
+	uint8_t changeIndex;
+	uint32_t pressCount;
+	uint32_t edgeCount;				// Falling edges on the pin
+}
+sTEST_INPUT;
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static sTEST_INPUT sTestInput[maximumDebounceInput];
+static uint32_t bounce = TEST_BOUNCE;
+static uint64_t duration = TEST_DURATION * 1000000000ULL;
+static uint64_t randomState = 0x2545F4914F6CDD1D;
+// Simulated time, ns
+static uint64_t now;
+// Cycle counter runs on host time from the return of idle hook
+static uint64_t resumeTime;
+static char report[TEST_REPORT_SIZE];
+static uint32_t reportLength;
+
+/*******************************************************************************
+ * @fn      Random
+ * @brief   Uniform in (0, 1), xorshift64
+ ******************************************************************************/
+static double Random(void)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 7;
+	randomState ^= randomState << 17;
+	return ((randomState >> 11) + 0.5) / (double)(1ULL << 53);
+}
+
+/*******************************************************************************
+ * @fn      Cycle
+ * @brief   Cycle counter of simulation, DWT->CYCCNT holds the count at the
+ *          return of idle hook
+ ******************************************************************************/
+static uint32_t Cycle(void)
+{
+	return DWT->CYCCNT + (uint32_t)((HostNanosecond() - resumeTime) * (SystemCoreClock / 1000000) / 1000);
+}
+
+/*******************************************************************************
+ * @fn      Press
+ * @brief   Pin changes of a press at now: bouncing falling edges, low for
+ *          hold time, release bouncing back to high. Next press follows
+ *          Poisson arrivals after the release
+ ******************************************************************************/
+static void Press(sTEST_INPUT *psInput)
+{
+	uint64_t time = now;
+	uint32_t i = 0;
+
+	psInput->numOfChange = 0;
+	psInput->changeIndex = 0;
+	for(i = 0; i <= bounce; i++)
+	{
+		psInput->changeTime[psInput->numOfChange] = time;
+		psInput->changeLevel[psInput->numOfChange++] = GPIO_PIN_RESET;
+		time += TEST_BOUNCE_INTERVAL;
+		if(i < bounce)
+		{
+			psInput->changeTime[psInput->numOfChange] = time;
+			psInput->changeLevel[psInput->numOfChange++] = GPIO_PIN_SET;
+			time += TEST_BOUNCE_INTERVAL;
+		}
+	}
+	time = now + TEST_HOLD;
+	for(i = 0; i <= bounce; i++)
+	{
+		psInput->changeTime[psInput->numOfChange] = time;
+		psInput->changeLevel[psInput->numOfChange++] = GPIO_PIN_SET;
+		time += TEST_BOUNCE_INTERVAL;
+		if(i < bounce)
+		{
+			psInput->changeTime[psInput->numOfChange] = time;
+			psInput->changeLevel[psInput->numOfChange++] = GPIO_PIN_RESET;
+			time += TEST_BOUNCE_INTERVAL;
+		}
+	}
+	psInput->pressCount++;
+	psInput->nextPress = now + (uint64_t)(-log(Random()) / psInput->rate * 1e9);
+	// A press starts after the line settled high again
+	if(psInput->nextPress < time + 2 * TEST_DEBOUNCE * 1000000ULL)
+	{
+		psInput->nextPress = time + 2 * TEST_DEBOUNCE * 1000000ULL;
+	}
+}
+
+/*******************************************************************************
+ * @fn      Change
+ * @brief   Next pin change of input, falling edge raises EXTI unless masked
+ ******************************************************************************/
+static void Change(uint8_t eInput)
+{
+	sTEST_INPUT *psInput = &sTestInput[eInput];
+	const sDEBOUNCE_INPUT *psDebounceInput = &sDebounceInput[eInput];
+	GPIO_PinState level = psInput->changeLevel[psInput->changeIndex++];
+
+	if(level == GPIO_PIN_SET)
+	{
+		psDebounceInput->port->IDR |= psDebounceInput->gpioPin;
+		return;
+	}
+	psDebounceInput->port->IDR &= ~(uint32_t)psDebounceInput->gpioPin;
+	psInput->edgeCount++;
+	if((EXTI->IMR1 & psDebounceInput->gpioPin) != 0)
+	{
+		HAL_GPIO_EXTI_Callback(psDebounceInput->gpioPin);
+	}
+}
+
+/*******************************************************************************
+ * @fn      CaptureReport
+ * @brief   Console TX after simulation is the report
+ ******************************************************************************/
+static void CaptureReport(const uint8_t *data, uint32_t length)
+{
+	length = length < TEST_REPORT_SIZE - 1 - reportLength ? length : TEST_REPORT_SIZE - 1 - reportLength;
+	memcpy(&report[reportLength], data, length);
+	reportLength += length;
+}
+
+/*******************************************************************************
+ * @fn      Report
+ * @brief   Print latency and EXTI guard as the console commands do, check
+ *          every press reached the state machine once
+ ******************************************************************************/
+static void Report(void)
+{
+	sSTATE_MACHINE_COUNTER sCounter;
+	char name[32];
+	unsigned long numOfEvent = 0;
+	unsigned long p50 = 0;
+	const unsigned long usPerMs = LATENCY_TRACE_CLOCK / 1000;
+	const char *line = NULL;
+	uint8_t i = 0;
+
+	// Log of the run is dropped, replies of commands are kept
+	while(HostDmaComplete())
+	{
+	}
+	hostDmaTransmitHook = CaptureReport;
+	sLatencyTrace.Print();
+	sExtiGuard.Print();
+	while(HostDmaComplete())
+	{
+	}
+	printf("%.0f s simulated, main loop busy time is host time (host proxy)\n", now / 1e9);
+	for(i = 0; i < maximumDebounceInput; i++)
+	{
+		printf("%-6s %6lu presses %8lu edges\n", sDebounceInput[i].name, (unsigned long)sTestInput[i].pressCount,
+				(unsigned long)sTestInput[i].edgeCount);
+	}
+	printf("%s", report);
+
+	// Press in flight at the end is not counted yet
+	sStateMachine.GetCounter(&sCounter);
+	CHECK(sCounter.lifetimeCoin + sCounter.heldCoin + 1 >= sTestInput[coinDebounceInput].pressCount);
+	for(i = 0; i < maximumDebounceInput; i++)
+	{
+		snprintf(name, sizeof(name), "%s latency, ", sDebounceInput[i].name);
+		line = strstr(report, name);
+		CHECK(line != NULL && sscanf(line + strlen(name), "%lu", &numOfEvent) == 1);
+		CHECK(numOfEvent + 1 >= sTestInput[i].pressCount && numOfEvent <= sTestInput[i].pressCount);
+		// Debounce runs from the last bounce, within a 1 ms timer tick
+		line = strstr(line, "total");
+		CHECK(line != NULL && sscanf(line, "total %lu", &p50) == 1);
+		CHECK(p50 >= usPerMs * (TEST_DEBOUNCE - 1));
+		CHECK(p50 <= usPerMs * (TEST_DEBOUNCE + 1) + bounce * 2 * TEST_BOUNCE_INTERVAL / 1000);
+	}
+	printf("Latency trace passed\n");
+	exit(EXIT_SUCCESS);
+}
+
+/*******************************************************************************
+ * @fn      Idle
+ * @brief   Main loop sleeps: charge its busy time, advance simulated time
+ *          to the next timer tick or pin change and raise its interrupt
+ ******************************************************************************/
+static void Idle(void)
+{
+	uint64_t next = 0;
+	uint64_t busyTime = 0;
+	uint8_t eInput = maximumDebounceInput;
+	uint8_t i = 0;
+
+	// Busy time since last idle passes as host time
+	busyTime = HostNanosecond() - resumeTime;
+	DWT->CYCCNT += (uint32_t)(busyTime * (SystemCoreClock / 1000000) / 1000);
+	now += busyTime;
+
+	// Timer tick at next ms, pin change or press when earlier
+	next = (now / 1000000 + 1) * 1000000;
+	for(i = 0; i < maximumDebounceInput; i++)
+	{
+		sTEST_INPUT *psInput = &sTestInput[i];
+		uint64_t time = psInput->changeIndex < psInput->numOfChange ? psInput->changeTime[psInput->changeIndex]
+				: psInput->nextPress;
+
+		if(time < next)
+		{
+			next = time;
+			eInput = i;
+		}
+	}
+	// Change due while main loop was busy is taken now
+	next = next > now ? next : now;
+	if(next >= duration)
+	{
+		Report();
+	}
+	DWT->CYCCNT += (uint32_t)((next - now) * (SystemCoreClock / 1000000) / 1000);
+	now = next;
+	hostTick = (uint32_t)(now / 1000000);
+	TIM5->CNT = (uint32_t)(now / 1000);
+	// Interrupt and the main loop after it run on host time
+	resumeTime = HostNanosecond();
+
+	if(eInput == maximumDebounceInput)
+	{
+		SoftwareTimerInterruptCallback();
+	}
+	else if(sTestInput[eInput].changeIndex < sTestInput[eInput].numOfChange)
+	{
+		Change(eInput);
+	}
+	else
+	{
+		Press(&sTestInput[eInput]);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t i = 0;
+
+	sTestInput[coinDebounceInput].rate = argc > 1 ? atof(argv[1]) : TEST_COIN_RATE;
+	sTestInput[buttonDebounceInput].rate = argc > 2 ? atof(argv[2]) : TEST_BUTTON_RATE;
+	bounce = argc > 3 ? (uint32_t)atoi(argv[3]) : TEST_BOUNCE;
+	duration = (argc > 4 ? (uint64_t)atoi(argv[4]) : TEST_DURATION) * 1000000000ULL;
+	CHECK(sTestInput[coinDebounceInput].rate > 0 && sTestInput[buttonDebounceInput].rate > 0);
+	CHECK(bounce * 4 + 2 <= TEST_CHANGE_SIZE);
+
+	// Pins idle high with EXTI unmasked as MX_GPIO_Init leaves them
+	for(i = 0; i < maximumDebounceInput; i++)
+	{
+		sDebounceInput[i].port->IDR |= sDebounceInput[i].gpioPin;
+		EXTI->IMR1 |= sDebounceInput[i].gpioPin;
+		sTestInput[i].nextPress = (uint64_t)(-log(Random()) / sTestInput[i].rate * 1e9);
+	}
+	MX_TIM6_Init();
+	hostIdleHook = Idle;
+	hostCycleHook = Cycle;
+	resumeTime = HostNanosecond();
+	MainLoop();
+	return EXIT_FAILURE;
+}
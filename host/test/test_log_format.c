@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Filename:			test_log_format.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Log formatter against C library vsnprintf for every
+ *						supported conversion, flag and width, and truncation.
+ *						Then time per "Total coin = %d" message of both, as
+ *						"log bench" on target
+ *						e.g. test_log_format [messages]
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "log.h"
+#include "host_hal.h"
+#include "check.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_MESSAGE				10000000
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      Same
+ * @brief   Format with both into buffers of size, same text and length
+ *          cut to size - 1
+ ******************************************************************************/
+static void Same(uint32_t size, const char *format, ...) __attribute__((format(printf, 2, 3)));
+static void Same(uint32_t size, const char *format, ...)
+{
+	char logBuffer[LOG_LINE_SIZE];
+	char libraryBuffer[LOG_LINE_SIZE];
+	uint32_t length = 0;
+	int expected = 0;
+	va_list args;
+	va_list copy;
+
+	CHECK(size <= LOG_LINE_SIZE);
+	va_start(args, format);
+	va_copy(copy, args);
+	length = sLog.Format(logBuffer, size, format, args);
+	expected = vsnprintf(libraryBuffer, size, format, copy);
+	va_end(copy);
+	va_end(args);
+	if(expected >= (int)size)
+	{
+		expected = size - 1;
+	}
+	if(length != (uint32_t)expected || strcmp(logBuffer, libraryBuffer) != 0)
+	{
+		fprintf(stderr, "\"%s\": \"%s\" expected \"%s\"\n", format, logBuffer, libraryBuffer);
+	}
+	CHECK(length == (uint32_t)expected && strcmp(logBuffer, libraryBuffer) == 0);
+}
+
+/*******************************************************************************
+ * @fn      LogMessage
+ * @brief   Format as LogPrintf does, sink excluded
+ ******************************************************************************/
+static uint32_t LogMessage(char *buffer, uint32_t size, const char *format, ...)
+{
+	uint32_t length = 0;
+	va_list args;
+
+	va_start(args, format);
+	length = sLog.Format(buffer, size, format, args);
+	va_end(args);
+	return length;
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t numOfMessage = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : TEST_MESSAGE;
+	char buffer[LOG_LINE_SIZE];
+	uint64_t startTime = 0;
+	double logTime = 0;
+	double libraryTime = 0;
+	uint32_t length = 0;
+	uint32_t i = 0;
+
+	// Conversions, flags and widths used by log sites
+	Same(LOG_LINE_SIZE, "Total coin = %d\n", 42);
+	Same(LOG_LINE_SIZE, "%d %d %i", 0, -7, (int)0x80000000);
+	Same(LOG_LINE_SIZE, "%u %lu %hu", 4000000000u, (unsigned long)123456, (unsigned short)65535);
+	Same(LOG_LINE_SIZE, "%x %X %08x %8X", 0xDEADBEEF, 0xbeef, 0x2A, 0xA5);
+	Same(LOG_LINE_SIZE, "[%5d] [%-5d] [%05d] [%3d]", 42, 42, -42, 12345);
+	Same(LOG_LINE_SIZE, "[%c] [%s] [%-12s] [%11s] [%s]", 'A', "coin", "Boot", "-", "");
+	Same(LOG_LINE_SIZE, "%-12s %11lu %10lu\n", "Clock switch", (unsigned long)81234, (unsigned long)1015);
+	Same(LOG_LINE_SIZE, "100%% %c%c", 'o', 'k');
+	// Cut to the buffer, terminator kept
+	Same(8, "Total coin = %d\n", 255);
+	Same(1, "%s", "dropped");
+	Same(14, "%-20s|", "left");
+
+	// Per message time, format and integer conversion only
+	startTime = HostNanosecond();
+	for(i = 0; i < numOfMessage; i++)
+	{
+		length += LogMessage(buffer, sizeof(buffer), "Total coin = %d\n", (int)(i & 0xFF));
+	}
+	logTime = (double)(HostNanosecond() - startTime) / numOfMessage;
+	startTime = HostNanosecond();
+	for(i = 0; i < numOfMessage; i++)
+	{
+		length -= snprintf(buffer, sizeof(buffer), "Total coin = %d\n", (int)(i & 0xFF));
+	}
+	libraryTime = (double)(HostNanosecond() - startTime) / numOfMessage;
+	CHECK(length == 0);
+	printf("\"Total coin = %%d\": log %.1f ns, snprintf %.1f ns per message (host)\n", logTime, libraryTime);
+
+	printf("Log format passed\n");
+	return EXIT_SUCCESS;
+}
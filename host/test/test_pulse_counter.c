@@ -0,0 +1,140 @@
+/*******************************************************************************
+ * Filename:			test_pulse_counter.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Pulse counter on the host LPTIM model. Source is
+ *						included with PULSE_COUNTER_ENABLE set, as the firmware
+ *						build leaves it off. Train end by idle periods, end by
+ *						compare match, counter wrap and both channels checked
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "pulse_counter.h"
+#undef PULSE_COUNTER_ENABLE
+#define PULSE_COUNTER_ENABLE		1
+#include "../../Core/Src/pulse_counter.c"
+#include "host_hal.h"
+#include "check.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Validator pulse spacing in ms, 50 ms period reads several per train
+#define TEST_PULSE_SPACING			20
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      Tick
+ * @brief   1 ms timer interrupts
+ ******************************************************************************/
+static void Tick(uint32_t ms)
+{
+	for(; ms > 0; ms--)
+	{
+		hostTick++;
+		SoftwareTimerInterruptCallback();
+	}
+}
+
+/*******************************************************************************
+ * @fn      Pulse
+ * @brief   One pulse on LPTIM input, interrupt as LPTIMx_IRQHandler
+ ******************************************************************************/
+static void Pulse(LPTIM_TypeDef *lptim)
+{
+	if(HostLptimPulse(lptim, 1))
+	{
+		PulseCounterInterruptCallback(lptim);
+	}
+}
+
+/*******************************************************************************
+ * @fn      Train
+ * @brief   Pulses spaced TEST_PULSE_SPACING apart, then wait for train end
+ ******************************************************************************/
+static void Train(LPTIM_TypeDef *lptim, uint32_t numOfPulse)
+{
+	for(; numOfPulse > 0; numOfPulse--)
+	{
+		Pulse(lptim);
+		Tick(TEST_PULSE_SPACING);
+	}
+}
+
+/*******************************************************************************
+ * @fn      CoinPulseFlag
+ * @brief   Take coin pulse event flag
+ ******************************************************************************/
+static bool CoinPulseFlag(void)
+{
+	return (sEventFlag.FetchAndClearAll() & ((uint64_t)0x01 << coinPulseEventFlag)) != 0;
+}
+
+int main(void)
+{
+	uint32_t i = 0;
+
+	HostLptimReset(LPTIM1);
+	HostLptimReset(LPTIM2);
+	// Counter left near the top by an earlier run, first trains wrap
+	LPTIM2->CNT = 0xFFF8;
+	sPulseCounter.Initialize();
+	CHECK((LPTIM1->CR & LPTIM_CR_ENABLE) && (LPTIM1->CFGR & LPTIM_CFGR_COUNTMODE) && LPTIM1->ARR == 0xFFFF);
+	CHECK(LPTIM1->CMP == PULSE_COUNTER_COMPARE && LPTIM2->CMP == (uint16_t)(0xFFF8 + PULSE_COUNTER_COMPARE));
+
+	// Train ends after PULSE_COUNTER_TIMEOUT periods without pulse, not before
+	Train(LPTIM1, 3);
+	CHECK(sPulseCounter.Take() == 0 && !CoinPulseFlag());
+	Tick((PULSE_COUNTER_TIMEOUT + 1) * PULSE_COUNTER_PERIOD);
+	CHECK(CoinPulseFlag() && sPulseCounter.Take() == 3);
+	Tick(10 * PULSE_COUNTER_PERIOD);
+	CHECK(sPulseCounter.Take() == 0 && !CoinPulseFlag());
+
+	// Long train is cut by compare match at once, rest ends by idle periods
+	for(i = 0; i < PULSE_COUNTER_COMPARE; i++)
+	{
+		Pulse(LPTIM1);
+	}
+	CHECK(CoinPulseFlag() && sPulseCounter.Take() == PULSE_COUNTER_COMPARE);
+	CHECK(LPTIM1->CMP == (uint16_t)(3 + 2 * PULSE_COUNTER_COMPARE));
+	Train(LPTIM1, 5);
+	Tick((PULSE_COUNTER_TIMEOUT + 1) * PULSE_COUNTER_PERIOD);
+	CHECK(sPulseCounter.Take() == 5);
+
+	// Trains across counter wrap on LPTIM2, compare match after the wrap
+	Train(LPTIM2, 6);
+	Tick((PULSE_COUNTER_TIMEOUT + 1) * PULSE_COUNTER_PERIOD);
+	CHECK(LPTIM2->CNT == 0xFFFE && sPulseCounter.Take() == 6);
+	Train(LPTIM2, 4);
+	Tick((PULSE_COUNTER_TIMEOUT + 1) * PULSE_COUNTER_PERIOD);
+	CHECK(LPTIM2->CNT == 2 && sPulseCounter.Take() == 4);
+	for(i = 0; i < PULSE_COUNTER_COMPARE; i++)
+	{
+		Pulse(LPTIM2);
+	}
+	CHECK(sPulseCounter.Take() == PULSE_COUNTER_COMPARE);
+
+	// Both channels at once add up, one pulse train each
+	for(i = 0; i < 4; i++)
+	{
+		Pulse(LPTIM1);
+		Pulse(LPTIM2);
+		Tick(TEST_PULSE_SPACING);
+	}
+	Pulse(LPTIM2);
+	Tick((PULSE_COUNTER_TIMEOUT + 1) * PULSE_COUNTER_PERIOD);
+	CHECK(CoinPulseFlag() && sPulseCounter.Take() == 9);
+
+	// Disabled counter takes no pulse
+	LPTIM1->CR = 0;
+	CHECK(!HostLptimPulse(LPTIM1, 100));
+	Tick((PULSE_COUNTER_TIMEOUT + 1) * PULSE_COUNTER_PERIOD);
+	CHECK(sPulseCounter.Take() == 0);
+
+	printf("Pulse counter passed\n");
+	return EXIT_SUCCESS;
+}
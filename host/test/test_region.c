@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Filename:			test_region.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Region engine on sets of 1..REGION_BENCHMARK_REGION
+ *						benchmark regions. Source is included for its toggle
+ *						region. Every region must take every handled event
+ *						and skip ignored ones, then dispatch time per event
+ *						is measured as regions grow
+ *						e.g. test_region [events]
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "../../Core/Src/region.c"
+#include "host_hal.h"
+#include "check.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_EVENT					10000000
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      Build
+ * @brief   Set of numOfRegion toggle regions, all in state 0
+ ******************************************************************************/
+static void Build(sREGION_SET *psRegionSet, sREGION *psRegion, uint8_t *state, uint8_t numOfRegion)
+{
+	uint8_t i = 0;
+
+	for(i = 0; i < numOfRegion; i++)
+	{
+		psRegion[i].name = "toggle";
+		psRegion[i].numOfState = 2;
+		psRegion[i].handler = regionToggleHandler;
+		state[i] = 0;
+	}
+	memset(psRegionSet, 0, sizeof(*psRegionSet));
+	psRegionSet->psRegion = psRegion;
+	psRegionSet->state = state;
+	psRegionSet->numOfRegion = numOfRegion;
+	psRegionSet->numOfEvent = 2;
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t numOfEvent = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : TEST_EVENT;
+	sREGION sRegion[REGION_BENCHMARK_REGION];
+	uint8_t state[REGION_BENCHMARK_REGION];
+	sREGION_SET sRegionSet;
+	uint64_t startTime = 0;
+	double nanosecond = 0;
+	uint32_t i = 0;
+	uint8_t n = 0;
+
+	// Handled event flips every region, ignored and unknown events do not
+	Build(&sRegionSet, sRegion, state, REGION_BENCHMARK_REGION);
+	sRegionEngine.Dispatch(&sRegionSet, 0, 0);
+	sRegionEngine.Dispatch(&sRegionSet, 1, 0);
+	sRegionEngine.Dispatch(&sRegionSet, 2, 0);
+	for(i = 0; i < REGION_BENCHMARK_REGION; i++)
+	{
+		CHECK(state[i] == 1);
+	}
+	CHECK(sRegionSet.sStatistic.dispatchCount == 2 && sRegionSet.sStatistic.handlerCount == REGION_BENCHMARK_REGION);
+	CHECK(sRegionEngine.Valid(&sRegionSet));
+	state[REGION_BENCHMARK_REGION - 1] = 2;
+	CHECK(!sRegionEngine.Valid(&sRegionSet));
+
+	// Same event stream as the console benchmark, handled and ignored in turn
+	numOfEvent &= ~0x01;
+	printf("Regions  ns/event  ns/region (host)\n");
+	for(n = 1; n <= REGION_BENCHMARK_REGION; n++)
+	{
+		Build(&sRegionSet, sRegion, state, n);
+		startTime = HostNanosecond();
+		for(i = 0; i < numOfEvent; i++)
+		{
+			sRegionEngine.Dispatch(&sRegionSet, i & 0x01, 0);
+		}
+		nanosecond = (double)(HostNanosecond() - startTime) / numOfEvent;
+		CHECK(sRegionSet.sStatistic.handlerCount == numOfEvent / 2 * n && state[n - 1] == ((numOfEvent / 2) & 0x01));
+		printf("%7d %9.2f %10.2f\n", n, nanosecond, nanosecond / n);
+	}
+
+	printf("Region passed\n");
+	return EXIT_SUCCESS;
+}
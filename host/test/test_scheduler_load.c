@@ -0,0 +1,254 @@
+/*******************************************************************************
+ * Filename:			test_scheduler_load.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Deadline miss rate of the EDF scheduler at increasing
+ *						load. Main loop tasks get random event arrivals in
+ *						simulated time, a task advances time by its execution
+ *						time. Misses are counted by the scheduler from release
+ *						and by the test from the event arrival
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "scheduler.h"
+#include "host_hal.h"
+#include "check.h"
+#include <math.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_TASK				7
+#define TEST_DURATION			60000000		// us of simulated time per load
+#define TEST_LOAD_STEP			10				// % of load
+#define TEST_MAXIMUM_LOAD		150
+// Execution time is uniform from 1/4 to all of budget
+#define TEST_COST_MINIMUM		0.25
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Simulated task, one open instance from first arrival to start of run
+typedef struct
+{
+	uint64_t nextArrival;			// us
+	double meanInterval;			// us
+	bool open;
+	uint64_t firstArrival;
+	uint32_t runCount;
+	uint32_t arrivalMiss;			// Completed after deadline from arrival
+	uint32_t mergedCount;			// Arrivals into an open instance
+}
+sTEST_TASK;
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static void Task0(void);
+static void Task1(void);
+static void Task2(void);
+static void Task3(void);
+static void Task4(void);
+static void Task5(void);
+static void Task6(void);
+
+// Deadlines and budgets of sEventTask in main_loop.c
+static const sSCHEDULER_TASK sTask[TEST_TASK] =
+{
+	{"coinInsert",		Task0,	10,		2000},
+	{"buttonPressed",	Task1,	10,		2000},
+	{"coinPulse",		Task2,	10,		2000},
+	{"coinCapture",		Task3,	10,		4000},
+	{"flashJournal",	Task4,	5,		500},
+	{"clockGovernor",	Task5,	100,	500},
+	{"dispensingTimer",	Task6,	20,		2000},
+};
+
+static sTEST_TASK sTestTask[TEST_TASK];
+static uint64_t now;
+static uint64_t busyTime;
+static uint64_t randomState = 0x2545F4914F6CDD1D;
+
+/*******************************************************************************
+ * @fn      Random
+ * @brief   Uniform in (0, 1), xorshift64
+ ******************************************************************************/
+static double Random(void)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 7;
+	randomState ^= randomState << 17;
+	return ((randomState >> 11) + 0.5) / (double)(1ULL << 53);
+}
+
+/*******************************************************************************
+ * @fn      SetTime
+ * @brief   HAL tick and cycle counter follow simulated time
+ ******************************************************************************/
+static void SetTime(uint64_t time)
+{
+	now = time;
+	hostTick = (uint32_t)(now / 1000);
+	DWT->CYCCNT = (uint32_t)(now * (SystemCoreClock / 1000000));
+}
+
+/*******************************************************************************
+ * @fn      Execute
+ * @brief   Run of task, instance closes at start, time passes by the
+ *          execution time
+ ******************************************************************************/
+static void Execute(uint8_t taskId)
+{
+	sTEST_TASK *psTestTask = &sTestTask[taskId];
+	uint64_t cost = (uint64_t)(sTask[taskId].budget * (TEST_COST_MINIMUM + (1.0 - TEST_COST_MINIMUM) * Random()));
+
+	psTestTask->open = false;
+	psTestTask->runCount++;
+	busyTime += cost;
+	SetTime(now + cost);
+	if(now > psTestTask->firstArrival + sTask[taskId].deadline * 1000ULL)
+	{
+		psTestTask->arrivalMiss++;
+	}
+}
+
+static void Task0(void) { Execute(0); }
+static void Task1(void) { Execute(1); }
+static void Task2(void) { Execute(2); }
+static void Task3(void) { Execute(3); }
+static void Task4(void) { Execute(4); }
+static void Task5(void) { Execute(5); }
+static void Task6(void) { Execute(6); }
+
+/*******************************************************************************
+ * @fn      Arrive
+ * @brief   Events up to now raise their flag, an open instance takes them
+ *          like a flag raised twice
+ * @return  Flags raised
+ ******************************************************************************/
+static uint32_t Arrive(void)
+{
+	uint32_t pending = 0;
+	uint8_t i = 0;
+
+	for(i = 0; i < TEST_TASK; i++)
+	{
+		while(sTestTask[i].nextArrival <= now)
+		{
+			if(sTestTask[i].open)
+			{
+				sTestTask[i].mergedCount++;
+			}
+			else
+			{
+				sTestTask[i].open = true;
+				sTestTask[i].firstArrival = sTestTask[i].nextArrival;
+				pending |= (uint32_t)0x01 << i;
+			}
+			sTestTask[i].nextArrival += (uint64_t)(-log(Random()) * sTestTask[i].meanInterval) + 1;
+		}
+	}
+	return pending;
+}
+
+/*******************************************************************************
+ * @fn      Simulate
+ * @brief   Main loop pass as MainLoop: release raised flags, run the task
+ *          with earliest deadline, sleep to next arrival when none is ready.
+ *          Every task offers an equal share of load
+ * @param   load		%
+ * @return  None
+ ******************************************************************************/
+static void Simulate(uint32_t load)
+{
+	sSCHEDULER_STATISTIC sStatistic;
+	uint32_t schedulerMiss = 0;
+	uint32_t arrivalMiss = 0;
+	uint32_t mergedCount = 0;
+	uint32_t runCount = 0;
+	uint64_t nextArrival = 0;
+	uint8_t taskId = 0;
+	uint8_t i = 0;
+
+	sScheduler.Initialize();
+	memset(sTestTask, 0, sizeof(sTestTask));
+	busyTime = 0;
+	SetTime(0);
+	for(i = 0; i < TEST_TASK; i++)
+	{
+		sScheduler.Register(i, &sTask[i]);
+		// Mean execution time over load share
+		sTestTask[i].meanInterval = sTask[i].budget * (1.0 + TEST_COST_MINIMUM) / 2 * TEST_TASK * 100 / load;
+		sTestTask[i].nextArrival = (uint64_t)(Random() * sTestTask[i].meanInterval);
+	}
+
+	while(now < TEST_DURATION)
+	{
+		sScheduler.Release(0, Arrive());
+		taskId = sScheduler.Next();
+		if(taskId == SCHEDULER_NO_TASK)
+		{
+			nextArrival = UINT64_MAX;
+			for(i = 0; i < TEST_TASK; i++)
+			{
+				nextArrival = sTestTask[i].nextArrival < nextArrival ? sTestTask[i].nextArrival : nextArrival;
+			}
+			SetTime(nextArrival);
+			continue;
+		}
+		sScheduler.Run(taskId);
+	}
+
+	for(i = 0; i < TEST_TASK; i++)
+	{
+		CHECK(sScheduler.GetStatistic(i, &sStatistic));
+		CHECK(sStatistic.runCount == sTestTask[i].runCount && sStatistic.overrunCount == 0);
+		// Release follows arrival, a miss from release is one from arrival
+		CHECK(sStatistic.missCount <= sTestTask[i].arrivalMiss);
+		schedulerMiss += sStatistic.missCount;
+		arrivalMiss += sTestTask[i].arrivalMiss;
+		mergedCount += sTestTask[i].mergedCount;
+		runCount += sTestTask[i].runCount;
+	}
+	CHECK(!sScheduler.GetStatistic(TEST_TASK, &sStatistic));
+	// Merged arrivals do no work of their own, busy stays below offered load
+	CHECK(100.0 * busyTime / now < load + 2.0);
+
+	printf("%4lu%% %5.1f%% %7lu %6.2f%% %7.3f%% %7.3f%%\n", (unsigned long)load, 100.0 * busyTime / now,
+			(unsigned long)runCount, 100.0 * mergedCount / (runCount + mergedCount),
+			100.0 * schedulerMiss / runCount, 100.0 * arrivalMiss / runCount);
+	if(load == TEST_LOAD_STEP)
+	{
+		CHECK(arrivalMiss == 0 && mergedCount * 100 < runCount);
+	}
+	if(load < TEST_MAXIMUM_LOAD)
+	{
+		return;
+	}
+	// Overload shows as merged flags more than as late runs
+	CHECK(arrivalMiss > 0 && mergedCount * 2 > runCount);
+	for(i = 0; i < TEST_TASK; i++)
+	{
+		CHECK(sScheduler.GetStatistic(i, &sStatistic));
+		printf("  %-15s %3d ms %7lu runs %6.2f%% merged %7.3f%% %7.3f%% miss\n", sTask[i].name, sTask[i].deadline,
+				(unsigned long)sTestTask[i].runCount,
+				100.0 * sTestTask[i].mergedCount / (sTestTask[i].runCount + sTestTask[i].mergedCount),
+				100.0 * sStatistic.missCount / sTestTask[i].runCount,
+				100.0 * sTestTask[i].arrivalMiss / sTestTask[i].runCount);
+	}
+}
+
+int main(void)
+{
+	uint32_t load = 0;
+
+	printf("Load  busy    runs merged miss from release, arrival\n");
+	for(load = TEST_LOAD_STEP; load <= TEST_MAXIMUM_LOAD; load += TEST_LOAD_STEP)
+	{
+		Simulate(load);
+	}
+	printf("Scheduler load passed\n");
+	return EXIT_SUCCESS;
+}
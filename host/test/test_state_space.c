@@ -0,0 +1,580 @@
+/*******************************************************************************
+ * Filename:			test_state_space.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Explicit state model check of the state machine. Every
+ *						thread runs its own model copy, breadth first search
+ *						level by level over a hashed visited set. Fails on
+ *						credit overflow, lost coins and states that can not
+ *						get back to idle, reports unreachable region states
+ *						and uncovered transitions. test_state_space [threads]
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+// dlmopen
+#define _GNU_SOURCE
+#include "state_model.h"
+#include "host_hal.h"
+#include "check.h"
+#include <dlfcn.h>
+#include <limits.h>
+#include <libgen.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_THREAD				4
+// dlmopen has 16 namespaces, the first one is the checker
+#define TEST_MAXIMUM_THREAD		15
+#define TEST_MAXIMUM_STATE		(1U << 20)
+#define TEST_BUCKET				(1U << 20)
+#define TEST_LOCK				256
+#define TEST_CHUNK				64
+// Credit plus held coins the checker inserts up to, enough to hold coins
+// beyond uint8_t credit
+#define TEST_CREDIT_LIMIT		(3 * UINT8_MAX)
+#define TEST_NONE				UINT32_MAX
+#define TEST_MODEL_PATH			"/../model/libstate_model.so"
+
+// Region states of state_machine.c
+#define TEST_MAINTENANCE_STATE	2
+#define TEST_DISPENSE_STATE		3
+#define TEST_COIN_STATE			2
+
+/*******************************************************************************
+ * STRUCTURE
+ ******************************************************************************/
+// Checker thread with its model copy
+typedef struct
+{
+	pthread_t thread;
+	const sSTATE_MODEL *psModel;
+	uint64_t transitionCount;
+}
+sTEST_WORKER;
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static const char *const eventName[totalModelEvent] =
+{
+	"coin", "coins", "button", "maintenance start", "maintenance end", "timer", "coroutine",
+};
+
+// Visited states by id, id order is breadth first order
+static sMODEL_STATE *state;
+static uint32_t (*successor)[totalModelEvent];
+static uint32_t *parent;
+static uint8_t *parentEvent;
+static uint32_t stateCount;
+// Hash chains of ids, a lock covers every TEST_LOCK-th bucket
+static uint32_t *bucket;
+static uint32_t *chain;
+static pthread_mutex_t bucketLock[TEST_LOCK];
+
+static sTEST_WORKER worker[TEST_MAXIMUM_THREAD];
+static uint32_t numOfWorker;
+static pthread_barrier_t levelBarrier;
+static uint32_t levelEnd;
+static uint32_t cursor;
+static bool done;
+static bool full;
+
+// First violation found
+static pthread_mutex_t violationLock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t violationCount;
+static uint32_t violationState;
+static uint8_t violationEvent;
+static sMODEL_OUTCOME sViolationOutcome;
+static sMODEL_STATE sViolationNext;
+
+/*******************************************************************************
+ * @fn      Hash
+ * @brief   FNV-1a of state bytes
+ ******************************************************************************/
+static uint32_t Hash(const sMODEL_STATE *psState)
+{
+	const uint8_t *data = (const uint8_t *)psState;
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	uint32_t i = 0;
+
+	for(i = 0; i < sizeof(sMODEL_STATE); i++)
+	{
+		hash = (hash ^ data[i]) * 0x100000001B3ULL;
+	}
+	return (uint32_t)(hash ^ (hash >> 32));
+}
+
+/*******************************************************************************
+ * @fn      Visit
+ * @brief   Id of state, new states are added with their parent
+ * @return  Id, TEST_NONE when the state table is full
+ ******************************************************************************/
+static uint32_t Visit(const sMODEL_STATE *psState, uint32_t from, uint8_t event)
+{
+	uint32_t index = Hash(psState) % TEST_BUCKET;
+	pthread_mutex_t *lock = &bucketLock[index % TEST_LOCK];
+	uint32_t id = 0;
+
+	pthread_mutex_lock(lock);
+	for(id = bucket[index]; id != TEST_NONE; id = chain[id])
+	{
+		if(memcmp(&state[id], psState, sizeof(sMODEL_STATE)) == 0)
+		{
+			pthread_mutex_unlock(lock);
+			return id;
+		}
+	}
+	id = __atomic_fetch_add(&stateCount, 1, __ATOMIC_RELAXED);
+	if(id >= TEST_MAXIMUM_STATE)
+	{
+		full = true;
+		pthread_mutex_unlock(lock);
+		return TEST_NONE;
+	}
+	state[id] = *psState;
+	parent[id] = from;
+	parentEvent[id] = event;
+	chain[id] = bucket[index];
+	bucket[index] = id;
+	pthread_mutex_unlock(lock);
+	return id;
+}
+
+/*******************************************************************************
+ * @fn      Credit
+ * @brief   Coins the customer still has
+ ******************************************************************************/
+static uint32_t Credit(const sMODEL_STATE *psState)
+{
+	return psState->totalCoin + psState->heldCoin;
+}
+
+/*******************************************************************************
+ * @fn      Violation
+ * @brief   Credit must change by accepted coins, less one used coin when the
+ *          coroutine dispensed a second. Inserted coins are all accepted
+ * @return  true	Credit wrapped, dropped or made up
+ ******************************************************************************/
+static bool Violation(const sMODEL_STATE *psState, uint8_t event, const sMODEL_STATE *psNext,
+		const sMODEL_OUTCOME *psOutcome)
+{
+	int64_t change = (int64_t)Credit(psNext) - Credit(psState) - psOutcome->acceptedCoin;
+
+	if(event == insertCoinModelEvent && psOutcome->acceptedCoin != 1)
+	{
+		return true;
+	}
+	if(event == insertCoinsModelEvent && psOutcome->acceptedCoin != UINT8_MAX)
+	{
+		return true;
+	}
+	if(event == coroutineModelEvent)
+	{
+		return change != 0 && !(change == -1 && Credit(psState) > 0);
+	}
+	return change != 0;
+}
+
+/*******************************************************************************
+ * @fn      Expand
+ * @brief   Successors of one state under every event
+ ******************************************************************************/
+static void Expand(sTEST_WORKER *psWorker, uint32_t id)
+{
+	sMODEL_STATE sNext;
+	sMODEL_OUTCOME sOutcome;
+	uint8_t event = 0;
+
+	for(event = 0; event < totalModelEvent; event++)
+	{
+		successor[id][event] = TEST_NONE;
+		// Inserts stop at the credit limit, the rest of the space is the same
+		if((event == insertCoinModelEvent && Credit(&state[id]) + 1 > TEST_CREDIT_LIMIT) ||
+		   (event == insertCoinsModelEvent && Credit(&state[id]) + UINT8_MAX > TEST_CREDIT_LIMIT))
+		{
+			continue;
+		}
+		if(!psWorker->psModel->Step(&state[id], event, &sNext, &sOutcome))
+		{
+			continue;
+		}
+		psWorker->transitionCount++;
+		if(Violation(&state[id], event, &sNext, &sOutcome))
+		{
+			pthread_mutex_lock(&violationLock);
+			if(violationCount++ == 0)
+			{
+				violationState = id;
+				violationEvent = event;
+				sViolationOutcome = sOutcome;
+				sViolationNext = sNext;
+			}
+			pthread_mutex_unlock(&violationLock);
+		}
+		successor[id][event] = Visit(&sNext, id, event);
+	}
+}
+
+/*******************************************************************************
+ * @fn      Worker
+ * @brief   Expand states of the current level in chunks, then wait for the
+ *          others. Last thread at the barrier opens the next level
+ ******************************************************************************/
+static void *Worker(void *arg)
+{
+	sTEST_WORKER *psWorker = arg;
+	uint32_t id = 0;
+	uint32_t end = 0;
+
+	for(;;)
+	{
+		while((id = __atomic_fetch_add(&cursor, TEST_CHUNK, __ATOMIC_RELAXED)) < levelEnd)
+		{
+			end = id + TEST_CHUNK < levelEnd ? id + TEST_CHUNK : levelEnd;
+			for(; id < end; id++)
+			{
+				Expand(psWorker, id);
+			}
+		}
+		if(pthread_barrier_wait(&levelBarrier) == PTHREAD_BARRIER_SERIAL_THREAD)
+		{
+			cursor = levelEnd;
+			levelEnd = full ? levelEnd : stateCount;
+			done = cursor == levelEnd;
+		}
+		// cursor moves again once the first thread is through
+		pthread_barrier_wait(&levelBarrier);
+		if(done)
+		{
+			return NULL;
+		}
+	}
+}
+
+/*******************************************************************************
+ * @fn      PrintState
+ * @brief   One line per state
+ ******************************************************************************/
+static void PrintState(const char *prefix, const sMODEL_STATE *psState)
+{
+	uint32_t countdown = 0;
+	uint8_t i = 0;
+
+	for(i = 0; i < NUM_OF_SOFTWARE_TIMER && countdown == 0; i++)
+	{
+		countdown = psState->countdown[i];
+	}
+	printf("%sregion %u/%u/%u status %u credit %u held %lu coroutine line %u signal 0x%lX timer %lu flags 0x%lX\n",
+			prefix, psState->regionState[maintenanceRegion], psState->regionState[dispenseRegion],
+			psState->regionState[coinRegion], psState->status, psState->totalCoin,
+			(unsigned long)psState->heldCoin, psState->resume, (unsigned long)psState->signal,
+			(unsigned long)countdown, (unsigned long)psState->eventFlags[0]);
+}
+
+/*******************************************************************************
+ * @fn      PrintTrace
+ * @brief   Events from start to a state
+ ******************************************************************************/
+static void PrintTrace(uint32_t id)
+{
+	if(id == 0)
+	{
+		PrintState("  start     ", &state[0]);
+		return;
+	}
+	PrintTrace(parent[id]);
+	printf("  %-10s", eventName[parentEvent[id]]);
+	PrintState(" ", &state[id]);
+}
+
+/*******************************************************************************
+ * @fn      Idle
+ * @brief   Credit used up, in service and not dispensing
+ ******************************************************************************/
+static bool Idle(const sMODEL_STATE *psState)
+{
+	return Credit(psState) == 0 && psState->regionState[maintenanceRegion] == 0 &&
+		   psState->regionState[dispenseRegion] == 0;
+}
+
+/*******************************************************************************
+ * @fn      Stuck
+ * @brief   Mark states that reach idle, backwards over the transitions
+ * @return  Number of states that never get back to idle
+ ******************************************************************************/
+static uint32_t Stuck(uint32_t *example)
+{
+	uint32_t *start = calloc(stateCount + 1, sizeof(uint32_t));
+	uint32_t *from = malloc((size_t)stateCount * totalModelEvent * sizeof(uint32_t));
+	uint32_t *queue = malloc(stateCount * sizeof(uint32_t));
+	bool *reach = calloc(stateCount, sizeof(bool));
+	uint32_t head = 0;
+	uint32_t tail = 0;
+	uint32_t count = 0;
+	uint32_t id = 0;
+	uint32_t to = 0;
+	uint8_t event = 0;
+
+	CHECK(start != NULL && from != NULL && queue != NULL && reach != NULL);
+	// Predecessor lists, counting sort by target
+	for(id = 0; id < stateCount; id++)
+	{
+		for(event = 0; event < totalModelEvent; event++)
+		{
+			if(successor[id][event] != TEST_NONE)
+			{
+				start[successor[id][event] + 1]++;
+			}
+		}
+	}
+	for(id = 0; id < stateCount; id++)
+	{
+		start[id + 1] += start[id];
+	}
+	for(id = 0; id < stateCount; id++)
+	{
+		for(event = 0; event < totalModelEvent; event++)
+		{
+			if((to = successor[id][event]) != TEST_NONE)
+			{
+				from[start[to]++] = id;
+			}
+		}
+	}
+	// start[to] now ends the list of to, start[to - 1] begins it
+	for(id = 0; id < stateCount; id++)
+	{
+		if(Idle(&state[id]))
+		{
+			reach[id] = true;
+			queue[tail++] = id;
+		}
+	}
+	while(head < tail)
+	{
+		to = queue[head++];
+		for(id = to > 0 ? start[to - 1] : 0; id < start[to]; id++)
+		{
+			if(!reach[from[id]])
+			{
+				reach[from[id]] = true;
+				queue[tail++] = from[id];
+			}
+		}
+	}
+	for(id = 0; id < stateCount; id++)
+	{
+		if(!reach[id] && count++ == 0)
+		{
+			*example = id;
+		}
+	}
+	free(start);
+	free(from);
+	free(queue);
+	free(reach);
+	return count;
+}
+
+/*******************************************************************************
+ * @fn      Deadlock
+ * @brief   States no event leaves
+ ******************************************************************************/
+static uint32_t Deadlock(uint32_t *example)
+{
+	uint32_t count = 0;
+	uint32_t id = 0;
+	uint8_t event = 0;
+
+	for(id = 0; id < stateCount; id++)
+	{
+		for(event = 0; event < totalModelEvent; event++)
+		{
+			if(successor[id][event] != TEST_NONE && successor[id][event] != id)
+			{
+				break;
+			}
+		}
+		if(event == totalModelEvent && count++ == 0)
+		{
+			*example = id;
+		}
+	}
+	return count;
+}
+
+/*******************************************************************************
+ * @fn      Load
+ * @brief   Model copy in its own namespace, globals are not shared
+ ******************************************************************************/
+static const sSTATE_MODEL *Load(void)
+{
+	char path[PATH_MAX];
+	ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - sizeof(TEST_MODEL_PATH));
+	void *handle = NULL;
+
+	CHECK(length > 0);
+	path[length] = '\0';
+	strcat(dirname(path), TEST_MODEL_PATH);
+	handle = dlmopen(LM_ID_NEWLM, path, RTLD_NOW | RTLD_LOCAL);
+	if(handle == NULL)
+	{
+		fprintf(stderr, "%s\n", dlerror());
+		exit(EXIT_FAILURE);
+	}
+	return dlsym(handle, STATE_MODEL_SYMBOL);
+}
+
+int main(int argc, char *argv[])
+{
+	sSTATE_MACHINE_COVERAGE sCoverage;
+	sSTATE_MACHINE_COVERAGE sTotal = {0};
+	sMODEL_STATE sStart;
+	bool regionSeen[TEST_MAINTENANCE_STATE][TEST_DISPENSE_STATE][TEST_COIN_STATE] = {0};
+	bool statusSeen[totalMachineStatus] = {0};
+	uint64_t transitionCount = 0;
+	uint64_t startTime = 0;
+	double second = 0;
+	uint32_t deadlockCount = 0;
+	uint32_t stuckCount = 0;
+	uint32_t example = 0;
+	uint32_t count = 0;
+	uint32_t id = 0;
+	uint32_t i = 0;
+	uint32_t j = 0;
+	uint32_t k = 0;
+
+	numOfWorker = argc > 1 ? (uint32_t)atoi(argv[1]) : TEST_THREAD;
+	CHECK(numOfWorker >= 1 && numOfWorker <= TEST_MAXIMUM_THREAD);
+	state = malloc((size_t)TEST_MAXIMUM_STATE * sizeof(sMODEL_STATE));
+	successor = malloc((size_t)TEST_MAXIMUM_STATE * sizeof(*successor));
+	parent = malloc((size_t)TEST_MAXIMUM_STATE * sizeof(uint32_t));
+	parentEvent = malloc(TEST_MAXIMUM_STATE);
+	chain = malloc((size_t)TEST_MAXIMUM_STATE * sizeof(uint32_t));
+	bucket = malloc((size_t)TEST_BUCKET * sizeof(uint32_t));
+	CHECK(state != NULL && successor != NULL && parent != NULL && parentEvent != NULL && chain != NULL && bucket != NULL);
+	memset(bucket, 0xFF, (size_t)TEST_BUCKET * sizeof(uint32_t));
+	for(i = 0; i < TEST_LOCK; i++)
+	{
+		pthread_mutex_init(&bucketLock[i], NULL);
+	}
+
+	// Every copy starts the same, the model is deterministic
+	for(i = 0; i < numOfWorker; i++)
+	{
+		CHECK((worker[i].psModel = Load()) != NULL);
+		worker[i].psModel->Initialize(&sStart);
+		if(i == 0)
+		{
+			CHECK(Visit(&sStart, TEST_NONE, 0) == 0);
+		}
+		CHECK(memcmp(&sStart, &state[0], sizeof(sMODEL_STATE)) == 0);
+	}
+
+	startTime = HostNanosecond();
+	levelEnd = stateCount;
+	pthread_barrier_init(&levelBarrier, NULL, numOfWorker);
+	for(i = 0; i < numOfWorker; i++)
+	{
+		CHECK(pthread_create(&worker[i].thread, NULL, Worker, &worker[i]) == 0);
+	}
+	for(i = 0; i < numOfWorker; i++)
+	{
+		pthread_join(worker[i].thread, NULL);
+		transitionCount += worker[i].transitionCount;
+	}
+	second = (HostNanosecond() - startTime) / 1e9;
+	CHECK(!full);
+
+	printf("%lu states, %llu transitions in %.3f s with %lu threads: %.0f states/s, %.0f transitions/s\n",
+			(unsigned long)stateCount, (unsigned long long)transitionCount, second, (unsigned long)numOfWorker,
+			stateCount / second, transitionCount / second);
+
+	// Reached region states and statuses, the rest is unreachable
+	for(id = 0; id < stateCount; id++)
+	{
+		regionSeen[state[id].regionState[maintenanceRegion]][state[id].regionState[dispenseRegion]]
+				  [state[id].regionState[coinRegion]] = true;
+		statusSeen[state[id].status] = true;
+	}
+	for(i = 0; i < TEST_MAINTENANCE_STATE; i++)
+	{
+		for(j = 0; j < TEST_DISPENSE_STATE; j++)
+		{
+			for(k = 0; k < TEST_COIN_STATE; k++)
+			{
+				if(!regionSeen[i][j][k])
+				{
+					printf("Unreachable region state maintenance %lu dispense %lu coin %lu\n",
+							(unsigned long)i, (unsigned long)j, (unsigned long)k);
+				}
+			}
+		}
+	}
+	for(i = 0; i < totalMachineStatus; i++)
+	{
+		if(!statusSeen[i])
+		{
+			printf("Unreachable status %lu\n", (unsigned long)i);
+		}
+	}
+
+	// Coverage of all model copies, status and event pairs never dispatched
+	for(i = 0; i < numOfWorker; i++)
+	{
+		worker[i].psModel->GetCoverage(&sCoverage);
+		for(j = 0; j < totalMachineStatus; j++)
+		{
+			for(k = 0; k < totalMachineEvent; k++)
+			{
+				sTotal.eventCount[j][k] += sCoverage.eventCount[j][k];
+			}
+		}
+	}
+	count = 0;
+	for(j = 0; j < totalMachineStatus; j++)
+	{
+		for(k = 0; k < totalMachineEvent; k++)
+		{
+			count += sTotal.eventCount[j][k] > 0;
+		}
+	}
+	printf("Dispatched %lu of %d status/event pairs, not:", (unsigned long)count, totalMachineStatus * totalMachineEvent);
+	for(j = 0; j < totalMachineStatus; j++)
+	{
+		for(k = 0; k < totalMachineEvent; k++)
+		{
+			if(sTotal.eventCount[j][k] == 0)
+			{
+				printf(" %lu/%lu", (unsigned long)j, (unsigned long)k);
+			}
+		}
+	}
+	printf("\n");
+
+	if(violationCount > 0)
+	{
+		printf("%lu credit overflows, first by %s, %lu coins accepted:\n", (unsigned long)violationCount,
+				eventName[violationEvent], (unsigned long)sViolationOutcome.acceptedCoin);
+		PrintTrace(violationState);
+		PrintState("  result     ", &sViolationNext);
+	}
+	if((deadlockCount = Deadlock(&example)) > 0)
+	{
+		printf("%lu deadlocks, first:\n", (unsigned long)deadlockCount);
+		PrintTrace(example);
+	}
+	if((stuckCount = Stuck(&example)) > 0)
+	{
+		printf("%lu states never get back to idle, first:\n", (unsigned long)stuckCount);
+		PrintTrace(example);
+	}
+	CHECK(violationCount == 0 && deadlockCount == 0 && stuckCount == 0);
+	printf("State space passed\n");
+	return EXIT_SUCCESS;
+}
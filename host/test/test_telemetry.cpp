@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * Filename:			test_telemetry.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Telemetry decoder against frames of firmware encoder
+ *						on console DMA, with console text in between. Then
+ *						decoder throughput, at least 10 MB/s
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "telemetry_decoder.h"
+#include "console.h"
+#include "log.h"
+#include "host_hal.h"
+#include "check.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+#define TEST_TRANSITION			1000
+#define TEST_SNAPSHOT_PERIOD	100
+#define BENCHMARK_SIZE			(64u << 20)
+#define BENCHMARK_CHUNK			4096
+#define BENCHMARK_MINIMUM		10.0
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static std::vector<uint8_t> stream;
+
+/*******************************************************************************
+ * @fn      Capture
+ * @brief   Console TX DMA bytes
+ ******************************************************************************/
+static void Capture(const uint8_t *data, uint32_t length)
+{
+	stream.insert(stream.end(), data, data + length);
+}
+
+/*******************************************************************************
+ * @fn      Drain
+ * @brief   Complete console TX DMA until ring is empty
+ ******************************************************************************/
+static void Drain(void)
+{
+	while(HostDmaComplete())
+	{
+	}
+}
+
+/*******************************************************************************
+ * @fn      Decode
+ * @brief   Decode stream in chunks, check every transition and snapshot
+ * @param   data
+ *          chunk		Bytes per Feed
+ * @return  Decoder statistic
+ ******************************************************************************/
+static telemetry::Statistic Decode(const std::vector<uint8_t> &data, size_t chunk, std::string *text)
+{
+	uint32_t transition = 0;
+	uint32_t snapshot[coverageTelemetryRecord + 1] = {0};
+	telemetry::Decoder decoder(
+		[&](const telemetry::Record &record)
+		{
+			if(record.type == transitionTelemetryRecord)
+			{
+				CHECK(record.transition.from == transition % totalMachineStatus);
+				CHECK(record.transition.to == (transition + 1) % totalMachineStatus);
+				CHECK(record.transition.event == transition % totalMachineEvent);
+				CHECK(record.transition.timestamp == transition);
+				transition++;
+			}
+			else
+			{
+				snapshot[record.type]++;
+			}
+		},
+		[&](const char *data, size_t length)
+		{
+			text->append(data, length);
+		});
+	size_t i = 0;
+
+	for(i = 0; i < data.size(); i += chunk)
+	{
+		decoder.Feed(data.data() + i, std::min(chunk, data.size() - i));
+	}
+	CHECK(snapshot[counterTelemetryRecord] == snapshot[timerTelemetryRecord]);
+	CHECK(snapshot[counterTelemetryRecord] == snapshot[coverageTelemetryRecord]);
+	return decoder.GetStatistic();
+}
+
+int main(void)
+{
+	telemetry::Statistic sStatistic;
+	std::vector<uint8_t> corrupt;
+	std::vector<uint8_t> benchmark;
+	std::string text;
+	uint64_t recordCount = 0;
+	uint64_t startTime = 0;
+	double rate = 0;
+	uint32_t i = 0;
+
+	hostDmaTransmitHook = Capture;
+	sConsole.Initialize();
+	sTelemetry.Stream(true);
+	for(i = 0; i < TEST_TRANSITION; i++)
+	{
+		hostTick = i;
+		if(i % TEST_SNAPSHOT_PERIOD == 0)
+		{
+			sLog.Printf("Text %lu\n", (unsigned long)i);
+			sTelemetry.Snapshot();
+		}
+		sTelemetry.Transition((eMACHINE_STATUS)(i % totalMachineStatus), (eMACHINE_STATUS)((i + 1) % totalMachineStatus),
+				(eMACHINE_EVENT)(i % totalMachineEvent));
+		Drain();
+	}
+
+	// Whole stream and byte by byte give the same result
+	sStatistic = Decode(stream, stream.size(), &text);
+	CHECK(sStatistic.recordCount == TEST_TRANSITION + 3 * TEST_TRANSITION / TEST_SNAPSHOT_PERIOD);
+	CHECK(sStatistic.frameError == 0);
+	CHECK(text.find("Console ready") == 0);
+	CHECK(text.find("Text 900\n") != std::string::npos);
+	text.clear();
+	sStatistic = Decode(stream, 1, &text);
+	CHECK(sStatistic.recordCount == TEST_TRANSITION + 3 * TEST_TRANSITION / TEST_SNAPSHOT_PERIOD);
+	CHECK(sStatistic.textCount == text.size());
+
+	// Damaged transition is dropped, decoder is in step again at next frame
+	corrupt = stream;
+	corrupt[corrupt.size() - 3] ^= 0x01;
+	text.clear();
+	sStatistic = Decode(corrupt, 64, &text);
+	CHECK(sStatistic.recordCount == TEST_TRANSITION - 1 + 3 * TEST_TRANSITION / TEST_SNAPSHOT_PERIOD);
+	CHECK(sStatistic.frameError == 1);
+
+	while(benchmark.size() < BENCHMARK_SIZE)
+	{
+		benchmark.insert(benchmark.end(), stream.begin(), stream.end());
+	}
+	telemetry::Decoder decoder([&](const telemetry::Record &record) { recordCount++; });
+	startTime = HostNanosecond();
+	for(i = 0; i < benchmark.size(); i += BENCHMARK_CHUNK)
+	{
+		decoder.Feed(benchmark.data() + i, std::min<size_t>(BENCHMARK_CHUNK, benchmark.size() - i));
+	}
+	rate = benchmark.size() / ((HostNanosecond() - startTime) / 1e3);
+	printf("Decoded %lu MB, %llu records, %.1f MB/s\n", (unsigned long)(benchmark.size() >> 20),
+			(unsigned long long)recordCount, rate);
+	CHECK(decoder.GetStatistic().frameError == 0);
+	CHECK(rate >= BENCHMARK_MINIMUM);
+	printf("Telemetry decoder passed\n");
+	return EXIT_SUCCESS;
+}
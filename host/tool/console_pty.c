@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * Filename:			console_pty.c
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Console and state machine on a pseudo-terminal, for a
+ *						terminal program or a script in place of the board.
+ *						HAL tick and software timers follow host time, flash
+ *						journal and flow page are simulated and start erased
+ *						e.g. console_pty, then screen /dev/pts/N
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "console.h"
+#include "event_flag.h"
+#include "flash_journal.h"
+#include "main_loop.h"
+#include "scheduler.h"
+#include "software_timer.h"
+#include "state_machine.h"
+#include "tim.h"
+#include "host_hal.h"
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+// Input wait, software timers lag host time by at most this
+#define CONSOLE_PTY_POLL		1
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+/*******************************************************************************
+ * @fn      FlashJournalTask
+ * @brief   Flash journal operation completes at once on simulated flash
+ ******************************************************************************/
+static void FlashJournalTask(void)
+{
+	sFlashJournal.Process();
+	HostFlashComplete();
+}
+
+/*******************************************************************************
+ * @fn      DispensingTimerTask
+ * @brief   Dispensing timer of flow program expired
+ ******************************************************************************/
+static void DispensingTimerTask(void)
+{
+	sStateMachine.DispensingTimeout();
+}
+
+int main(void)
+{
+	// Main loop tasks the console can reach, others register their own
+	static const sSCHEDULER_TASK sFlashJournalTask = {"flashJournal", FlashJournalTask, 5, 500};
+	static const sSCHEDULER_TASK sDispensingTimerTask = {"dispensingTimer", DispensingTimerTask, 20, 2000};
+	const char *path = NULL;
+	uint64_t startTime = 0;
+	uint64_t pendingFlags = 0;
+	uint32_t tick = 0;
+	uint8_t taskId = 0;
+
+	path = HostPtyOpen();
+	if(path == NULL)
+	{
+		perror("posix_openpt");
+		return EXIT_FAILURE;
+	}
+	printf("Console on %s\n", path);
+	fflush(stdout);
+
+	startTime = HostNanosecond();
+	sScheduler.Initialize();
+	sScheduler.Register(flashJournalEventFlag, &sFlashJournalTask);
+	sScheduler.Register(dispensingTimerEventFlag, &sDispensingTimerTask);
+	sConsole.Initialize();
+	MX_TIM6_Init();
+	sSoftwareTimer.Enable();
+	sStateMachine.Initialize();
+
+	for(;;)
+	{
+		// 1 ms timer interrupt for every ms of host time
+		tick = (uint32_t)((HostNanosecond() - startTime) / 1000000);
+		for(; hostTick != tick; hostTick++)
+		{
+			SoftwareTimerInterruptCallback();
+		}
+
+		pendingFlags = sEventFlag.FetchAndClearAll();
+		sScheduler.Release(0, (uint32_t)pendingFlags);
+		sScheduler.Release(1, (uint32_t)(pendingFlags >> 32));
+		taskId = sScheduler.Next();
+		if(taskId != SCHEDULER_NO_TASK)
+		{
+			sScheduler.Run(taskId);
+			HostPtyPoll(0);
+			continue;
+		}
+		HostPtyPoll(CONSOLE_PTY_POLL);
+	}
+}
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * Filename:			fault_symbolize.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Backtrace of the fault record in a console capture,
+ *						last record counts
+ *						e.g. fault_symbolize Debug/04_NUCLEO-L476RG_State_Machine.elf boot.log
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "fault_symbolizer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+int main(int argc, char *argv[])
+{
+	fault::Elf elf;
+	fault::Dump dump;
+	std::string text;
+	std::ifstream file;
+
+	if(argc < 2)
+	{
+		fprintf(stderr, "fault_symbolize <elf> [console capture]\n");
+		return EXIT_FAILURE;
+	}
+	if(!elf.Load(argv[1]))
+	{
+		fprintf(stderr, "%s\n", elf.GetError().c_str());
+		return EXIT_FAILURE;
+	}
+	if(argc > 2)
+	{
+		file.open(argv[2]);
+		if(!file)
+		{
+			perror(argv[2]);
+			return EXIT_FAILURE;
+		}
+	}
+	std::istream &input = argc > 2 ? file : std::cin;
+	text.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+
+	dump = fault::ParseDump(text);
+	if(!dump.valid)
+	{
+		fprintf(stderr, "No fault record, pc line missing\n");
+		return EXIT_FAILURE;
+	}
+	const auto frame = fault::Backtrace(elf, dump);
+	for(size_t i = 0; i < frame.size(); i++)
+	{
+		printf("#%-2zu 0x%08lX %-8s %s", i, (unsigned long)frame[i].address, frame[i].source.c_str(),
+				frame[i].function.empty() ? "??" : frame[i].function.c_str());
+		if(!frame[i].function.empty())
+		{
+			printf("+0x%lX", (unsigned long)frame[i].offset);
+		}
+		printf("\n");
+	}
+	fprintf(stderr, "%zu stack words from 0x%08lX\n", dump.stack.size(), (unsigned long)dump.stackAddress);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * Filename:			flow_compile.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Compile flow source to a program of the FLOW page,
+ *						.hex output is Intel HEX at the page, else binary
+ *						e.g. flow_compile flow/vending.flow vending.hex
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "flow_compiler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+int main(int argc, char *argv[])
+{
+	flow::Program program;
+	std::string source;
+	std::string error;
+	std::string output;
+	std::ifstream input;
+	std::ofstream file;
+
+	if(argc != 3)
+	{
+		fprintf(stderr, "flow_compile <source> <output .hex or .bin>\n");
+		return EXIT_FAILURE;
+	}
+	input.open(argv[1]);
+	if(!input)
+	{
+		perror(argv[1]);
+		return EXIT_FAILURE;
+	}
+	source.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	if(!flow::Compile(source, &program, &error))
+	{
+		fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+		return EXIT_FAILURE;
+	}
+
+	output = argv[2];
+	if(output.size() > 4 && output.compare(output.size() - 4, 4, ".hex") == 0)
+	{
+		const std::string text = flow::IntelHex(program.image, flow::programAddress);
+
+		file.open(output);
+		file << text;
+	}
+	else
+	{
+		file.open(output, std::ios::binary);
+		file.write(reinterpret_cast<const char *>(program.image.data()), program.image.size());
+	}
+	if(!file.flush())
+	{
+		perror(argv[2]);
+		return EXIT_FAILURE;
+	}
+	fprintf(stderr, "%zu code bytes, %zu image bytes at 0x%08lX, crc 0x%08lX\n", program.codeLength,
+			program.image.size(), (unsigned long)flow::programAddress, (unsigned long)program.crc);
+	return EXIT_SUCCESS;
+}
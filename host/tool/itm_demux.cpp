@@ -0,0 +1,195 @@
+/*******************************************************************************
+ * Filename:			itm_demux.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Split a captured SWO stream by ITM channel and decode
+ *						the trace words, one line per write or text line.
+ *						With an output prefix every channel goes to its own
+ *						file <prefix>.<channel>.txt, else all go to stdout
+ *						e.g. itm_demux swo.bin trace
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "itm_demux.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+static const char *const channelName[maximumItmChannel] =
+{
+	"log",
+	"transition",
+	"timer",
+	"profile",
+};
+
+/*******************************************************************************
+ * LOCAL VARIABLES
+ ******************************************************************************/
+static FILE *channelFile[itm::numOfPort];
+static std::string logLine;
+static itm::Profiler profiler;
+
+/*******************************************************************************
+ * @fn      Path
+ * @brief   Output file of port
+ ******************************************************************************/
+static std::string Path(const char *prefix, uint8_t port)
+{
+	return std::string(prefix) + "." + (port < maximumItmChannel ? channelName[port] : "port" + std::to_string(port)) +
+		   ".txt";
+}
+
+/*******************************************************************************
+ * @fn      Output
+ * @brief   File of port, stdout with channel name in front without prefix
+ ******************************************************************************/
+static FILE *Output(uint8_t port)
+{
+	if(channelFile[port] != stdout)
+	{
+		return channelFile[port];
+	}
+	if(port < maximumItmChannel)
+	{
+		printf("%-10s ", channelName[port]);
+	}
+	else
+	{
+		printf("port %-5u ", port);
+	}
+	return stdout;
+}
+
+/*******************************************************************************
+ * @fn      PrintPacket
+ * @brief   Text is printed per line, words per layout of their channel
+ ******************************************************************************/
+static void PrintPacket(const itm::Packet &packet)
+{
+	uint32_t cycle = 0;
+
+	switch(packet.port)
+	{
+		case logItmChannel:
+			for(uint8_t i = 0; i < packet.size; i++)
+			{
+				const char character = (char)(packet.value >> (8 * i));
+
+				if(character != '\n')
+				{
+					logLine += character;
+					continue;
+				}
+				fprintf(Output(packet.port), "%s\n", logLine.c_str());
+				logLine.clear();
+			}
+			break;
+		case transitionItmChannel:
+		{
+			const itm::Transition transition = itm::DecodeTransition(packet.value);
+
+			fprintf(Output(packet.port), "%u -> %u by event %u\n", transition.from, transition.to, transition.event);
+			break;
+		}
+		case timerItmChannel:
+		{
+			const itm::Timer timer = itm::DecodeTimer(packet.value);
+
+			fprintf(Output(packet.port), "timer %u at tick %lu\n", timer.id, (unsigned long)timer.tick);
+			break;
+		}
+		case profileItmChannel:
+		{
+			const itm::Profile profile = itm::DecodeProfile(packet.value);
+
+			if(profiler.Add(profile, &cycle))
+			{
+				fprintf(Output(packet.port), "task %u end at %lu, %lu cycles\n", profile.id,
+						(unsigned long)profile.cycle, (unsigned long)cycle);
+			}
+			else
+			{
+				fprintf(Output(packet.port), "task %u %s at %lu\n", profile.id, profile.end ? "end" : "start",
+						(unsigned long)profile.cycle);
+			}
+			break;
+		}
+		default:
+			fprintf(Output(packet.port), "0x%0*lX\n", 2 * packet.size, (unsigned long)packet.value);
+			break;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	itm::Demux demux(PrintPacket);
+	uint8_t buffer[4096];
+	FILE *input = NULL;
+	size_t length = 0;
+
+	if(argc < 2)
+	{
+		fprintf(stderr, "itm_demux <SWO capture, - for stdin> [output prefix]\n");
+		return EXIT_FAILURE;
+	}
+	input = std::string(argv[1]) == "-" ? stdin : fopen(argv[1], "rb");
+	if(input == NULL)
+	{
+		perror(argv[1]);
+		return EXIT_FAILURE;
+	}
+	for(uint8_t port = 0; port < itm::numOfPort; port++)
+	{
+		channelFile[port] = stdout;
+		if(argc < 3)
+		{
+			continue;
+		}
+		// Opened for every port, files of unused ports are removed at end
+		channelFile[port] = fopen(Path(argv[2], port).c_str(), "w");
+		if(channelFile[port] == NULL)
+		{
+			perror(Path(argv[2], port).c_str());
+			return EXIT_FAILURE;
+		}
+	}
+
+	while((length = fread(buffer, 1, sizeof(buffer), input)) > 0)
+	{
+		demux.Feed(buffer, length);
+	}
+	if(!logLine.empty())
+	{
+		fprintf(Output(logItmChannel), "%s\n", logLine.c_str());
+	}
+
+	const itm::Statistic &statistic = demux.GetStatistic();
+	for(uint8_t port = 0; port < itm::numOfPort; port++)
+	{
+		if(channelFile[port] != stdout)
+		{
+			fclose(channelFile[port]);
+		}
+		if(statistic.portPacket[port] == 0)
+		{
+			if(argc >= 3)
+			{
+				remove(Path(argv[2], port).c_str());
+			}
+			continue;
+		}
+		fprintf(stderr, "port %2u %-10s %8llu writes %10llu bytes\n", port, port < maximumItmChannel ? channelName[port] : "",
+				(unsigned long long)statistic.portPacket[port], (unsigned long long)statistic.portByte[port]);
+	}
+	fprintf(stderr, "%llu bytes, %llu sync, %llu overflow, %llu timestamp, %llu hardware, %llu error\n",
+			(unsigned long long)statistic.byteCount, (unsigned long long)statistic.syncCount,
+			(unsigned long long)statistic.overflowCount, (unsigned long long)statistic.timestampCount,
+			(unsigned long long)statistic.hardwareCount, (unsigned long long)statistic.errorCount);
+	return EXIT_SUCCESS;
+}
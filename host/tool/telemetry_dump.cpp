@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * Filename:			telemetry_dump.cpp
+ * Revised:				Date: 2026.10.19
+ * Revision:			V001
+ * Description:		    Print telemetry records of a console capture or a
+ *						serial port, one line per record, text passed on
+ *						e.g. telemetry_dump /dev/ttyACM0
+*******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "telemetry_decoder.h"
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+/*******************************************************************************
+ * @fn      PrintRecord
+ * @brief   One line per record
+ ******************************************************************************/
+static void PrintRecord(const telemetry::Record &record)
+{
+	uint32_t sum = 0;
+	uint8_t i = 0;
+
+	switch(record.type)
+	{
+		case transitionTelemetryRecord:
+			printf("[%lu] transition %u -> %u by event %u\n", (unsigned long)record.transition.timestamp,
+					record.transition.from, record.transition.to, record.transition.event);
+			break;
+		case counterTelemetryRecord:
+			printf("[%lu] counter status %u credit %u lifetime coin %lu vend %lu clock %u tx drop %lu\n",
+					(unsigned long)record.counter.timestamp, record.counter.status, record.counter.totalCoin,
+					(unsigned long)record.counter.lifetimeCoin, (unsigned long)record.counter.lifetimeVend,
+					record.counter.clockLevel, (unsigned long)record.counter.txDrop);
+			break;
+		case timerTelemetryRecord:
+			printf("[%lu] timer latency count %lu last %lu min %lu max %lu cycles\n",
+					(unsigned long)record.timer.timestamp, (unsigned long)record.timer.count,
+					(unsigned long)record.timer.last, (unsigned long)record.timer.minimum,
+					(unsigned long)record.timer.maximum);
+			break;
+		case coverageTelemetryRecord:
+			printf("[%lu] residency", (unsigned long)record.coverage.timestamp);
+			for(i = 0; i < totalMachineStatus; i++)
+			{
+				printf(" %lu", (unsigned long)record.coverage.residency[i]);
+				sum = 0;
+				for(uint8_t event = 0; event < totalMachineEvent; event++)
+				{
+					sum += record.coverage.eventCount[i][event];
+				}
+				printf("/%lu", (unsigned long)sum);
+			}
+			printf(" ms/events per status\n");
+			break;
+		default:
+			break;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *input = argc > 1 ? fopen(argv[1], "rb") : stdin;
+	uint8_t buffer[4096];
+	ssize_t length = 0;
+	telemetry::Decoder decoder(PrintRecord, [](const char *text, size_t length) { fwrite(text, 1, length, stdout); });
+
+	if(input == NULL)
+	{
+		perror(argv[1]);
+		return EXIT_FAILURE;
+	}
+	setvbuf(stdout, NULL, _IOLBF, 0);
+	// read returns what a serial port has, fread would wait for a full buffer
+	while((length = read(fileno(input), buffer, sizeof(buffer))) > 0)
+	{
+		decoder.Feed(buffer, length);
+	}
+	decoder.Flush();
+	fprintf(stderr, "%llu records, %llu bad frames, %llu text bytes\n",
+			(unsigned long long)decoder.GetStatistic().recordCount,
+			(unsigned long long)decoder.GetStatistic().frameError,
+			(unsigned long long)decoder.GetStatistic().textCount);
+	return EXIT_SUCCESS;
+}